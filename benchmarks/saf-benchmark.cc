@@ -0,0 +1,360 @@
+/**
+ * Copyright (c) 2015 Daniel Posch (Alpen-Adria Universität Klagenfurt)
+ *
+ * This file is part of the ndnSIM extension for Stochastic Adaptive Forwarding (SAF).
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// Microbenchmarks of the hot paths of SAFForwardingTable and SAFStatisticMeasure, built with
+//   ./waf configure --with-benchmarks && ./waf
+//   ./build/benchmarks/saf-benchmark --faces=2,4,8,16 --layers=1,3 --prefixes=1,100,10000 --output=results.csv
+// Every line of the output is one benchmark and configuration in csv format (ns per operation).
+
+#include "../extensions/replay/safreplay.h"
+#include "../extensions/fw/safforwardingtable.h"
+#include "../extensions/fw/mratio.h"
+#include "../extensions/fw/mdelay.h"
+#include "../extensions/fw/saflayerclassifier.h"
+#include "../extensions/utils/parameterconfiguration.h"
+
+#include <boost/chrono.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/algorithm/string.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifndef SAF_REVISION
+#define SAF_REVISION "unknown"
+#endif
+
+using namespace nfd;
+using namespace nfd::fw;
+
+/**
+ * @brief exposes the protected probing step of the table.
+ */
+class BenchmarkTable : public SAFForwardingTable
+{
+public:
+  BenchmarkTable(std::vector<int> faceIds, std::map<int, int> preferedFacesIds) : SAFForwardingTable(faceIds, preferedFacesIds) {}
+
+  void probe(std::vector<int> faces, int layer, boost::shared_ptr<SAFStatisticMeasure> smeasure){probeColumn(faces, layer, smeasure);}
+};
+
+/**
+ * @brief the tables, measures and pending interests of a configuration.
+ */
+struct Fixture
+{
+  std::vector<int> faceIds; /*including the dropping face*/
+  std::vector<shared_ptr<Face> > faces;
+  shared_ptr<Face> extraFace; /*added and removed again*/
+
+  std::vector<boost::shared_ptr<BenchmarkTable> > tables; /*by prefix*/
+  std::vector<boost::shared_ptr<SAFStatisticMeasure> > ratios; /*by prefix*/
+  std::vector<boost::shared_ptr<SAFStatisticMeasure> > delays; /*by prefix*/
+
+  std::vector<Interest> interests; /*by prefix and layer*/
+  std::vector<shared_ptr<pit::Entry> > pitEntries; /*by prefix, layer and face, forwarded on that face*/
+};
+
+double minTime = 0.2;
+FILE* output = stdout;
+
+double elapsed(const boost::chrono::steady_clock::time_point& begin)
+{
+  return boost::chrono::duration<double>(boost::chrono::steady_clock::now () - begin).count ();
+}
+
+void report(const std::string& name, int faces, int layers, int prefixes, uint64_t iterations, double seconds)
+{
+  fprintf(output, "%s,%s,%d,%d,%d,%lu,%.1f\n", SAF_REVISION, name.c_str (), faces, layers, prefixes,
+          (unsigned long) iterations, seconds * 1e9 / iterations);
+  fflush(output);
+}
+
+/**
+ * @brief runs an operation in batches until the batch takes at least minTime.
+ */
+template<typename Operation>
+void timeLoop(const std::string& name, int faces, int layers, int prefixes, Operation op)
+{
+  for(uint64_t n = 16; ; n *= 2)
+  {
+    boost::chrono::steady_clock::time_point begin = boost::chrono::steady_clock::now ();
+    for(uint64_t i = 0; i < n; i++)
+      op(i);
+    double seconds = elapsed(begin);
+
+    if(seconds >= minTime || n >= (1ull << 32))
+    {
+      report(name, faces, layers, prefixes, n, seconds);
+      return;
+    }
+  }
+}
+
+/**
+ * @brief times each operation on its own, for operations that need an (untimed) setup.
+ */
+template<typename Setup, typename Operation>
+void timeEach(const std::string& name, int faces, int layers, int prefixes, Setup setup, Operation op)
+{
+  double seconds = 0.0;
+  uint64_t i = 0;
+  for(; seconds < minTime || i < 16; i++)
+  {
+    setup(i);
+    boost::chrono::steady_clock::time_point begin = boost::chrono::steady_clock::now ();
+    op(i);
+    seconds += elapsed(begin);
+  }
+  report(name, faces, layers, prefixes, i, seconds);
+}
+
+void createFixture(Fixture& f, std::vector<shared_ptr<Face> >& allFaces, int faces, int layers, int prefixes)
+{
+  f.faceIds.push_back (DROP_FACE_ID);
+  std::map<int, int> costs;
+  for(int i = 0; i < faces; i++)
+  {
+    f.faces.push_back (allFaces[i]);
+    f.faceIds.push_back (allFaces[i]->getId ());
+    costs[allFaces[i]->getId ()] = i + 1;
+  }
+  f.extraFace = allFaces[faces];
+
+  for(int p = 0; p < prefixes; p++)
+  {
+    f.tables.push_back (boost::shared_ptr<BenchmarkTable>(new BenchmarkTable(f.faceIds, costs)));
+    f.ratios.push_back (boost::shared_ptr<SAFStatisticMeasure>(new Mratio(f.faceIds)));
+    f.delays.push_back (boost::shared_ptr<SAFStatisticMeasure>(new MDelay(f.faceIds, 1000)));
+
+    for(int l = 0; l < layers; l++)
+    {
+      Interest interest(Name("/bench/p" + boost::lexical_cast<std::string>(p) + "/layer" + boost::lexical_cast<std::string>(l))
+                        .appendSequenceNumber (0));
+      f.interests.push_back (interest);
+
+      for(int i = 0; i < faces; i++)
+      {
+        shared_ptr<pit::Entry> pitEntry = make_shared<pit::Entry>(interest);
+        pitEntry->insertOrUpdateOutRecord (f.faces[i], interest);
+        f.pitEntries.push_back (pitEntry);
+      }
+    }
+  }
+}
+
+//one period of traffic: the first face satisfies everything, the others fail more often the higher their index
+void logTraffic(Fixture& f, int p, int faces, int layers, boost::shared_ptr<SAFStatisticMeasure> measure)
+{
+  for(int l = 0; l < layers; l++)
+  {
+    for(int i = 0; i < faces; i++)
+    {
+      shared_ptr<pit::Entry> pitEntry = f.pitEntries[(p * layers + l) * faces + i];
+      Data data(pitEntry->getName ());
+      for(int k = 0; k < 20; k++)
+      {
+        if(k * faces < 20 * (faces - i))
+          measure->logSatisfiedInterest (pitEntry, *f.faces[i], data);
+        else
+          measure->logExpiredInterest (pitEntry);
+      }
+    }
+  }
+}
+
+void runBenchmarks(std::vector<shared_ptr<Face> >& allFaces, int faces, int layers, int prefixes)
+{
+  ParameterConfiguration::getInstance ()->setParameter ("MAX_LAYERS", layers);
+
+  Fixture f;
+  createFixture(f, allFaces, faces, layers, prefixes);
+  size_t requests = f.interests.size ();
+
+  //forwarding decisions, retransmissions exclude the faces tried before
+  int tried[] = {0, 1, 3};
+  for(int t = 0; t < 3; t++)
+  {
+    if(tried[t] >= faces)
+      continue;
+
+    std::vector<int> alreadyTried(f.faceIds.begin () + 1, f.faceIds.begin () + 1 + tried[t]);
+    timeLoop("determineNextHop_tried" + boost::lexical_cast<std::string>(tried[t]), faces, layers, prefixes, [&] (uint64_t i)
+    {
+      size_t r = i % requests;
+      f.tables[r / layers]->determineNextHop (f.interests[r], alreadyTried);
+    });
+  }
+
+  //period update of measure and table after a period of traffic
+  timeEach("update", faces, layers, prefixes, [&] (uint64_t i)
+  {
+    logTraffic(f, i % prefixes, faces, layers, f.ratios[i % prefixes]);
+  }, [&] (uint64_t i)
+  {
+    int p = i % prefixes;
+    f.ratios[p]->update (f.tables[p]->getCurrentReliability ());
+    f.tables[p]->update (f.ratios[p]);
+  });
+
+  //probing moves traffic from the dropping face, starting from a table that drops most of it
+  BenchmarkTable dropping(f.faceIds, std::map<int, int>());
+  boost::shared_ptr<SAFStatisticMeasure> failing(new Mratio(f.faceIds));
+  for(int l = 0; l < layers; l++)
+    for(int i = 0; i < faces; i++)
+      for(int k = 0; k < 20; k++)
+        failing->logExpiredInterest (f.pitEntries[l * faces + i]);
+  failing->update (dropping.getCurrentReliability ());
+  dropping.update (failing);
+
+  BenchmarkTable probing = dropping;
+  std::vector<int> probeFaces(f.faceIds.begin () + 1, f.faceIds.end ());
+  timeEach("probeColumn", faces, layers, prefixes, [&] (uint64_t i)
+  {
+    probing = dropping;
+  }, [&] (uint64_t i)
+  {
+    probing.probe (probeFaces, i % layers, failing);
+  });
+
+  //faces come and go
+  timeLoop("table_addRemoveFace", faces, layers, prefixes, [&] (uint64_t i)
+  {
+    f.tables[i % prefixes]->addFace (f.extraFace);
+    f.tables[i % prefixes]->removeFace (f.extraFace);
+  });
+
+  timeLoop("measure_addRemoveFace", faces, layers, prefixes, [&] (uint64_t i)
+  {
+    f.ratios[i % prefixes]->addFace (f.extraFace);
+    f.ratios[i % prefixes]->removeFace (f.extraFace);
+  });
+
+  //logging of the measures
+  size_t entries = f.pitEntries.size ();
+  std::vector<Data> data;
+  for(size_t e = 0; e < entries; e++)
+    data.push_back (Data(f.pitEntries[e]->getName ()));
+
+  timeLoop("Mratio_logSatisfiedInterest", faces, layers, prefixes, [&] (uint64_t i)
+  {
+    size_t e = i % entries;
+    f.ratios[e / (layers * faces)]->logSatisfiedInterest (f.pitEntries[e], *f.faces[e % faces], data[e]);
+  });
+
+  timeLoop("Mratio_logExpiredInterest", faces, layers, prefixes, [&] (uint64_t i)
+  {
+    size_t e = i % entries;
+    f.ratios[e / (layers * faces)]->logExpiredInterest (f.pitEntries[e]);
+  });
+
+  timeLoop("Mratio_logNack", faces, layers, prefixes, [&] (uint64_t i)
+  {
+    size_t e = i % entries;
+    f.ratios[e / (layers * faces)]->logNack (*f.faces[e % faces], f.pitEntries[e]->getInterest ());
+  });
+
+  timeLoop("MDelay_logSatisfiedInterest", faces, layers, prefixes, [&] (uint64_t i)
+  {
+    size_t e = i % entries;
+    f.delays[e / (layers * faces)]->logSatisfiedInterest (f.pitEntries[e], *f.faces[e % faces], data[e]);
+  });
+}
+
+std::vector<int> parseList(const std::string& value)
+{
+  std::vector<std::string> items;
+  boost::split(items, value, boost::is_any_of (","));
+
+  std::vector<int> values;
+  for(std::vector<std::string>::iterator it = items.begin (); it != items.end (); ++it)
+    values.push_back (boost::lexical_cast<int>(*it));
+  return values;
+}
+
+int main(int argc, char* argv[])
+{
+  std::vector<int> faceCounts = parseList("2,4,8,16");
+  std::vector<int> layerCounts = parseList("1,3");
+  std::vector<int> prefixCounts = parseList("1,100,10000");
+
+  try
+  {
+    for(int i = 1; i < argc; i++)
+    {
+      std::string arg = argv[i];
+      std::string value = arg.substr (arg.find ('=') + 1);
+      if(arg.find ("--faces=") == 0)
+        faceCounts = parseList(value);
+      else if(arg.find ("--layers=") == 0)
+        layerCounts = parseList(value);
+      else if(arg.find ("--prefixes=") == 0)
+        prefixCounts = parseList(value);
+      else if(arg.find ("--min-time=") == 0)
+        minTime = boost::lexical_cast<double>(value);
+      else if(arg.find ("--output=") == 0)
+      {
+        output = fopen(value.c_str (), "w");
+        if(output == NULL)
+        {
+          fprintf(stderr, "Could not write %s\n", value.c_str ());
+          return 1;
+        }
+      }
+      else
+      {
+        fprintf(stderr, "usage: saf-benchmark [--faces=2,4,8,16] [--layers=1,3] [--prefixes=1,100,10000] [--min-time=0.2] [--output=FILE]\n");
+        return 1;
+      }
+    }
+  }
+  catch(boost::bad_lexical_cast&)
+  {
+    fprintf(stderr, "Invalid number in %s\n", argv[0]);
+    return 1;
+  }
+
+  StandalonePlatform platform;
+  SAFPlatform::setInstance (&platform);
+
+  //names look like /bench/pX/layerY/seq
+  SAFLayerClassifier::getInstance ()->registerComponentRule ("/bench", 2, "layer");
+
+  //faces are never removed from the forwarder, so all configurations share them
+  int maxFaces = *std::max_element(faceCounts.begin (), faceCounts.end ());
+  Forwarder forwarder;
+  std::vector<shared_ptr<Face> > allFaces;
+  for(int i = 0; i <= maxFaces; i++)
+  {
+    shared_ptr<Face> face = make_shared<ReplayFace>("Face" + boost::lexical_cast<std::string>(i));
+    forwarder.addFace (face);
+    platform.setNetworkFace (face->getId (), "Face" + boost::lexical_cast<std::string>(i), 10000000);
+    allFaces.push_back (face);
+  }
+
+  fprintf(output, "revision,benchmark,faces,layers,prefixes,iterations,ns_per_op\n");
+  for(std::vector<int>::iterator fc = faceCounts.begin (); fc != faceCounts.end (); ++fc)
+    for(std::vector<int>::iterator lc = layerCounts.begin (); lc != layerCounts.end (); ++lc)
+      for(std::vector<int>::iterator pc = prefixCounts.begin (); pc != prefixCounts.end (); ++pc)
+        runBenchmarks(allFaces, *fc, *lc, *pc);
+
+  if(output != stdout)
+    fclose(output);
+  return 0;
+}
@@ -0,0 +1,38 @@
+#!/bin/sh
+# Scaling study of SAF and its competitors as the topology grows.
+# Generates a topology per size with topology-generator and runs compare-strategies for every strategy on it,
+# every run appends one line to the csv (the topology file name contains the number of routers).
+#
+# usage (from the SAF directory, after ./waf): benchmarks/scaling.sh [csv] [type] [sizes] [strategies]
+#   benchmarks/scaling.sh scaling.csv rocketfuel "50 100 200 500 1000 2000" "saf rfa ompif inrr"
+
+OUTPUT=${1:-scaling.csv}
+TYPE=${2:-rocketfuel}
+SIZES=${3:-"50 100 200 500 1000 2000"}
+STRATEGIES=${4:-"saf rfa ompif inrr"}
+DURATION=${DURATION:-60}
+CACHE=${CACHE:-100}
+WORKLOAD=${WORKLOAD:-zipf}
+
+GENERATOR=./build/tools/topology-generator
+if [ ! -x $GENERATOR ]; then
+  echo "$GENERATOR not found, build it with ./waf first" >&2
+  exit 1
+fi
+
+mkdir -p topologies/generated
+
+for SIZE in $SIZES; do
+  TOPOLOGY=topologies/generated/$TYPE-$SIZE.top
+  CONSUMERS=$(( SIZE / 10 > 2 ? SIZE / 10 : 2 ))
+  PROVIDERS=$(( SIZE / 100 > 2 ? SIZE / 100 : 2 ))
+
+  $GENERATOR --type=$TYPE --routers=$SIZE --consumers=$CONSUMERS --providers=$PROVIDERS \
+             --output=$TOPOLOGY || exit 1
+
+  for STRATEGY in $STRATEGIES; do
+    echo "$TYPE $SIZE $STRATEGY"
+    ./waf --run "compare-strategies --strategy=$STRATEGY --topology=$TOPOLOGY --workload=$WORKLOAD \
+                 --cacheSize=$CACHE --duration=$DURATION --output=$OUTPUT" || exit 1
+  done
+done
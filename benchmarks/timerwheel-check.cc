@@ -0,0 +1,166 @@
+/**
+ * Copyright (c) 2015 Daniel Posch (Alpen-Adria Universität Klagenfurt)
+ *
+ * This file is part of the ndnSIM extension for Stochastic Adaptive Forwarding (SAF).
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// Regression check of the TimerWheel as OMP-IF drives it (one tick event, scheduled in integer nanoseconds), built with
+//   ./waf configure --with-benchmarks && ./waf && ./build/benchmarks/timerwheel-check
+// or without ns-3 as
+//   g++ -o timerwheel-check benchmarks/timerwheel-check.cc extensions/utils/timerwheel.cc && ./timerwheel-check
+// Every timer has to fire exactly once, not before its expiry and at most one tick late, and every tick event has to
+// make progress (a tick event that fires nothing and reschedules itself at the same time would never end).
+// Returns 0 if all configurations pass.
+
+#include "../extensions/utils/timerwheel.h"
+
+#include <boost/bind.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+/**
+ * @brief a timer of the check with the times it was due and fired.
+ */
+struct CheckedTimer
+{
+  int64_t expiry; /*ns*/
+  int64_t fired; /*ns, -1 if not yet*/
+  int count;
+  bool canceled;
+  TimerWheel::TimerId id;
+};
+
+static int64_t now = 0; /*ns*/
+
+static void onFire(std::vector<CheckedTimer>* timers, size_t index)
+{
+  (*timers)[index].fired = now;
+  (*timers)[index].count++;
+}
+
+static double uniform()
+{
+  return rand() / (RAND_MAX + 1.0);
+}
+
+/**
+ * @brief runs one configuration, returns the number of violations.
+ */
+static int check(double resolution, unsigned int slots, unsigned int levels, size_t arrivals, double maxDelay)
+{
+  TimerWheel wheel(resolution, slots, levels);
+  std::vector<CheckedTimer> timers;
+  timers.reserve (arrivals);
+
+  //arrival times of interests, in ns and partly on tick boundaries
+  std::vector<int64_t> arrivalTimes;
+  int64_t t = 0;
+  for(size_t i = 0; i < arrivals; i++)
+  {
+    t += (int64_t) (uniform () * resolution * 3e9);
+    if(uniform () < 0.2)
+      t = wheel.tickTime ((uint64_t) (t / (resolution * 1e9)) + 1);
+    arrivalTimes.push_back (t);
+  }
+
+  bool tickPending = false;
+  int64_t tickAt = 0;
+  uint64_t tickTarget = 0;
+  size_t ticks = 0;
+  int violations = 0;
+  now = 0;
+
+  size_t next = 0;
+  while(next < arrivalTimes.size () || tickPending)
+  {
+    if(next < arrivalTimes.size () && (!tickPending || arrivalTimes[next] < tickAt))
+    {
+      now = arrivalTimes[next++];
+
+      double delay = uniform () * maxDelay;
+      if(uniform () < 0.1)
+        delay = wheel.tickTime ((uint64_t) (uniform () * maxDelay / resolution)) / 1e9; // exactly a number of ticks
+
+      CheckedTimer timer;
+      timer.expiry = now + (int64_t) (delay * 1e9);
+      timer.fired = -1;
+      timer.count = 0;
+      timer.canceled = false;
+      timers.push_back (timer);
+      timers.back ().id = wheel.schedule (now / 1e9, delay, boost::bind(&onFire, &timers, timers.size () - 1));
+
+      if(uniform () < 0.3) // cancel a random pending timer, like a satisfied interest
+      {
+        CheckedTimer& victim = timers[(size_t) (uniform () * timers.size ())];
+        if(victim.count == 0)
+        {
+          wheel.cancel (victim.id);
+          victim.canceled = true;
+        }
+      }
+    }
+    else
+    {
+      now = tickAt;
+      tickPending = false;
+      ticks++;
+      size_t pending = wheel.size ();
+      uint64_t before = wheel.nextTick ();
+      wheel.advanceTo (tickTarget);
+      if(wheel.size () == pending && wheel.nextTick () == before)
+      {
+        fprintf(stderr, "Tick event at %lld ns made no progress (resolution %g)\n", (long long) now, resolution);
+        return violations + 1;
+      }
+    }
+
+    //reschedule the tick event as OMPIF::scheduleTick does
+    if(!wheel.empty () && !tickPending)
+    {
+      tickTarget = wheel.nextTick ();
+      tickAt = now + std::max((int64_t) 0, wheel.tickTime (tickTarget) - now);
+      tickPending = true;
+    }
+  }
+
+  int64_t tick = (int64_t) (resolution * 1e9);
+  for(size_t i = 0; i < timers.size (); i++)
+  {
+    const CheckedTimer& timer = timers[i];
+    bool ok = timer.canceled ? timer.count == 0
+                             : timer.count == 1 && timer.fired >= timer.expiry - 1000 && timer.fired <= timer.expiry + tick + 1000;
+    if(!ok && violations++ < 10)
+      fprintf(stderr, "Timer %lu (resolution %g): expiry %lld ns, fired %d times, last at %lld ns%s\n", (unsigned long) i,
+              resolution, (long long) timer.expiry, timer.count, (long long) timer.fired, timer.canceled ? ", canceled" : "");
+  }
+
+  printf("resolution=%g slots=%u levels=%u timers=%lu ticks=%lu violations=%d\n", resolution, slots, levels,
+         (unsigned long) timers.size (), (unsigned long) ticks, violations);
+  return violations;
+}
+
+int main(int argc, char** argv)
+{
+  srand(argc > 1 ? atoi(argv[1]) : 1);
+
+  int violations = 0;
+  violations += check(0.01, 256, 3, 100000, 2.0); // the OMP-IF default
+  violations += check(0.001, 256, 3, 100000, 2.0);
+  violations += check(0.003, 16, 2, 100000, 5.0); // time outs beyond the last level
+  violations += check(0.1, 4, 1, 20000, 10.0);
+
+  return violations == 0 ? 0 : 1;
+}
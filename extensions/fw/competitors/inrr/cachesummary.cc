@@ -0,0 +1,87 @@
+#include "cachesummary.h"
+#include <algorithm>
+
+using namespace nfd;
+using namespace nfd::fw;
+
+CacheSummary::CacheSummary(unsigned int size, unsigned int hashes)
+{
+  //double hashing with an odd step only reaches all positions if the number of counters is a power of two
+  unsigned int rounded = 1;
+  while(rounded < size && rounded < (1u << 31))
+    rounded <<= 1;
+
+  counters = std::vector<uint8_t>(rounded, 0);
+  this->hashes = std::max(1u, hashes);
+}
+
+void CacheSummary::insert(const Name& name)
+{
+  uint32_t h1, h2;
+  hash(name, h1, h2);
+  for(unsigned int i = 0; i < hashes; i++)
+  {
+    uint8_t& counter = counters[(h1 + i * h2) % counters.size ()];
+    if(counter < 255)
+      counter++;
+  }
+}
+
+void CacheSummary::remove(const Name& name)
+{
+  uint32_t h1, h2;
+  hash(name, h1, h2);
+  for(unsigned int i = 0; i < hashes; i++)
+  {
+    uint8_t& counter = counters[(h1 + i * h2) % counters.size ()];
+    if(counter > 0 && counter < 255)
+      counter--;
+  }
+}
+
+bool CacheSummary::contains(const Name& name) const
+{
+  uint32_t h1, h2;
+  hash(name, h1, h2);
+  for(unsigned int i = 0; i < hashes; i++)
+  {
+    if(counters[(h1 + i * h2) % counters.size ()] == 0)
+      return false;
+  }
+  return true;
+}
+
+std::vector<bool> CacheSummary::getBits() const
+{
+  std::vector<bool> bits(counters.size (), false);
+  for(size_t i = 0; i < counters.size (); i++)
+    bits[i] = counters[i] > 0;
+  return bits;
+}
+
+bool CacheSummary::contains(const std::vector<bool>& bits, unsigned int hashes, uint32_t h1, uint32_t h2)
+{
+  if(bits.empty ())
+    return false;
+
+  for(unsigned int i = 0; i < hashes; i++)
+  {
+    if(!bits[(h1 + i * h2) % bits.size ()])
+      return false;
+  }
+  return true;
+}
+
+void CacheSummary::hash(const Name& name, uint32_t& h1, uint32_t& h2)
+{
+  // 64bit FNV-1a over the wire encoding, the halves are used for double hashing
+  const Block& block = name.wireEncode ();
+  uint64_t h = 14695981039346656037ULL;
+  for(Block::const_iterator it = block.begin (); it != block.end (); ++it)
+  {
+    h ^= *it;
+    h *= 1099511628211ULL;
+  }
+  h1 = (uint32_t) h;
+  h2 = (uint32_t) (h >> 32) | 1; // odd, so all positions of the power of two sized filter are reached
+}
@@ -0,0 +1,72 @@
+/**
+ * Copyright (c) 2015 Daniel Posch (Alpen-Adria Universität Klagenfurt)
+ *
+ * This file is part of the ndnSIM extension for Stochastic Adaptive Forwarding (SAF).
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef CACHESUMMARY_H
+#define CACHESUMMARY_H
+
+#include "fw/strategy.hpp"
+#include <vector>
+
+namespace nfd
+{
+namespace fw
+{
+
+/**
+ * @brief The CacheSummary class is a counting Bloom filter over the names in the content store of a node.
+ * Counters allow to remove evicted names, the summary exchanged with other nodes only keeps one bit per counter.
+ */
+class CacheSummary
+{
+public:
+
+  /**
+   * @brief creates an empty summary.
+   * @param size the number of counters, rounded up to a power of two
+   * @param hashes the number of hash functions
+   */
+  CacheSummary(unsigned int size, unsigned int hashes);
+
+  void insert(const Name& name);
+  void remove(const Name& name);
+  bool contains(const Name& name) const;
+
+  /**
+   * @brief the compact summary that is exchanged, a bit is set if its counter is > 0.
+   */
+  std::vector<bool> getBits() const;
+
+  /**
+   * @brief checks a name against an exchanged summary with the same number of hash functions.
+   * @param h1 first hash of the name, see hash()
+   * @param h2 second hash of the name, see hash()
+   */
+  static bool contains(const std::vector<bool>& bits, unsigned int hashes, uint32_t h1, uint32_t h2);
+
+  /**
+   * @brief the two hashes of a name used for double hashing.
+   */
+  static void hash(const Name& name, uint32_t& h1, uint32_t& h2);
+
+protected:
+  std::vector<uint8_t> counters; /*saturate at 255, a saturated counter is never decremented*/
+  unsigned int hashes;
+};
+
+}
+}
+#endif // CACHESUMMARY_H
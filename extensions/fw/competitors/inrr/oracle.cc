@@ -9,29 +9,33 @@ Oracle::Oracle(Forwarder &forwarder, const Name &name) : Strategy(forwarder, nam
 {
   this->forwarder = &forwarder;
 
-  //find the node we run on
-  int counter = 0;
-  ns3::Ptr<ns3::Node> tmp = StaticOracaleContainer::getInstance ()->getNode("StrategyNode"+boost::lexical_cast<std::string>(counter++));
-
-  while(tmp != nullptr)
+  //the node we run on, announced by OracleHelper
+  node = StaticOracaleContainer::getInstance ()->getInstallingNode ();
+  if(node == nullptr)
   {
-    node = tmp;
-    tmp = StaticOracaleContainer::getInstance ()->getNode("StrategyNode"+boost::lexical_cast<std::string>(counter++));
+    fprintf(stderr, "Oracle strategies have to be installed with OracleHelper!\n");
+    abort();
   }
 
   //register forwarder for node id;
-  StaticOracaleContainer::getInstance ()->insertForwarder(node->GetId (),&forwarder);
+  StaticOracaleContainer::getInstance ()->registerOracle(node, &forwarder);
+
+  //announce everything we cache in the replica directory
+  csInsertConnection = forwarder.afterCsInsert.connect (boost::bind(&Oracle::afterCsInsert, this, _1));
 }
 
 Oracle::~Oracle()
 {
+  csInsertConnection.disconnect ();
 }
 
-void Oracle::afterReceiveInterest(const Face& inFace, const Interest& interest ,shared_ptr<fib::Entry> fibEntry, shared_ptr<pit::Entry> pitEntry)
+void Oracle::afterCsInsert(const Data& data)
 {
+  StaticOracaleContainer::getInstance ()->insertReplica(node->GetId (), data);
+}
 
-  /* Attention!!! interest != pitEntry->interest*/ // necessary to emulate NACKs in ndnSIM2.0
-  /* interst could be /NACK/suffix, while pitEntry->getInterest is /suffix */
+void Oracle::afterReceiveInterest(const Face& inFace, const Interest& interest ,shared_ptr<fib::Entry> fibEntry, shared_ptr<pit::Entry> pitEntry)
+{
 
   if(!fibEntry->hasNextHops())
     return;
@@ -51,17 +55,14 @@ void Oracle::afterReceiveInterest(const Face& inFace, const Interest& interest ,
   }
 
   //find the shortest path towards a cache that is shorter than the path to content source
-  std::vector<ns3::Ptr<ns3::Node> > visitedNodes;
+  std::vector<int> downstreamNodes;
   std::vector<ns3::ndn::NetDeviceFace* > inFaces = getAllInNetDeviceFaces (pitEntry);
   for(unsigned int i = 0; i < inFaces.size (); i++)
-    visitedNodes.push_back (getCounterpart (inFaces.at (i), node));
+    downstreamNodes.push_back (getCounterpart (inFaces.at (i), node)->GetId ());
 
-  std::vector<ns3::Ptr<ns3::Node> > relevantNodes;
-  relevantNodes.push_back (this->node);
+  int nr = findNearestReplica (downstreamNodes, pitEntry, smallestHopCost);
 
-  ns3::Ptr<ns3::Node> nr = findNearestReplica (visitedNodes, relevantNodes, pitEntry, smallestHopCost-1);
-
-  if(nr == nullptr) // if we can not find a nearest replica
+  if(nr == -1) // if we can not find a nearest replica
   {
     //just forward to the next hop indicated by the fib
     sendInterest(pitEntry, nextHops.at (indexShortestHop).getFace());
@@ -69,60 +70,86 @@ void Oracle::afterReceiveInterest(const Face& inFace, const Interest& interest ,
   }
 
   //else find the correct outgoing face for the node...
-  shared_ptr<fib::Entry> fe = forwarder->getFib ().findLongestPrefixMatch ("/Node_"+boost::lexical_cast<std::string>(nr->GetId ()));
+  shared_ptr<Face> face = getFaceTowards (nr);
+  if(face == nullptr)
+  {
+    sendInterest(pitEntry, nextHops.at (indexShortestHop).getFace());
+    return;
+  }
 
-  nextHops = fe->getNextHops();
-  indexShortestHop = 0;
-  smallestHopCost = INT_MAX;
-  for(unsigned int i = 0; i < nextHops.size (); i++)
+  sendInterest(pitEntry, face);
+}
+
+shared_ptr<Face> Oracle::getFaceTowards(int node_id)
+{
+  uint16_t device = StaticOracaleContainer::getInstance ()->getNextHopDevice (node->GetId (), node_id);
+  if(device == StaticOracaleContainer::NO_NEXT_HOP)
+    return shared_ptr<Face>();
+
+  //faces by device index, the net device faces are created before the first interest arrives
+  if(deviceFaces.empty ())
   {
-    if( ((int) nextHops.at (i).getCost()) < smallestHopCost)
+    deviceFaces.resize (node->GetNDevices ());
+    for(nfd::FaceTable::const_iterator it = getFaceTable ().begin (); it != getFaceTable ().end (); ++it)
     {
-      indexShortestHop = i;
-      smallestHopCost = ((int) nextHops.at (i).getCost());
+      if(ns3::ndn::NetDeviceFace* netf = dynamic_cast<ns3::ndn::NetDeviceFace*>(&(*(*it))))
+      {
+        uint32_t index = netf->GetNetDevice ()->GetIfIndex ();
+        if(index < deviceFaces.size ())
+          deviceFaces[index] = *it;
+      }
     }
   }
 
-  sendInterest(pitEntry, nextHops.at (indexShortestHop).getFace());
+  return device < deviceFaces.size () ? deviceFaces[device] : shared_ptr<Face>();
 }
 
-ns3::Ptr<ns3::Node> Oracle::findNearestReplica(std::vector<ns3::Ptr<ns3::Node> > visitedNodes,
-                                std::vector<ns3::Ptr<ns3::Node> > relevantNodes, shared_ptr<pit::Entry> pitEntry, int remainingSteps)
+int Oracle::findNearestReplica(const std::vector<int>& downstreamNodes, shared_ptr<pit::Entry> pitEntry, int maxDistance)
 {
-  //add nodes that will be investigated to already visited nodes
-  visitedNodes.insert(visitedNodes.end (), relevantNodes.begin (), relevantNodes.end ());
-  std::vector<ns3::Ptr<ns3::Node> > newRelevantNodes; // new relevent hops for iteration i+1
-  std::vector<ns3::Ptr<ns3::Node> > cacheHits; // nodes with a chache hit
+  StaticOracaleContainer* container = StaticOracaleContainer::getInstance ();
+  const int self = node->GetId ();
 
-  for(unsigned int i = 0; i < relevantNodes.size (); i++) //check all relevant nodes
+  //copy the holders, validating them may remove stale ones from the directory
+  std::vector<int> holders = container->getReplicas (pitEntry->getName ());
+
+  std::multimap<uint16_t /*distance*/, int /*node id*/> candidates;
+  for(std::vector<int>::iterator it = holders.begin (); it != holders.end (); ++it)
   {
-    std::vector<ns3::Ptr<ns3::NetDevice> > devices = getAllNetDevicesFromNode(relevantNodes.at (i));
+    uint16_t distance = container->getDistance (self, *it);
 
-    for(unsigned int k = 0; k < devices.size (); k++) // get all devices
-    {
-      ns3::Ptr<ns3::Node> counterPart = getCounterpart (devices.at (k), relevantNodes.at (i)); // get the counterpart node
-      //check if counterPart has been visited
+    if(*it == self || distance == StaticOracaleContainer::UNREACHABLE || distance > maxDistance)
+      continue;
 
-      if(std::find(visitedNodes.begin (), visitedNodes.end (), counterPart) == visitedNodes.end ()) // check if already visited
-      {
-        //if not was node visited check cache
-        if(checkCacheHit(pitEntry,counterPart)) //check if node can satisfy interet...
-          cacheHits.push_back (counterPart); //hit
-        else //object not present save node for next iteration
-        {
-          if(std::find(newRelevantNodes.begin (), newRelevantNodes.end (), counterPart) == newRelevantNodes.end ())
-            newRelevantNodes.push_back (counterPart);
-        }
-      }
-    }
+    if(!leadsOverDownstream(*it, distance, downstreamNodes))
+      candidates.insert (std::make_pair(distance, *it));
+  }
+
+  std::vector<int> cacheHits; // nodes with a cache hit at the smallest distance
+  for(std::multimap<uint16_t, int>::iterator it = candidates.begin (); it != candidates.end (); ++it)
+  {
+    if(!cacheHits.empty () && container->getDistance (self, cacheHits.front ()) < it->first)
+      break;
+
+    if(checkCacheHit(pitEntry, it->second))
+      cacheHits.push_back (it->second);
+    else
+      container->removeReplica (it->second, pitEntry->getName ()); //evicted in the meantime
   }
 
   if(cacheHits.size () > 0) // we found at least one nearest replica
     return cacheHits.at (randomVariable.GetInteger (0, cacheHits.size()-1)); //return a random nr
-  else if(remainingSteps > 0) // if we have steps left go to iteration i+1
-    return findNearestReplica(visitedNodes, newRelevantNodes, pitEntry, remainingSteps-1);
 
-  return nullptr; //no steps left, no nearst replica return nullptr.
+  return -1; //no nearst replica within reach
+}
+
+bool Oracle::leadsOverDownstream(int node_id, uint16_t distance, const std::vector<int>& downstreamNodes)
+{
+  for(std::vector<int>::const_iterator d = downstreamNodes.begin (); d != downstreamNodes.end (); ++d)
+  {
+    if(*d == node_id || StaticOracaleContainer::getInstance ()->getDistance (*d, node_id) + 1 <= distance)
+      return true;
+  }
+  return false;
 }
 
 void Oracle::beforeSatisfyInterest(shared_ptr<pit::Entry> pitEntry,const Face& inFace, const Data& data)
@@ -148,25 +175,6 @@ std::vector<ns3::ndn::NetDeviceFace* > Oracle::getAllInNetDeviceFaces(shared_ptr
   return faces;
 }
 
-std::vector<ns3::Ptr<ns3::NetDevice> > Oracle::getAllNetDevicesFromNode(ns3::Ptr<ns3::Node> node)
-{
-  std::vector<ns3::Ptr<ns3::NetDevice> > devs;
-
-  for(unsigned int i = 0; i < node->GetNDevices (); i++)
-      devs.push_back (node->GetDevice (i));
-
-  return devs;
-}
-
-ns3::Ptr<ns3::Node> Oracle::getCounterpart(ns3::Ptr<ns3::NetDevice> face, ns3::Ptr<ns3::Node> node)
-{
-  //we assume strict point to point communication here
-  if(face->GetChannel()->GetDevice(0)->GetNode ()->GetId () != node->GetId ())
-    return face->GetChannel()->GetDevice(0)->GetNode ();
-  else
-    return face->GetChannel()->GetDevice(1)->GetNode ();
-}
-
 ns3::Ptr<ns3::Node> Oracle::getCounterpart(ns3::ndn::NetDeviceFace* face, ns3::Ptr<ns3::Node> node)
 {
   //we assume strict point to point communication here
@@ -176,27 +184,26 @@ ns3::Ptr<ns3::Node> Oracle::getCounterpart(ns3::ndn::NetDeviceFace* face, ns3::P
     return face->GetNetDevice ()->GetChannel()->GetDevice(1)->GetNode ();
 }
 
-bool Oracle::checkCacheHit(shared_ptr<pit::Entry> pitEntry, ns3::Ptr<ns3::Node> node)
+bool Oracle::checkCacheHit(shared_ptr<pit::Entry> pitEntry, int node_id)
 {
 
-  Interest interest = pitEntry->getInterest ();
-  Forwarder* fw = StaticOracaleContainer::getInstance ()->getForwarder(node->GetId ());
+  const StaticOracaleContainer::OracleNode* n = StaticOracaleContainer::getInstance ()->getOracleNode(node_id);
 
-  if(fw == nullptr) // node has not registerd himself, e.g., a node that does not run the oracle strategy...
+  if(n == nullptr) // node has not registerd himself, e.g., a node that does not run the oracle strategy...
     return false;
 
-  ns3::Ptr<ns3::ndn::ContentStore> csFromNdnSim = fw->getCsFromNdnSim ();
+  const Interest& interest = pitEntry->getInterest ();
 
-  if (csFromNdnSim == nullptr)
+  if (n->csFromNdnSim == nullptr)
   {
-   const Data* csMatch = fw->getCs ().find(interest);
+   const Data* csMatch = n->cs->find(interest);
 
    if (csMatch != 0)
      return true;
   }
   else
   {
-   shared_ptr<Data> csMatch = csFromNdnSim->Lookup(make_shared<Interest>(interest), false);
+   shared_ptr<Data> csMatch = n->csFromNdnSim->Lookup(make_shared<Interest>(interest), false);
    if(csMatch != nullptr)
      return true;
   }
@@ -23,7 +23,9 @@
 #include "oraclecontainer.h"
 
 #include "boost/shared_ptr.hpp"
+#include "boost/bind.hpp"
 #include "map"
+#include "cstdlib"
 #include "ns3/node.h"
 #include "ns3/names.h"
 #include "limits.h"
@@ -57,19 +59,39 @@ protected:
 
   std::vector<ns3::ndn::NetDeviceFace *> getAllInNetDeviceFaces(shared_ptr<pit::Entry> pitEntry);
 
-  std::vector<ns3::Ptr<ns3::NetDevice> > getAllNetDevicesFromNode(ns3::Ptr<ns3::Node> node);
-
-  ns3::Ptr<ns3::Node> findNearestReplica(std::vector<ns3::Ptr<ns3::Node> > visitedNodes, std::vector<ns3::Ptr<ns3::Node> > relevantNodes, shared_ptr<pit::Entry> pitEntry, int remainingSteps);
-  ns3::Ptr<ns3::Node> getCounterpart(ns3::Ptr<ns3::NetDevice> face, ns3::Ptr<ns3::Node> node);
+  /**
+   * @brief looks up the nearest node caching the requested data in the replica directory.
+   * @param downstreamNodes nodes the interest came from, replicas reached over them are not considered
+   * @param maxDistance only replicas within this many hops are considered
+   * @return the node id of the nearest replica (random among equally near ones), -1 if there is none
+   */
+  virtual int findNearestReplica(const std::vector<int>& downstreamNodes, shared_ptr<pit::Entry> pitEntry, int maxDistance);
+
+  /**
+   * @brief checks if the shortest path to a node leads back over a node the interest came from.
+   * @param distance the hop distance to the node
+   */
+  bool leadsOverDownstream(int node_id, uint16_t distance, const std::vector<int>& downstreamNodes);
   ns3::Ptr<ns3::Node> getCounterpart(ns3::ndn::NetDeviceFace* face, ns3::Ptr<ns3::Node> node);
 
-  bool checkCacheHit(shared_ptr<pit::Entry> pitEntry, ns3::Ptr<ns3::Node> node);
+  bool checkCacheHit(shared_ptr<pit::Entry> pitEntry, int node_id);
+
+  /**
+   * @brief the face on a shortest path towards the given node, nullptr if it is not reachable.
+   */
+  shared_ptr<Face> getFaceTowards(int node_id);
+
+  virtual void afterCsInsert(const ndn::Data& data);
 
   ns3::UniformVariable randomVariable;
 
   ns3::Ptr<ns3::Node> node;
 
   Forwarder* forwarder;
+
+  std::vector<shared_ptr<Face> > deviceFaces; /*indexed by the device index of the node*/
+
+  signal::Connection csInsertConnection;
 };
 
 }
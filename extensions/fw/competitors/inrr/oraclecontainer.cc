@@ -1,13 +1,25 @@
 #include "oraclecontainer.h"
 
+#include "ns3/node-list.h"
+#include "ns3/channel.h"
+#include "ns3/net-device.h"
+#include "ns3/simulator.h"
+#include "../../../utils/parameterconfiguration.h"
+
+#include <algorithm>
+#include <deque>
+
 using namespace nfd;
 using namespace nfd::fw;
 
 StaticOracaleContainer* StaticOracaleContainer::instance = NULL;
+const uint16_t StaticOracaleContainer::UNREACHABLE;
+const uint16_t StaticOracaleContainer::NO_NEXT_HOP;
 
 StaticOracaleContainer::StaticOracaleContainer()
 {
-
+  summaryLookups = 0;
+  summaryFalsePositives = 0;
 }
 
 StaticOracaleContainer *StaticOracaleContainer::getInstance()
@@ -18,34 +30,260 @@ StaticOracaleContainer *StaticOracaleContainer::getInstance()
   return instance;
 }
 
-void StaticOracaleContainer::insertNode(const std::string& name, ns3::Ptr<ns3::Node> n)
+void StaticOracaleContainer::setInstallingNode(ns3::Ptr<ns3::Node> n)
 {
-  if(m.find (name) == m.end ())
-    m[name] = n;
-  else
-    fprintf(stderr, "Error Name is already taken\n");
+  installingNode = n;
 }
 
-ns3::Ptr<ns3::Node> StaticOracaleContainer::getNode(const std::string& name)
+ns3::Ptr<ns3::Node> StaticOracaleContainer::getInstallingNode()
 {
-  if(m.find (name) != m.end ())
-    return m[name];
-
-  return nullptr;
+  return installingNode;
 }
 
-void StaticOracaleContainer::insertForwarder(int node_id, Forwarder *forwarder)
+void StaticOracaleContainer::registerOracle(ns3::Ptr<ns3::Node> n, Forwarder *forwarder)
 {
-  if(fw_map.find (node_id) == fw_map.end ())
-    fw_map[node_id] = forwarder;
-  else
+  if(registry.size () <= n->GetId ())
+  {
+    OracleNode empty;
+    empty.forwarder = nullptr;
+    empty.cs = nullptr;
+    registry.resize (std::max((uint32_t) ns3::NodeList::GetNNodes (), n->GetId () + 1), empty);
+  }
+
+  OracleNode& entry = registry[n->GetId ()];
+  if(entry.forwarder != nullptr)
+  {
     fprintf(stderr, "Forwarder already registered\n");
+    return;
+  }
+
+  entry.node = n;
+  entry.forwarder = forwarder;
+  entry.cs = &forwarder->getCs ();
+  entry.csFromNdnSim = forwarder->getCsFromNdnSim ();
+}
+
+void StaticOracaleContainer::insertReplica(int node_id, const Data& data)
+{
+  std::vector<int>& holders = replicas[data.getName ()];
+
+  if(std::find(holders.begin (), holders.end (), node_id) == holders.end ())
+    holders.push_back (node_id);
+
+  if(!pruneEvent.IsRunning ())
+    pruneEvent = ns3::Simulator::Schedule (ns3::Seconds (ParameterConfiguration::getInstance ()->getParameter ("REPLICA_DIRECTORY_PRUNE")),
+                                           &StaticOracaleContainer::pruneReplicas, this);
+}
+
+void StaticOracaleContainer::pruneReplicas()
+{
+  for(ReplicaMap::iterator it = replicas.begin (); it != replicas.end ();)
+  {
+    std::vector<int>& holders = it->second;
+    for(std::vector<int>::iterator h = holders.begin (); h != holders.end ();)
+    {
+      if(holdsData (*h, it->first))
+        ++h;
+      else
+        h = holders.erase (h);
+    }
+
+    if(holders.empty ())
+      replicas.erase (it++);
+    else
+      ++it;
+  }
+
+  //the next insert schedules the next check
+  if(!replicas.empty ())
+    pruneEvent = ns3::Simulator::Schedule (ns3::Seconds (ParameterConfiguration::getInstance ()->getParameter ("REPLICA_DIRECTORY_PRUNE")),
+                                           &StaticOracaleContainer::pruneReplicas, this);
+}
+
+bool StaticOracaleContainer::holdsData(int node_id, const Name& name)
+{
+  const OracleNode* n = getOracleNode (node_id);
+  if(n == nullptr)
+    return false;
+
+  Interest interest(name);
+  if(n->csFromNdnSim == nullptr)
+    return n->cs->find (interest) != 0;
+
+  return n->csFromNdnSim->Lookup (make_shared<Interest>(interest), false) != nullptr;
+}
+
+void StaticOracaleContainer::removeReplica(int node_id, const Name& name)
+{
+  ReplicaMap::iterator it = replicas.find (name);
+  if(it == replicas.end ())
+    return;
+
+  it->second.erase (std::remove(it->second.begin (), it->second.end (), node_id), it->second.end ());
+
+  if(it->second.empty ())
+    replicas.erase (it);
+}
+
+const std::vector<int>& StaticOracaleContainer::getReplicas(const Name& name)
+{
+  ReplicaMap::iterator it = replicas.find (name);
+  if(it == replicas.end ())
+    return noReplicas;
+
+  return it->second;
+}
+
+uint16_t StaticOracaleContainer::getDistance(int from_node_id, int to_node_id)
+{
+  if(distances.empty ())
+    computeDistances();
+
+  if(from_node_id < 0 || to_node_id < 0 || (unsigned int) from_node_id >= distances.size () || (unsigned int) to_node_id >= distances.size ())
+    return UNREACHABLE;
+
+  return distances[from_node_id][to_node_id];
+}
+
+uint16_t StaticOracaleContainer::getNextHopDevice(int from_node_id, int to_node_id)
+{
+  if(from_node_id == to_node_id || getDistance (from_node_id, to_node_id) == UNREACHABLE)
+    return NO_NEXT_HOP;
+
+  if(nextHops.size () < distances.size ())
+    nextHops.resize (distances.size ());
+
+  std::vector<uint16_t>& row = nextHops[from_node_id];
+  if(!row.empty ())
+    return row[to_node_id];
+
+  //a device leads over a shortest path if its counterpart is one hop closer to the destination
+  row.assign (distances.size (), NO_NEXT_HOP);
+  const std::vector<uint16_t>& own = distances[from_node_id];
+  ns3::Ptr<ns3::Node> node = ns3::NodeList::GetNode (from_node_id);
+  for(uint32_t k = 0; k < node->GetNDevices (); k++)
+  {
+    ns3::Ptr<ns3::Channel> channel = node->GetDevice (k)->GetChannel ();
+    if(channel == nullptr)
+      continue;
+
+    for(uint32_t d = 0; d < channel->GetNDevices (); d++)
+    {
+      int counterpart = channel->GetDevice (d)->GetNode ()->GetId ();
+      if(counterpart == from_node_id)
+        continue;
+
+      const std::vector<uint16_t>& other = distances[counterpart];
+      for(uint32_t to = 0; to < row.size (); to++)
+      {
+        if(row[to] == NO_NEXT_HOP && other[to] != UNREACHABLE && other[to] + 1 == own[to])
+          row[to] = k;
+      }
+    }
+  }
+
+  return row[to_node_id];
+}
+
+const std::vector<int>& StaticOracaleContainer::getNodesByDistance(int node_id)
+{
+  if(nodesByDistance.size () < ns3::NodeList::GetNNodes ())
+    nodesByDistance.resize (ns3::NodeList::GetNNodes ());
+
+  if(node_id < 0 || (unsigned int) node_id >= nodesByDistance.size ())
+    return noReplicas;
+
+  std::vector<int>& nodes = nodesByDistance[node_id];
+  if(!nodes.empty ())
+    return nodes;
+
+  //bucket sort, distances are bounded by the number of nodes
+  std::vector<std::vector<int> > buckets;
+  for(int other = 0; other < (int) ns3::NodeList::GetNNodes (); other++)
+  {
+    uint16_t distance = getDistance (node_id, other);
+    if(distance == UNREACHABLE)
+      continue;
+
+    if(distance >= buckets.size ())
+      buckets.resize (distance + 1);
+    buckets[distance].push_back (other);
+  }
+
+  for(unsigned int i = 0; i < buckets.size (); i++)
+    nodes.insert (nodes.end (), buckets[i].begin (), buckets[i].end ());
+
+  return nodes;
+}
+
+void StaticOracaleContainer::publishSummary(int node_id, const std::vector<bool>& summary)
+{
+  if(summaries.size () <= (unsigned int) node_id)
+    summaries.resize (std::max((int) ns3::NodeList::GetNNodes (), node_id + 1));
+
+  summaries[node_id] = summary;
+}
+
+void StaticOracaleContainer::countSummaryLookup(bool hit)
+{
+  summaryLookups++;
+  if(!hit)
+    summaryFalsePositives++;
 }
 
-nfd::Forwarder* StaticOracaleContainer::getForwarder(int node_id)
+void StaticOracaleContainer::printSummaryStatistics(FILE* out)
 {
-  if(fw_map.find (node_id) != fw_map.end ())
-    return fw_map[node_id];
+  fprintf(out, "Replicas chosen by cache summary: %llu\n", (unsigned long long) summaryLookups);
+  fprintf(out, "False positives: %llu (%.2f%%)\n", (unsigned long long) summaryFalsePositives,
+          summaryLookups > 0 ? 100.0 * summaryFalsePositives / summaryLookups : 0.0);
+}
+
+void StaticOracaleContainer::computeDistances()
+{
+  uint32_t nodes = ns3::NodeList::GetNNodes ();
+
+  //adjacency by node id, we assume strict point to point communication here
+  std::vector<std::vector<int> > neighbours(nodes);
+  for(uint32_t i = 0; i < nodes; i++)
+  {
+    ns3::Ptr<ns3::Node> node = ns3::NodeList::GetNode (i);
+    for(uint32_t k = 0; k < node->GetNDevices (); k++)
+    {
+      ns3::Ptr<ns3::Channel> channel = node->GetDevice (k)->GetChannel ();
+      if(channel == nullptr)
+        continue;
+
+      for(uint32_t d = 0; d < channel->GetNDevices (); d++)
+      {
+        int counterpart = channel->GetDevice (d)->GetNode ()->GetId ();
+        if(counterpart != (int) node->GetId ())
+          neighbours[node->GetId ()].push_back (counterpart);
+      }
+    }
+  }
+
+  distances.assign (nodes, std::vector<uint16_t>(nodes, UNREACHABLE));
+
+  std::deque<int> queue;
+  for(uint32_t source = 0; source < nodes; source++)
+  {
+    std::vector<uint16_t>& dist = distances[source];
+    dist[source] = 0;
+    queue.push_back (source);
+
+    while(!queue.empty ())
+    {
+      int current = queue.front ();
+      queue.pop_front ();
 
-  return nullptr;
+      for(std::vector<int>::iterator it = neighbours[current].begin (); it != neighbours[current].end (); ++it)
+      {
+        if(dist[*it] == UNREACHABLE)
+        {
+          dist[*it] = dist[current] + 1;
+          queue.push_back (*it);
+        }
+      }
+    }
+  }
 }
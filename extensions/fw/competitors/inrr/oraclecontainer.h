@@ -23,9 +23,13 @@
 
 #include "boost/shared_ptr.hpp"
 #include "map"
+#include "vector"
+#include "cstdio"
 #include "ns3/node.h"
+#include "ns3/ndnSIM/model/cs/ndn-content-store.hpp"
 
 #include "ns3/ptr.h"
+#include "ns3/event-id.h"
 namespace nfd
 {
 namespace fw
@@ -37,28 +41,142 @@ public:
 
   static StaticOracaleContainer* getInstance();
 
-  void insertNode(const std::string& name, ns3::Ptr<ns3::Node> n);
-  ns3::Ptr<ns3::Node> getNode(const std::string& name);
-
-  void insertForwarder(int node_id, nfd::Forwarder* forwarder);
-  nfd::Forwarder* getForwarder(int node_id);
+  /**
+   * @brief The OracleNode struct holds the handles of a node running an oracle strategy.
+   */
+  struct OracleNode
+  {
+    ns3::Ptr<ns3::Node> node;
+    nfd::Forwarder* forwarder;
+    nfd::Cs* cs; /*NFD's content store, used if csFromNdnSim is null*/
+    ns3::Ptr<ns3::ndn::ContentStore> csFromNdnSim;
+  };
+
+  /**
+   * @brief announces the node the next oracle strategy is installed on, see OracleHelper.
+   * Strategies are constructed by NFD without knowing their node, so the constructor picks it up from here.
+   */
+  void setInstallingNode(ns3::Ptr<ns3::Node> n);
+  ns3::Ptr<ns3::Node> getInstallingNode();
+
+  /**
+   * @brief registers the forwarder and content store of a node running an oracle strategy.
+   */
+  void registerOracle(ns3::Ptr<ns3::Node> n, nfd::Forwarder* forwarder);
+
+  /**
+   * @brief the registered handles of the node, nullptr if the node does not run an oracle strategy.
+   */
+  const OracleNode* getOracleNode(int node_id) const
+  {
+    if(node_id < 0 || (unsigned int) node_id >= registry.size () || registry[node_id].forwarder == nullptr)
+      return nullptr;
+    return &registry[node_id];
+  }
+
+  nfd::Forwarder* getForwarder(int node_id) const
+  {
+    const OracleNode* n = getOracleNode (node_id);
+    return n != nullptr ? n->forwarder : nullptr;
+  }
+
+  /**
+   * @brief records that the content store of the given node holds the data, the directory is fed by the afterCsInsert
+   * signal of the registered forwarders.
+   */
+  void insertReplica(int node_id, const ndn::Data& data);
+
+  /**
+   * @brief removes a holder from the directory, e.g., after its content store evicted the data.
+   */
+  void removeReplica(int node_id, const ndn::Name& name);
+
+  /**
+   * @brief the node ids whose content store has held data with exactly this name. Evictions are not signaled, callers
+   * have to validate the holders, the whole directory is checked against the content stores every
+   * REPLICA_DIRECTORY_PRUNE seconds.
+   */
+  const std::vector<int>& getReplicas(const ndn::Name& name);
+
+  /**
+   * @brief the hop distance between two nodes, UNREACHABLE if they are not connected.
+   * The all-pairs index is computed by a BFS from every node on the first call, the topology is assumed to be static.
+   */
+  uint16_t getDistance(int from_node_id, int to_node_id);
+
+  /**
+   * @brief the index of the net device (ns3::Node::GetDevice) a node reaches another node over on a shortest path,
+   * NO_NEXT_HOP if they are not connected or identical. This replaces FIB routes to /Node_<id> prefixes, the row of
+   * a node is derived from the distance index on its first lookup.
+   */
+  uint16_t getNextHopDevice(int from_node_id, int to_node_id);
+
+  /**
+   * @brief all nodes reachable from the given node ordered by their hop distance, the node itself comes first.
+   */
+  const std::vector<int>& getNodesByDistance(int node_id);
+
+  /**
+   * @brief publishes the cache summary of a node, replacing its previous one.
+   */
+  void publishSummary(int node_id, const std::vector<bool>& summary);
+
+  /**
+   * @brief the last summary the node published, nullptr if there is none.
+   */
+  const std::vector<bool>* getSummary(int node_id) const
+  {
+    if(node_id < 0 || (unsigned int) node_id >= summaries.size () || summaries[node_id].empty ())
+      return nullptr;
+    return &summaries[node_id];
+  }
+
+  /**
+   * @brief counts a replica chosen by summary and whether the node actually had the data (for comparison only).
+   */
+  void countSummaryLookup(bool hit);
+
+  /**
+   * @brief prints the accuracy of the summaries, i.e., the share of replicas chosen by summary that were false positives.
+   */
+  void printSummaryStatistics(FILE* out);
+
+  static const uint16_t UNREACHABLE = 0xFFFF;
+  static const uint16_t NO_NEXT_HOP = 0xFFFF;
 
 protected:
 
-  StaticOracaleContainer();
+  void computeDistances();
 
-  typedef std::map<
-  std::string, /*name*/
-  ns3::Ptr<ns3::Node> /*node*/
-  > NodeMap;
+  /**
+   * @brief removes all holders from the directory whose content store no longer has the data.
+   */
+  void pruneReplicas();
 
-  typedef std::map<
-  int , /*node id*/
-  nfd::Forwarder* /*forwarder*/
-  > ForwarderMap;
+  /**
+   * @brief checks if the content store of a registered node has data with this name.
+   */
+  bool holdsData(int node_id, const ndn::Name& name);
 
-  NodeMap m;
-  ForwarderMap fw_map;
+  StaticOracaleContainer();
+
+  typedef std::map<
+  ndn::Name, /*name of the data*/
+  std::vector<int> /*ids of the nodes caching it*/
+  > ReplicaMap;
+
+  ns3::Ptr<ns3::Node> installingNode;
+  std::vector<OracleNode> registry; /*indexed by node ids*/
+  ReplicaMap replicas;
+  ns3::EventId pruneEvent;
+
+  std::vector<std::vector<uint16_t> > distances; /*hops, indexed by node ids*/
+  std::vector<std::vector<uint16_t> > nextHops; /*device indices, indexed by node ids, empty until first requested*/
+  std::vector<std::vector<int> > nodesByDistance; /*indexed by node ids, empty until first requested*/
+  std::vector<std::vector<bool> > summaries; /*indexed by node ids, empty if none was published*/
+  uint64_t summaryLookups;
+  uint64_t summaryFalsePositives;
+  std::vector<int> noReplicas;
 
   static StaticOracaleContainer* instance;
 
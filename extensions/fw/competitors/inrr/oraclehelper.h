@@ -0,0 +1,53 @@
+/**
+ * Copyright (c) 2015 Daniel Posch (Alpen-Adria Universität Klagenfurt)
+ *
+ * This file is part of the ndnSIM extension for Stochastic Adaptive Forwarding (SAF).
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef ORACLEHELPER_H
+#define ORACLEHELPER_H
+
+#include "oraclecontainer.h"
+
+#include "ns3/node-container.h"
+#include "ns3/ndnSIM/helper/ndn-strategy-choice-helper.hpp"
+
+namespace nfd
+{
+namespace fw
+{
+
+/**
+ * @brief The OracleHelper class installs an oracle strategy (Oracle, SummaryOracle) on nodes and registers them in
+ * the StaticOracaleContainer.
+ */
+class OracleHelper
+{
+public:
+
+  template<class Strategy>
+  static void Install(const ns3::NodeContainer& nodes, const std::string& prefix)
+  {
+    for(ns3::NodeContainer::Iterator it = nodes.Begin (); it != nodes.End (); ++it)
+    {
+      StaticOracaleContainer::getInstance ()->setInstallingNode (*it);
+      ns3::ndn::StrategyChoiceHelper::Install<Strategy>(*it, prefix);
+    }
+    StaticOracaleContainer::getInstance ()->setInstallingNode (nullptr);
+  }
+};
+
+}
+}
+#endif // ORACLEHELPER_H
@@ -0,0 +1,108 @@
+#include "summaryoracle.h"
+#include <algorithm>
+
+using namespace nfd;
+using namespace nfd::fw;
+
+const Name SummaryOracle::STRATEGY_NAME("ndn:/localhost/nfd/strategy/summary-oracle");
+
+SummaryOracle::SummaryOracle(Forwarder &forwarder, const Name &name) : Oracle(forwarder, name)
+  , summary((unsigned int) ParameterConfiguration::getInstance ()->getParameter ("CACHE_SUMMARY_SIZE"),
+            (unsigned int) ParameterConfiguration::getInstance ()->getParameter ("CACHE_SUMMARY_HASHES"))
+{
+  hashes = std::max(1, (int) ParameterConfiguration::getInstance ()->getParameter ("CACHE_SUMMARY_HASHES"));
+
+  //nodes do not exchange their summaries in sync
+  double refresh = ParameterConfiguration::getInstance ()->getParameter ("CACHE_SUMMARY_REFRESH");
+  refreshEvent = ns3::Simulator::Schedule(ns3::Seconds(randomVariable.GetValue (0, refresh)), &SummaryOracle::refreshSummary, this);
+}
+
+SummaryOracle::~SummaryOracle()
+{
+  ns3::Simulator::Cancel (refreshEvent);
+}
+
+void SummaryOracle::afterCsInsert(const Data& data)
+{
+  if(summarized.insert (data.getName ()).second)
+    summary.insert (data.getName ());
+}
+
+void SummaryOracle::refreshSummary()
+{
+  std::set<Name> cached;
+
+  ns3::Ptr<ns3::ndn::ContentStore> csFromNdnSim = forwarder->getCsFromNdnSim ();
+  if(csFromNdnSim == nullptr)
+  {
+    const Cs& cs = forwarder->getCs ();
+    for(Cs::const_iterator it = cs.begin (); it != cs.end (); ++it)
+      cached.insert (it->getName ());
+  }
+  else
+  {
+    for(ns3::Ptr<ns3::ndn::cs::Entry> it = csFromNdnSim->Begin (); it != csFromNdnSim->End (); it = csFromNdnSim->Next (it))
+      cached.insert (it->GetName ());
+  }
+
+  //names that are counted but no longer cached have been evicted
+  for(std::set<Name>::iterator it = summarized.begin (); it != summarized.end (); ++it)
+  {
+    if(cached.find (*it) == cached.end ())
+      summary.remove (*it);
+  }
+
+  for(std::set<Name>::iterator it = cached.begin (); it != cached.end (); ++it)
+  {
+    if(summarized.find (*it) == summarized.end ())
+      summary.insert (*it);
+  }
+
+  summarized.swap (cached);
+
+  StaticOracaleContainer::getInstance ()->publishSummary (node->GetId (), summary.getBits ());
+
+  refreshEvent = ns3::Simulator::Schedule(ns3::Seconds(ParameterConfiguration::getInstance ()->getParameter ("CACHE_SUMMARY_REFRESH")),
+                                          &SummaryOracle::refreshSummary, this);
+}
+
+int SummaryOracle::findNearestReplica(const std::vector<int>& downstreamNodes, shared_ptr<pit::Entry> pitEntry, int maxDistance)
+{
+  StaticOracaleContainer* container = StaticOracaleContainer::getInstance ();
+  const int self = node->GetId ();
+
+  uint32_t h1, h2;
+  CacheSummary::hash (pitEntry->getName (), h1, h2);
+
+  std::vector<int> summaryHits; // nodes whose summary contains the name at the smallest distance
+  uint16_t hitDistance = 0;
+
+  const std::vector<int>& nodes = container->getNodesByDistance (self);
+  for(std::vector<int>::const_iterator it = nodes.begin (); it != nodes.end (); ++it)
+  {
+    uint16_t distance = container->getDistance (self, *it);
+
+    if(distance > maxDistance || (!summaryHits.empty () && distance > hitDistance))
+      break;
+
+    if(*it == self || leadsOverDownstream(*it, distance, downstreamNodes))
+      continue;
+
+    const std::vector<bool>* s = container->getSummary (*it);
+    if(s != nullptr && CacheSummary::contains (*s, hashes, h1, h2))
+    {
+      summaryHits.push_back (*it);
+      hitDistance = distance;
+    }
+  }
+
+  if(summaryHits.empty ())
+    return -1;
+
+  int nr = summaryHits.at (randomVariable.GetInteger (0, summaryHits.size()-1));
+
+  //only for the comparison with the exact oracle, does not influence the decision
+  container->countSummaryLookup (checkCacheHit(pitEntry, nr));
+
+  return nr;
+}
@@ -0,0 +1,64 @@
+/**
+ * Copyright (c) 2015 Daniel Posch (Alpen-Adria Universität Klagenfurt)
+ *
+ * This file is part of the ndnSIM extension for Stochastic Adaptive Forwarding (SAF).
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef SUMMARYORACLE_H
+#define SUMMARYORACLE_H
+
+#include "oracle.h"
+#include "cachesummary.h"
+#include "../../../utils/parameterconfiguration.h"
+
+#include "ns3/simulator.h"
+#include "set"
+
+/* A realistic variant of iNRR: nodes do not look into the caches of other nodes but route on periodically exchanged
+ * Bloom filter summaries of them. False positives and outdated summaries lead interests to nodes without a replica. */
+
+namespace nfd
+{
+namespace fw
+{
+
+class SummaryOracle : public Oracle
+{
+public:
+  SummaryOracle(Forwarder &forwarder, const Name &name = STRATEGY_NAME);
+
+  virtual ~SummaryOracle();
+
+  static const Name STRATEGY_NAME;
+
+protected:
+
+  virtual int findNearestReplica(const std::vector<int>& downstreamNodes, shared_ptr<pit::Entry> pitEntry, int maxDistance);
+  virtual void afterCsInsert(const ndn::Data& data);
+
+  /**
+   * @brief removes evicted names from the summary by enumerating the own content store and publishes the summary.
+   */
+  void refreshSummary();
+
+  CacheSummary summary;
+  std::set<Name> summarized; /*names currently counted in the summary*/
+  unsigned int hashes;
+
+  ns3::EventId refreshEvent;
+};
+
+}
+}
+#endif // SUMMARYORACLE_H
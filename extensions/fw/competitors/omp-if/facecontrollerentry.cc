@@ -1,4 +1,5 @@
 #include "facecontrollerentry.h"
+#include <algorithm>
 
 using namespace nfd;
 using namespace nfd::fw;
@@ -6,18 +7,24 @@ using namespace nfd::fw;
 FaceControllerEntry::FaceControllerEntry(std::string prefix)
 {
   this->prefix = prefix;
+  weightsOutdated = true;
+  updates = 0;
 }
 
 FaceControllerEntry::FaceControllerEntry(const FaceControllerEntry &other)
 {
   this->prefix = other.prefix;
   this->map = other.map;
+  this->weightsOutdated = true;
+  this->updates = 0;
 }
 
 FaceControllerEntry FaceControllerEntry::operator=(const FaceControllerEntry& other)
 {
   this->prefix = other.prefix;
   this->map = other.map;
+  this->weightsOutdated = true;
+  this->updates = 0;
 
   return *this;
 }
@@ -35,32 +42,101 @@ int FaceControllerEntry::determineOutFace (int inFace_id, double rvalue)
   }
   else if(map.size () > 0)
   {
-    double w_sum = 0.0;
-    for(GoodFaceMap::iterator it = map.begin (); it != map.end (); it++)
-    {
-      if(it->first != inFace_id)
-      {
-        w_sum+= 1.0/(double) it->second.GetMilliSeconds (); //sum weights
-      }
-    }
+    updateWeights();
+
+    //leave out the weight of the in face, faces behind it are shifted by its weight
+    std::vector<int>::iterator in = std::lower_bound(faces.begin (), faces.end (), inFace_id);
+    size_t inIndex = in - faces.begin ();
+    double inWeight = 0.0;
+    if(in != faces.end () && *in == inFace_id)
+      inWeight = weights[inIndex];
+    else
+      inIndex = faces.size ();
 
-    if(w_sum == 0.0)
+    double w_sum = prefixWeight(faces.size ()) - inWeight;
+    if(w_sum <= 0.0)
       return DROP_FACE_ID; // just in case..
 
-    double sum = 0.0;
-    for(GoodFaceMap::iterator it = map.begin (); it != map.end (); it++)
+    //inverse transfrom sampling by descending the fenwick tree
+    double target = rvalue * w_sum;
+    if(inIndex < faces.size () && target > prefixWeight(inIndex))
+      target += inWeight;
+
+    size_t pick = findWeight(target);
+
+    //rounding may hit the end or the in face itself
+    if(pick >= faces.size ())
+      pick = faces.size () - 1;
+    if(pick == inIndex)
+      pick = (pick + 1 < faces.size ()) ? pick + 1 : pick - 1;
+
+    return faces[pick];
+  }
+  return DROP_FACE_ID;
+}
+
+void FaceControllerEntry::updateWeights()
+{
+  //point updates accumulate rounding errors, so the tree is also rebuilt after a while
+  if(!weightsOutdated && updates < 64 * faces.size ())
+    return;
+
+  faces.clear ();
+  weights.clear ();
+  for(GoodFaceMap::iterator it = map.begin (); it != map.end (); it++)
+  {
+    faces.push_back (it->first);
+    weights.push_back (1.0 / it->second);
+  }
+
+  //every node i holds the sum of the weights (i - lowbit(i), i]
+  tree = std::vector<double>(faces.size () + 1, 0.0);
+  for(size_t i = 1; i <= faces.size (); i++)
+  {
+    tree[i] += weights[i - 1];
+    size_t parent = i + (i & (~i + 1));
+    if(parent <= faces.size ())
+      tree[parent] += tree[i];
+  }
+
+  weightsOutdated = false;
+  updates = 0;
+}
+
+void FaceControllerEntry::setWeight(size_t index, double weight)
+{
+  double delta = weight - weights[index];
+  weights[index] = weight;
+  for(size_t i = index + 1; i < tree.size (); i += i & (~i + 1))
+    tree[i] += delta;
+  updates++;
+}
+
+double FaceControllerEntry::prefixWeight(size_t count)
+{
+  double sum = 0.0;
+  for(size_t i = count; i > 0; i -= i & (~i + 1))
+    sum += tree[i];
+  return sum;
+}
+
+size_t FaceControllerEntry::findWeight(double target)
+{
+  size_t step = 1;
+  while(step * 2 < tree.size ())
+    step *= 2;
+
+  //the largest position whose prefix weight stays below target, the face behind it is the pick
+  size_t pos = 0;
+  for(; step > 0; step /= 2)
+  {
+    if(pos + step < tree.size () && tree[pos + step] < target)
     {
-      if(it->first != inFace_id)
-      {
-        sum += 1.0 / ((double) it->second.GetMilliSeconds () * (double) (w_sum));
-        if(rvalue <=  sum)//inverse transfrom sampling on normalized values
-        {
-          return it->first;
-        }
-      }
+      pos += step;
+      target -= tree[pos];
     }
   }
-  return DROP_FACE_ID;
+  return pos;
 }
 
 void FaceControllerEntry::expiredInterest(int face_id)
@@ -69,19 +145,27 @@ void FaceControllerEntry::expiredInterest(int face_id)
   if(it != map.end ())
   {
     map.erase (it);
+    weightsOutdated = true;
   }
 }
 
 void FaceControllerEntry::satisfiedInterest(int face_id, ns3::Time delay, OMPIFType type)
 {
+  double d = std::max(MIN_DELAY, delay.GetSeconds ());
+
   GoodFaceMap::iterator it = map.find (face_id);
   if(it != map.end ())
   {
     //there is no averaging mechanism suggested in the paper, thus we use an exponential moving average
-    map[face_id] = ns3::MilliSeconds(round((0.9*(double)map[face_id].GetMilliSeconds () + 0.1*(double)delay.GetMilliSeconds ())));
+    it->second = 0.9 * it->second + 0.1 * d;
+    if(!weightsOutdated)
+      setWeight(std::lower_bound(faces.begin (), faces.end (), face_id) - faces.begin (), 1.0 / it->second);
   }
   else if(type == OMPIFType::Client || map.size () == 0) //only add if client if map size > 0
-    map[face_id] = delay; //new entry
+  {
+    map[face_id] = d; //new entry
+    weightsOutdated = true;
+  }
 }
 
 void FaceControllerEntry::addAlternativeGoodFace(int face_id, OMPIFType type)
@@ -93,7 +177,34 @@ void FaceControllerEntry::addAlternativeGoodFace(int face_id, OMPIFType type)
   //else add alternative path with some default rtt-delay
   //we can not estimate the delay, and the paper does not provide a default value so we just take 1 sec as default!
   if(type == OMPIFType::Client || map.size () == 0)
-    map[face_id] = ns3::Time(DEFAULT_DELAY);
+  {
+    map[face_id] = DEFAULT_DELAY;
+    weightsOutdated = true;
+  }
 }
 
+void FaceControllerEntry::saveCheckpoint(std::ostream& os)
+{
+  checkpoint::write<uint32_t>(os, map.size ());
+  for(GoodFaceMap::iterator it = map.begin (); it != map.end (); ++it)
+  {
+    checkpoint::write(os, it->first);
+    checkpoint::write<int64_t>(os, (int64_t) llround(it->second * 1e9));
+  }
+}
 
+void FaceControllerEntry::loadCheckpoint(std::istream& is)
+{
+  uint32_t size = 0;
+  checkpoint::read(is, size);
+  map.clear ();
+  for(uint32_t i = 0; i < size && is.good (); i++)
+  {
+    int face_id;
+    int64_t delay;
+    checkpoint::read(is, face_id);
+    checkpoint::read(is, delay);
+    map[face_id] = std::max(MIN_DELAY, delay / 1e9);
+  }
+  weightsOutdated = true;
+}
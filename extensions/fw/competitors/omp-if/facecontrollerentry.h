@@ -3,12 +3,15 @@
 
 #include <map>
 #include <string>
+#include <vector>
 #include <math.h>
 
 #include "ns3/timer.h"
 #include "../../../utils/parameterconfiguration.h"
+#include "../../../utils/checkpoint.h"
 
-#define DEFAULT_DELAY "1000.0ms"
+#define DEFAULT_DELAY 1.0 // seconds
+#define MIN_DELAY 1e-9 // seconds, keeps the weight 1/delay finite
 
 namespace nfd
 {
@@ -27,6 +30,10 @@ public:
 
   std::string getPrefix();
 
+  /**
+   * @brief draws a good face other than the in face with a probability proportional to 1/delay.
+   * @param rvalue uniform random value in [0,1]
+   */
   int determineOutFace(int inFace_id, double rvalue);
 
   void expiredInterest(int face_id);
@@ -34,17 +41,46 @@ public:
 
   void addAlternativeGoodFace(int face_id, OMPIFType type);
 
+  void saveCheckpoint(std::ostream& os);
+  void loadCheckpoint(std::istream& is);
+
 protected:
 
   std::string prefix;
 
   typedef std::map
   < int, /*face ID*/
-    ns3::Time /* delay of face*/
+    double /* delay of face in seconds*/
   > GoodFaceMap;
 
+  /**
+   * @brief rebuilds the weights in O(n) if the face set changed since the last selection.
+   */
+  void updateWeights();
+
+  /**
+   * @brief sets the weight of faces[index] in O(log n), the delay of a face changes on every satisfied interest.
+   */
+  void setWeight(size_t index, double weight);
+
+  /**
+   * @brief the sum of the weights of faces[0..count-1].
+   */
+  double prefixWeight(size_t count);
+
+  /**
+   * @brief the index of the first face whose prefix weight reaches target, faces.size() if none.
+   */
+  size_t findWeight(double target);
+
   GoodFaceMap map;
 
+  std::vector<int> faces; /*faces of the map in order*/
+  std::vector<double> weights; /*1/delay of faces[i]*/
+  std::vector<double> tree; /*fenwick tree over the weights, 1-indexed*/
+  bool weightsOutdated; /*the face set changed*/
+  size_t updates; /*weight updates since the last rebuild*/
+
 };
 
 }
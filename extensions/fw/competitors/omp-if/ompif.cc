@@ -6,15 +6,24 @@ using namespace nfd::fw;
 const Name OMPIF::STRATEGY_NAME("ndn:/localhost/nfd/strategy/ompif");
 
 OMPIF::OMPIF(Forwarder &forwarder, const Name &name) : Strategy(forwarder, name)
+  , timeOuts(ParameterConfiguration::getInstance ()->getParameter ("OMPIF_TIMER_RESOLUTION"))
+  , tickTarget(0)
 {
+  NS3Platform::install ();
+
   prefixComponents = ParameterConfiguration::getInstance ()->getParameter ("PREFIX_COMPONENT");
+  prefixLifetime = time::seconds((int) ParameterConfiguration::getInstance ()->getParameter ("MEASUREMENTS_LIFETIME"));
   type = OMPIFType::Invalid;
+
+  determineNodeName();
+  CheckpointRegistry::getInstance ()->registerComponent (this);
 }
 
 OMPIF::~OMPIF()
 {
-  for(InterestTimeOutMap::iterator it = timeOutMap.begin (); it != timeOutMap.end (); it++)
-    ns3::Simulator::Cancel (it->second); // cancel all open events
+  CheckpointRegistry::getInstance ()->unregisterComponent (this);
+
+  ns3::Simulator::Cancel (tickEvent); // pending time outs die with the wheel
 }
 
 void OMPIF::afterReceiveInterest(const Face& inFace, const Interest& interest ,shared_ptr<fib::Entry> fibEntry, shared_ptr<pit::Entry> pitEntry)
@@ -25,25 +34,39 @@ void OMPIF::afterReceiveInterest(const Face& inFace, const Interest& interest ,s
     return;
   }
 
-  std::string prefix = extractContentPrefix(pitEntry->getInterest().getName());
-
   //lets start with OMPIF strategy here
-  if(fMap.find (prefix) != fMap.end ()) //search FC-entry
+  boost::shared_ptr<FaceControllerEntry> entry = findFaceControllerEntry(extractContentPrefix(pitEntry->getInterest().getName()));
+  if(entry) //search FC-entry
   {
-    boost::shared_ptr<FaceControllerEntry> entry = fMap[prefix];
-
     double rvalue = randomVariable.GetValue ();
     int nextHop = entry->determineOutFace(inFace.getId (),rvalue); //get nexthop from entry
     if(nextHop != DROP_FACE_ID)
     {
+      shared_ptr<PendingInterestInfo> info = getPendingInterestInfo(pitEntry);
+
       //check if we observe the time out of the first arrived interest for this pit entry
-      if(timeOutMap.find (pitEntry) == timeOutMap.end ())
+      if(info->timeOut == 0)
       {
         //if not start observing as client rtx may keep pit-entries alive... and we may never see an expire event..
         int ltime = boost::chrono::duration_cast<boost::chrono::milliseconds>(interest.getInterestLifetime ()).count();
-        timeOutMap[pitEntry] = ns3::Simulator::Schedule(ns3::MilliSeconds(ltime), &OMPIF::onInterestTimeOut, this, pitEntry, nextHop);
+        info->timeOut = timeOuts.schedule (ns3::Simulator::Now ().GetSeconds (), ltime / 1000.0,
+                                           boost::bind(&OMPIF::onInterestTimeOut, this, pitEntry, nextHop));
+        scheduleTick();
       }
-      pitMap[pitEntry][nextHop] = ns3::Simulator::Now (); //update delay measurment entry for this face
+
+      //update delay measurment entry for this face
+      bool found = false;
+      for(unsigned int i = 0; i < info->sent.size () && !found; i++)
+      {
+        if(info->sent[i].first == nextHop)
+        {
+          info->sent[i].second = ns3::Simulator::Now ();
+          found = true;
+        }
+      }
+      if(!found)
+        info->sent.push_back (std::make_pair(nextHop, ns3::Simulator::Now ()));
+
       sendInterest(pitEntry, getFaceTable ().get (nextHop));
       return;
     }
@@ -53,119 +76,247 @@ void OMPIF::afterReceiveInterest(const Face& inFace, const Interest& interest ,s
   fib::NextHopList nexthops = fib::NextHopList(fibEntry->getNextHops()); //create copy as we need to shuffle
   std::random_shuffle(nexthops.begin (), nexthops.end(), randomShuffle);
 
-  DelayFaceMap dMap;
+  std::vector<std::pair<int, ns3::Time> > sent;
 
    for (fib::NextHopList::const_iterator it = nexthops.begin(); it != nexthops.end(); ++it)
    {
      shared_ptr<Face> outFace = it->getFace();
      if (pitEntry->canForwardTo(*outFace))
      {
-       dMap[outFace->getId()] = ns3::Simulator::Now ();
+       sent.push_back (std::make_pair(outFace->getId(), ns3::Simulator::Now ()));
         this->sendInterest(pitEntry, outFace);
      }
    }
 
    if(pitEntry->hasUnexpiredOutRecords())
-     pitMap[pitEntry]=dMap; //only store in measurement map if forwarding was possible
+     getPendingInterestInfo(pitEntry)->sent.swap (sent); //only store measurements if forwarding was possible
 }
 
-void OMPIF::onInterestTimeOut(shared_ptr<pit::Entry> pitEntry, int face)
+shared_ptr<OMPIF::PendingInterestInfo> OMPIF::getPendingInterestInfo(shared_ptr<pit::Entry> pitEntry)
 {
-  std::string prefix = extractContentPrefix(pitEntry->getName());
-
-  if(fMap.find (prefix) != fMap.end ()) //
+  shared_ptr<PendingInterestInfo> info = pitEntry->getStrategyInfo<PendingInterestInfo>();
+  if(info == NULL)
   {
-    fMap[prefix]->expiredInterest(face); // this will mark the face as unreliable
+    info = make_shared<PendingInterestInfo>();
+    pitEntry->setStrategyInfo (info);
   }
+  return info;
+}
 
-  InterestTimeOutMap::iterator iit = timeOutMap.find (pitEntry); // erase the entry in the even table
-  if(iit != timeOutMap.end ())
-  {
-    timeOutMap.erase (iit); // cancel time event obsvering the first interest for this entry
-  }
+void OMPIF::onTick()
+{
+  tickEvent = ns3::EventId();
+  timeOuts.advanceTo (tickTarget);
+  scheduleTick();
 }
 
-void OMPIF::beforeSatisfyInterest(shared_ptr<pit::Entry> pitEntry,const Face& inFace, const Data& data)
+void OMPIF::scheduleTick()
 {
-  InterestTimeOutMap::iterator iit = timeOutMap.find (pitEntry);
-  if(iit != timeOutMap.end ())
+  if(timeOuts.empty () || tickEvent.IsRunning ())
+    return;
+
+  // ticks are counted in integers, the tick event always advances the wheel to the tick it was scheduled for
+  tickTarget = timeOuts.nextTick ();
+  int64_t delay = std::max((int64_t) 0, timeOuts.tickTime (tickTarget) - ns3::Simulator::Now ().GetNanoSeconds ());
+  tickEvent = ns3::Simulator::Schedule(ns3::NanoSeconds(delay), &OMPIF::onTick, this);
+}
+
+void OMPIF::onInterestTimeOut(shared_ptr<pit::Entry> pitEntry, int face)
+{
+  boost::shared_ptr<FaceControllerEntry> entry = findFaceControllerEntry(extractContentPrefix(pitEntry->getName()));
+  if(entry)
   {
-    ns3::Simulator::Cancel (iit->second); //cancel time event if we were observing it
-    timeOutMap.erase (iit); //and delete it from map
+    entry->expiredInterest(face); // this will mark the face as unreliable
   }
 
-  PitMap::iterator pit = pitMap.find (pitEntry);
-  if(pit == pitMap.end ())
+  shared_ptr<PendingInterestInfo> info = pitEntry->getStrategyInfo<PendingInterestInfo>();
+  if(info != NULL)
+    info->timeOut = 0; // the first interest for this entry is no longer observed
+}
+
+void OMPIF::beforeSatisfyInterest(shared_ptr<pit::Entry> pitEntry,const Face& inFace, const Data& data)
+{
+  shared_ptr<PendingInterestInfo> info = pitEntry->getStrategyInfo<PendingInterestInfo>();
+  if(info == NULL)
   {
     return; //due to late straggle timer of ndnsim forwarder, just return in this case
   }
 
-  DelayFaceMap dmap = pitMap.find (pitEntry)->second;
-  for(DelayFaceMap::iterator it = dmap.begin (); it != dmap.end (); it++)
+  timeOuts.cancel (info->timeOut); //cancel time out if we were observing it
+
+  for(unsigned int i = 0; i < info->sent.size (); i++)
   {
-    if(it->first == inFace.getId ())
+    if(info->sent[i].first == inFace.getId ())
     {
-      std::string prefix = extractContentPrefix(data.getName());
-      if(fMap.find (prefix) == fMap.end ())
+      shared_ptr<measurements::Entry> me = getMeasurements ().get (extractContentPrefix(data.getName()));
+      if(me == NULL) // the prefix is not under the namespace of the strategy, nothing to learn
+        break;
+
+      shared_ptr<FaceControllerInfo> fcInfo = me->getStrategyInfo<FaceControllerInfo>();
+      if(fcInfo == NULL)
       {
-        fMap[prefix] = boost::shared_ptr<FaceControllerEntry>(new FaceControllerEntry(prefix)); //add new entry
+        fcInfo = createFaceControllerInfo(me); //add new entry
       }
-      fMap[prefix]->satisfiedInterest(inFace.getId (), ns3::Simulator::Now ()-it->second, type); // log satisfied interest
+      getMeasurements ().extendLifetime (*me, prefixLifetime); // entries without satisfied interests expire
+      fcInfo->entry->satisfiedInterest(inFace.getId (), ns3::Simulator::Now ()-info->sent[i].second, type); // log satisfied interest
       break;
     }
   }
-  pitMap.erase (pit);
+  pitEntry->clearStrategyInfo ();
   Strategy::beforeSatisfyInterest(pitEntry,inFace,data);
 }
 
 void OMPIF::beforeExpirePendingInterest(shared_ptr< pit::Entry > pitEntry)
 {
-  std::string prefix = extractContentPrefix(pitEntry->getName());
-
-  if(fMap.find (prefix) != fMap.end ()) //
+  boost::shared_ptr<FaceControllerEntry> entry = findFaceControllerEntry(extractContentPrefix(pitEntry->getName()));
+  if(entry)
   {
     const nfd::pit::OutRecordCollection records = pitEntry->getOutRecords();
     for(nfd::pit::OutRecordCollection::const_iterator it = records.begin (); it!=records.end (); ++it)
     {
-      fMap[prefix]->expiredInterest((*it).getFace()->getId());
+      entry->expiredInterest((*it).getFace()->getId());
     }
   }
 
-  PitMap::iterator it = pitMap.find (pitEntry);
-  if(it != pitMap.end ())
+  shared_ptr<PendingInterestInfo> info = pitEntry->getStrategyInfo<PendingInterestInfo>();
+  if(info != NULL)
   {
-    pitMap.erase (it);
+    timeOuts.cancel (info->timeOut); //cancel time out if we were observing it
+    pitEntry->clearStrategyInfo ();
   }
 
-  InterestTimeOutMap::iterator iit = timeOutMap.find (pitEntry);
-  if(iit != timeOutMap.end ())
+  Strategy::beforeExpirePendingInterest(pitEntry);
+}
+
+void OMPIF::afterReceiveNack(const Face& inFace, const Interest& nack, shared_ptr<fib::Entry> fibEntry, shared_ptr<pit::Entry> pitEntry)
+{
+  //OMPIF never rejects interests itself, but an upstream node may. The face can not deliver the content, so treat it like a time out.
+  boost::shared_ptr<FaceControllerEntry> entry = findFaceControllerEntry(extractContentPrefix(pitEntry->getName()));
+  if(entry)
   {
-    ns3::Simulator::Cancel (iit->second); //cancel time event if we were observing it
-    timeOutMap.erase (iit); //and delete it from map
+    entry->expiredInterest(inFace.getId ()); // this will mark the face as unreliable
   }
 
-  Strategy::beforeExpirePendingInterest(pitEntry);
+  shared_ptr<PendingInterestInfo> info = pitEntry->getStrategyInfo<PendingInterestInfo>();
+  if(info != NULL)
+  {
+    for(unsigned int i = 0; i < info->sent.size (); i++)
+    {
+      if(info->sent[i].first == inFace.getId ())
+      {
+        info->sent.erase (info->sent.begin () + i); // stop the delay measurement for this face
+        break;
+      }
+    }
+  }
+
+  Strategy::afterReceiveNack(inFace, nack, fibEntry, pitEntry);
 }
 
 void OMPIF::onUnsolicitedData(const Face& inFace, const Data& data)
 {
-  std::string prefix = extractContentPrefix(data.getName());
-
   //check if data prefix is known
-  if(fMap.find (prefix) != fMap.end ()) //
+  boost::shared_ptr<FaceControllerEntry> entry = findFaceControllerEntry(extractContentPrefix(data.getName()));
+  if(entry)
   {
-    fMap[prefix]->addAlternativeGoodFace(inFace.getId (), type);
+    entry->addAlternativeGoodFace(inFace.getId (), type);
   }
   Strategy::onUnsolicitedData (inFace,data);
 }
 
-std::string OMPIF::extractContentPrefix(nfd::Name name)
+boost::shared_ptr<FaceControllerEntry> OMPIF::findFaceControllerEntry(const nfd::Name& prefix)
+{
+  shared_ptr<measurements::Entry> me = getMeasurements ().findExactMatch (prefix);
+  shared_ptr<FaceControllerInfo> info;
+  if(me != NULL)
+    info = me->getStrategyInfo<FaceControllerInfo>();
+
+  if(info == NULL)
+  {
+    //a prefix of a loaded checkpoint is known right away
+    if(pendingCheckpoint.find (prefix) == pendingCheckpoint.end ())
+      return boost::shared_ptr<FaceControllerEntry>();
+
+    me = getMeasurements ().get (prefix);
+    if(me == NULL) // the prefix is not under the namespace of the strategy
+      return boost::shared_ptr<FaceControllerEntry>();
+
+    info = createFaceControllerInfo(me);
+    getMeasurements ().extendLifetime (*me, prefixLifetime);
+  }
+
+  return info->entry;
+}
+
+shared_ptr<OMPIF::FaceControllerInfo> OMPIF::createFaceControllerInfo(shared_ptr<measurements::Entry> me)
+{
+  shared_ptr<FaceControllerInfo> info = make_shared<FaceControllerInfo>();
+  info->entry = boost::shared_ptr<FaceControllerEntry>(new FaceControllerEntry(me->getName ().toUri ()));
+  me->setStrategyInfo (info);
+  prefixEntries.push_back (me);
+
+  std::map<nfd::Name, std::string>::iterator pending = pendingCheckpoint.find (me->getName ());
+  if(pending != pendingCheckpoint.end ())
+  {
+    std::istringstream is(pending->second);
+    info->entry->loadCheckpoint (is);
+    pendingCheckpoint.erase (pending);
+  }
+  return info;
+}
+
+void OMPIF::saveCheckpoint(std::ostream& os)
 {
-  std::string prefix = "";
-  for(int i=0; i <= prefixComponents; i++)
+  std::map<nfd::Name, std::string> states = pendingCheckpoint;
+  std::vector<weak_ptr<measurements::Entry> > alive;
+  for(std::vector<weak_ptr<measurements::Entry> >::iterator it = prefixEntries.begin (); it != prefixEntries.end (); ++it)
   {
-    prefix.append ("/");
-    prefix.append (name.get (i).toUri ());
+    shared_ptr<measurements::Entry> me = it->lock ();
+    if(me == NULL || me->getStrategyInfo<FaceControllerInfo>() == NULL)
+      continue;
+    alive.push_back (me);
+
+    std::ostringstream state;
+    me->getStrategyInfo<FaceControllerInfo>()->entry->saveCheckpoint (state);
+    states[me->getName ()] = state.str ();
   }
-  return prefix;
+  prefixEntries.swap (alive);
+
+  checkpoint::write<uint32_t>(os, states.size ());
+  for(std::map<nfd::Name, std::string>::iterator it = states.begin (); it != states.end (); ++it)
+  {
+    checkpoint::write(os, it->first.toUri ());
+    checkpoint::write(os, it->second);
+  }
+}
+
+void OMPIF::loadCheckpoint(std::istream& is)
+{
+  uint32_t size = 0;
+  checkpoint::read(is, size);
+  pendingCheckpoint.clear ();
+  for(uint32_t i = 0; i < size && is.good (); i++)
+  {
+    std::string uri;
+    checkpoint::read(is, uri);
+    checkpoint::read(is, pendingCheckpoint[nfd::Name(uri)]);
+  }
+}
+
+void OMPIF::determineNodeName()
+{
+  nodeName = "UnknownNode";
+  for(nfd::FaceTable::const_iterator it = getFaceTable ().begin (); it != getFaceTable ().end (); ++it)
+  {
+    if(ns3::ndn::NetDeviceFace* netf = dynamic_cast<ns3::ndn::NetDeviceFace*>(&(*(*it))))
+    {
+      nodeName = ns3::Names::FindName(netf->GetNetDevice()->GetNode());
+      return;
+    }
+  }
+}
+
+nfd::Name OMPIF::extractContentPrefix(const nfd::Name& name)
+{
+  return name.getPrefix(prefixComponents + 1);
 }
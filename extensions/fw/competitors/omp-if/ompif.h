@@ -22,13 +22,20 @@
 
 #include "face/face.hpp"
 #include "fw/strategy.hpp"
+#include "fw/strategy-info.hpp"
 
 #include "boost/shared_ptr.hpp"
 #include "ns3/random-variable.h"
+#include "ns3/names.h"
+#include "ns3/ndnSIM/model/ndn-net-device-face.hpp"
 #include "../../../utils/parameterconfiguration.h"
+#include "../../../utils/checkpoint.h"
+#include "../../../utils/timerwheel.h"
+#include "../../platform/ns3platform.h"
 #include "facecontrollerentry.h"
 
 #include "boost/chrono.hpp"
+#include "boost/bind.hpp"
 #include <algorithm>
 
 namespace nfd
@@ -36,7 +43,7 @@ namespace nfd
 namespace fw
 {
 
-class OMPIF : public nfd::fw::Strategy
+class OMPIF : public nfd::fw::Strategy, public Checkpointable
 {
 public:
 
@@ -44,48 +51,68 @@ public:
   virtual void afterReceiveInterest(const nfd::Face& inFace, const ndn::Interest& interest,shared_ptr<fib::Entry> fibEntry, shared_ptr<pit::Entry> pitEntry);
   virtual void beforeSatisfyInterest(shared_ptr<pit::Entry> pitEntry,const nfd::Face& inFace, const ndn::Data& data);
   virtual void beforeExpirePendingInterest(shared_ptr< pit::Entry > pitEntry);
+  virtual void afterReceiveNack(const nfd::Face& inFace, const ndn::Interest& nack, shared_ptr<fib::Entry> fibEntry, shared_ptr<pit::Entry> pitEntry);
   virtual void onUnsolicitedData(const Face& inFace, const Data& data);
 
   static const Name STRATEGY_NAME;
 
+  virtual std::string getCheckpointKey(){return "OMPIF/" + nodeName;}
+  virtual void saveCheckpoint(std::ostream& os);
+  virtual void loadCheckpoint(std::istream& is);
+
   protected:
 
   OMPIF(Forwarder &forwarder, const Name &name = STRATEGY_NAME);
 
-  std::string extractContentPrefix(nfd::Name name);
+  nfd::Name extractContentPrefix(const nfd::Name& name);
 
   void onInterestTimeOut(shared_ptr<pit::Entry> pitEntry, int face);
 
+  /**
+   * @brief advances the time out wheel, a tick is only scheduled while time outs are pending.
+   */
+  void onTick();
+  void scheduleTick();
+
   ns3::UniformVariable randomVariable;
 
   static int randomShuffle(int i) { ns3::UniformVariable r;
                                     return r.GetInteger (0,i-1);}
 
-  typedef std::map<
-  std::string /*prefix*/,
-  boost::shared_ptr<FaceControllerEntry>
-  > FaceControllerMap;
+  /*the FC-entry of a prefix, stored in the measurements entry of the prefix*/
+  class FaceControllerInfo : public StrategyInfo
+  {
+  public:
+    boost::shared_ptr<FaceControllerEntry> entry;
+  };
+
+  boost::shared_ptr<FaceControllerEntry> findFaceControllerEntry(const nfd::Name& prefix);
+  shared_ptr<FaceControllerInfo> createFaceControllerInfo(shared_ptr<measurements::Entry> me);
 
-  FaceControllerMap fMap;
+  std::vector<weak_ptr<measurements::Entry> > prefixEntries; // for checkpoints, lookups use the measurements table
+  std::map<nfd::Name /*prefix*/, std::string /*state*/> pendingCheckpoint;
+  std::string nodeName;
 
-  typedef std::map<
-  shared_ptr< pit::Entry >,
-  ns3::EventId
-  > InterestTimeOutMap;
+  void determineNodeName();
 
-  InterestTimeOutMap timeOutMap;
+  /*the delay measurements and the time out of a pending interest, stored in the pit entry*/
+  class PendingInterestInfo : public StrategyInfo
+  {
+  public:
+    PendingInterestInfo() : timeOut(0) {}
 
-  typedef std::map<
-  int /*face_id*/,
-  ns3::Time> DelayFaceMap;
+    std::vector<std::pair<int /*face_id*/, ns3::Time /*sent*/> > sent;
+    TimerWheel::TimerId timeOut; /*observes the first interest of the entry, 0 if none*/
+  };
 
-  typedef std::map<
-  shared_ptr< pit::Entry >,
-  DelayFaceMap> PitMap;
+  shared_ptr<PendingInterestInfo> getPendingInterestInfo(shared_ptr<pit::Entry> pitEntry);
 
-  PitMap pitMap;
+  TimerWheel timeOuts;
+  ns3::EventId tickEvent;
+  uint64_t tickTarget; /*the tick tickEvent advances the wheel to*/
 
   int prefixComponents;
+  time::seconds prefixLifetime;
 
   OMPIFType type;
 };
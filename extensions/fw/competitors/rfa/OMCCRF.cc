@@ -1,4 +1,5 @@
 #include "OMCCRF.h"
+#include <algorithm>
 
 using namespace nfd;
 using namespace nfd::fw;
@@ -6,19 +7,24 @@ using namespace nfd::fw;
 const Name OMCCRF::STRATEGY_NAME("ndn:/localhost/nfd/strategy/omccrf");
 
 OMCCRF::OMCCRF(Forwarder &forwarder, const Name &name) : Strategy(forwarder, name)
+  , outsideNamespaceReported(false)
 {
+  NS3Platform::install ();
+
   prefixComponents = ParameterConfiguration::getInstance ()->getParameter ("PREFIX_COMPONENT");
+  prefixLifetime = time::seconds((int) ParameterConfiguration::getInstance ()->getParameter ("MEASUREMENTS_LIFETIME"));
+
+  determineNodeName();
+  CheckpointRegistry::getInstance ()->registerComponent (this);
 }
 
 OMCCRF::~OMCCRF()
 {
+  CheckpointRegistry::getInstance ()->unregisterComponent (this);
 }
 
 void OMCCRF::afterReceiveInterest(const Face& inFace, const Interest& interest ,shared_ptr<fib::Entry> fibEntry, shared_ptr<pit::Entry> pitEntry)
 {
-  /* Attention!!! interest != pitEntry->interest*/ // necessary to emulate NACKs in ndnSIM2.0
-  /* interst could be /NACK/suffix, while pitEntry->getInterest is /suffix */
-
   if(!fibEntry->hasNextHops()) // check if nexthop(s) exist(s)
   {
     fprintf(stderr, "No next hop for prefix!\n");
@@ -28,77 +34,123 @@ void OMCCRF::afterReceiveInterest(const Face& inFace, const Interest& interest ,
 
   if(pitEntry->hasUnexpiredOutRecords()) //possible rtx or just the same request from a "different" source
     {
-      if(!isRtx(inFace, interest))
+      if(!isRtx(inFace, pitEntry))
       {
-        addToKnownInFaces(inFace, interest); // other client/node requests same content
+        addToKnownInFaces(inFace, pitEntry); // other client/node requests same content
         return; // this aggregates the interest
       }
       //else just continue as it was a normal interest..
     }
-  addToKnownInFaces(inFace, interest);
+  addToKnownInFaces(inFace, pitEntry);
 
-  std::string prefix = extractContentPrefix(pitEntry->getInterest().getName());
-
-  if(pmap.find (prefix) == pmap.end ()) //check if prefix is listed if not create it
+  shared_ptr<measurements::Entry> me = getMeasurements ().get (extractContentPrefix(pitEntry->getInterest().getName()));
+  if(me == NULL) // the prefix is not under the namespace of the strategy, forward without learning
   {
-    //create new entry
-    pmap[prefix] = FacePicEntryMap();
-
-    //add all new hops
-    std::vector<fib::NextHop> nhops = fibEntry->getNextHops ();
-    for(unsigned int i = 0; i < nhops.size(); i++)
+    if(!outsideNamespaceReported)
     {
-      pmap[prefix][nhops.at (i).getFace()->getId()] = boost::shared_ptr<PIC>(new PIC());
+      fprintf(stderr, "OMCCRF: %s is outside the namespace of the strategy, its counts are not kept (check PREFIX_COMPONENT)\n",
+              extractContentPrefix(pitEntry->getInterest().getName()).toUri ().c_str ());
+      outsideNamespaceReported = true;
     }
+    forwardUnlearned(pitEntry, fibEntry);
+    return;
   }
 
-  // now prepare everything for inverse transform sampling to choose the outgoing face
+  shared_ptr<PrefixInfo> info = me->getStrategyInfo<PrefixInfo>();
 
-  //calc sum for normalization and store weights in map
-  std::vector<int> inFaces = getAllInFaces(pitEntry); // in faces are not considerd as outgoing face
-  std::map<int /*face_id*/, double /*weight*/> wmap;
-  double sum = 0.0;
+  if(info == NULL) //check if prefix is listed if not create it
+    info = createPrefixInfo(me, fibEntry);
 
-  for(FacePicEntryMap::iterator it = pmap[prefix].begin(); it != pmap[prefix].end(); it++)
-  {
-    if(std::find(inFaces.begin (), inFaces.end (), it->first) == inFaces.end ()) // add only if not a inface
-    {
-      wmap[it->first]=it->second->getWeight();
-      sum += it->second->getWeight();
-    }
-  }
+  getMeasurements ().extendLifetime (*me, prefixLifetime); // pending interests must find their counts
+  pitEntry->getStrategyInfo<PendingInterestInfo>()->prefix = info; // satisfy and expire find the counts via the pit entry
 
-  //normalize values in wMap
-  for(std::map<int, double>::iterator k = wmap.begin (); k!=wmap.end (); k++)
+  // now prepare everything for inverse transform sampling to choose the outgoing face, in faces are not considerd
+  // the EMAs of the prefix are updated in this pass as one batch, arrivals and departures only change the counts
+  double sum = 0.0;
+  for(unsigned int i = 0; i < info->faces.size (); i++)
   {
-    wmap[k->first] = (k->second/sum);
+    info->pics[i].update();
+    if(!isInFace(pitEntry, info->faces[i]))
+      sum += info->pics[i].getWeight();
   }
 
-  //now draw a random number and choose outgoing face
-  double rvalue = randomVariable.GetValue ();
-  sum = 0.0;
-  int out_face_id = -1;
-  for(std::map<int, double>::iterator k = wmap.begin (); k!=wmap.end (); k++)
+  //now draw a random number and choose outgoing face, weights are normalized on the fly
+  double rvalue = randomVariable.GetValue () * sum;
+  double cumulated = 0.0;
+  int out = -1;
+  for(unsigned int i = 0; i < info->faces.size () && out == -1; i++)
   {
-    sum += k->second;
-    if(rvalue <= sum)
-    {
-      out_face_id = k->first;
-      break;
-    }
+    if(isInFace(pitEntry, info->faces[i]))
+      continue;
+
+    cumulated += info->pics[i].getWeight();
+    if(rvalue <= cumulated)
+      out = i;
   }
 
-  if(out_face_id == -1) // no suitable face found
+  if(out == -1) // no suitable face found
   {
     //rejectPendingInterest(pitEntry); this would create a nack we dont need it so just return
     return;
   }
 
-  //entry must exist no need to use find method
-  pmap[prefix][out_face_id]->increase();
-  pmap[prefix][out_face_id]->update();
+  info->pics[out].increase();
+
+  sendInterest(pitEntry, getFaceTable ().get (info->faces[out]));
+}
+
+void OMCCRF::forwardUnlearned(shared_ptr<pit::Entry> pitEntry, shared_ptr<fib::Entry> fibEntry)
+{
+  pitEntry->getStrategyInfo<PendingInterestInfo>()->unlearned = true; // satisfy and expire have no counts to update
+
+  std::vector<shared_ptr<Face> > candidates;
+  const fib::NextHopList& nhops = fibEntry->getNextHops ();
+  for(fib::NextHopList::const_iterator it = nhops.begin (); it != nhops.end (); ++it)
+  {
+    if(!isInFace(pitEntry, it->getFace()->getId()))
+      candidates.push_back (it->getFace());
+  }
+
+  if(candidates.empty ())
+    return;
 
-  sendInterest(pitEntry, getFaceTable ().get (out_face_id));
+  sendInterest(pitEntry, candidates[randomVariable.GetInteger (0, candidates.size () - 1)]);
+}
+
+shared_ptr<OMCCRF::PrefixInfo> OMCCRF::createPrefixInfo(shared_ptr<measurements::Entry> me, shared_ptr<fib::Entry> fibEntry)
+{
+  shared_ptr<PrefixInfo> info = make_shared<PrefixInfo>();
+  me->setStrategyInfo (info);
+
+  //add all hops
+  const fib::NextHopList& nhops = fibEntry->getNextHops ();
+  for(fib::NextHopList::const_iterator it = nhops.begin (); it != nhops.end (); ++it)
+    info->faces.push_back (it->getFace()->getId());
+
+  std::sort(info->faces.begin (), info->faces.end ());
+  info->faces.erase (std::unique(info->faces.begin (), info->faces.end ()), info->faces.end ());
+  info->pics.resize (info->faces.size ());
+  prefixEntries.push_back (me);
+
+  //restore the counts of the prefix from a loaded checkpoint
+  std::map<nfd::Name, std::string>::iterator pending = pendingCheckpoint.find (me->getName ());
+  if(pending != pendingCheckpoint.end ())
+  {
+    std::istringstream is(pending->second);
+    uint32_t size = 0;
+    checkpoint::read(is, size);
+    for(uint32_t i = 0; i < size && is.good (); i++)
+    {
+      int face_id;
+      PIC pic;
+      checkpoint::read(is, face_id);
+      pic.loadCheckpoint (is);
+      if(PIC* p = info->findPIC (face_id))
+        *p = pic;
+    }
+    pendingCheckpoint.erase (pending);
+  }
+  return info;
 }
 
 void OMCCRF::beforeSatisfyInterest(shared_ptr<pit::Entry> pitEntry,const Face& inFace, const Data& data)
@@ -109,130 +161,168 @@ void OMCCRF::beforeSatisfyInterest(shared_ptr<pit::Entry> pitEntry,const Face& i
     return;
   }
 
-  boost::shared_ptr<PIC> p = findPICEntry(inFace.getId (), extractContentPrefix (data.getName ()));
+  shared_ptr<PrefixInfo> info = findPrefixInfo(pitEntry);
+  PIC* p = info != NULL ? info->findPIC (inFace.getId ()) : NULL;
 
   if(p != NULL)
-  {
     p->decrease ();
-    p->update ();
-  }
-  clearKnownFaces(pitEntry->getInterest());
+  else if(info != NULL)
+    fprintf(stderr, "Error could not find PICEntry for face\n");
+
+  clearKnownFaces(pitEntry);
   Strategy::beforeSatisfyInterest (pitEntry,inFace, data);
 }
 
 void OMCCRF::beforeExpirePendingInterest(shared_ptr< pit::Entry > pitEntry)
 {
+  shared_ptr<PrefixInfo> info = findPrefixInfo(pitEntry);
 
-  std::vector<int> faces = getAllOutFaces (pitEntry);
-
-  for(unsigned int i = 0; i < faces.size (); i++)
+  if(info != NULL)
   {
-    boost::shared_ptr<PIC> p = findPICEntry((*faces.begin ()), extractContentPrefix (pitEntry->getName ()));
-    if(p != NULL)
+    //every out face of the interest has one pending interest less
+    const nfd::pit::OutRecordCollection& records = pitEntry->getOutRecords();
+    for(nfd::pit::OutRecordCollection::const_iterator it = records.begin (); it!=records.end (); ++it)
     {
-      p->decrease ();
-      p->update ();
+      PIC* p = info->findPIC ((*it).getFace()->getId());
+      if(p != NULL)
+        p->decrease ();
     }
   }
-  clearKnownFaces(pitEntry->getInterest());
+  clearKnownFaces(pitEntry);
   Strategy::beforeExpirePendingInterest (pitEntry);
 }
 
-boost::shared_ptr<PIC> OMCCRF::findPICEntry(int face_id, std::string prefix)
+PIC* OMCCRF::PrefixInfo::findPIC(int face_id)
 {
-  PrefixMap::iterator it = pmap.find (prefix);
+  std::vector<int>::iterator it = std::lower_bound(faces.begin (), faces.end (), face_id);
 
-  if(it == pmap.end())
-  {
-    fprintf(stderr, "Error could not find prefix in pmap!\n");
+  if(it == faces.end () || *it != face_id)
     return NULL;
-  }
 
-  FacePicEntryMap::iterator k = pmap[prefix].find(face_id);
+  return &pics[it - faces.begin ()];
+}
 
-  if(k == pmap[prefix].end())
-  {
-    fprintf(stderr, "Error could not find PICEntry for face\n");
-    return NULL;
-  }
+shared_ptr<OMCCRF::PrefixInfo> OMCCRF::findPrefixInfo(shared_ptr<pit::Entry> pitEntry)
+{
+  shared_ptr<PendingInterestInfo> pending = pitEntry->getStrategyInfo<PendingInterestInfo>();
+  if(pending != NULL && pending->prefix != NULL)
+    return pending->prefix;
 
-  return pmap[prefix][face_id];
-}
+  if(pending != NULL && pending->unlearned)
+    return shared_ptr<PrefixInfo>();
 
+  //the interest was not forwarded by us, e.g., after a restart of the strategy
+  shared_ptr<measurements::Entry> me = getMeasurements ().findExactMatch (extractContentPrefix (pitEntry->getName ()));
+  shared_ptr<PrefixInfo> info;
+  if(me != NULL)
+    info = me->getStrategyInfo<PrefixInfo>();
 
-std::string OMCCRF::extractContentPrefix(nfd::Name name)
-{
-  std::string prefix = "";
-  for(int i=0; i <= prefixComponents; i++)
-  {
-    prefix.append ("/");
-    prefix.append (name.get (i).toUri ());
-  }
-  return prefix;
+  if(info == NULL)
+    fprintf(stderr, "Error could not find prefix in measurements!\n");
+
+  return info;
 }
 
-std::vector<int> OMCCRF::getAllOutFaces(shared_ptr<pit::Entry> pitEntry)
+nfd::Name OMCCRF::extractContentPrefix(const nfd::Name& name)
 {
-  std::vector<int> faces;
-  const nfd::pit::OutRecordCollection records = pitEntry->getOutRecords();
-
-  for(nfd::pit::OutRecordCollection::const_iterator it = records.begin (); it!=records.end (); ++it)
-    faces.push_back((*it).getFace()->getId());
-
-  return faces;
+  return name.getPrefix(prefixComponents + 1);
 }
 
-std::vector<int> OMCCRF::getAllInFaces(shared_ptr<pit::Entry> pitEntry)
+bool OMCCRF::isInFace(shared_ptr<pit::Entry> pitEntry, int face_id)
 {
-  std::vector<int> faces;
-  const nfd::pit::InRecordCollection records = pitEntry->getInRecords();
+  const nfd::pit::InRecordCollection& records = pitEntry->getInRecords();
 
   for(nfd::pit::InRecordCollection::const_iterator it = records.begin (); it!=records.end (); ++it)
   {
-    if(! (*it).getFace()->isLocal())
-      faces.push_back((*it).getFace()->getId());
+    if((*it).getFace()->getId() == face_id && !(*it).getFace()->isLocal())
+      return true;
   }
-  return faces;
+  return false;
 }
 
-bool OMCCRF::isRtx (const nfd::Face& inFace, const ndn::Interest& interest)
+bool OMCCRF::isRtx (const nfd::Face& inFace, shared_ptr<pit::Entry> pitEntry)
 {
-  KnownInFaceMap::iterator it = inFaceMap.find (interest.getName ().toUri());
-  if(it == inFaceMap.end ())
+  shared_ptr<PendingInterestInfo> info = pitEntry->getStrategyInfo<PendingInterestInfo>();
+  if(info == NULL)
     return false;
 
-  for(std::list<int>::iterator k = it->second.begin(); k != it->second.end(); k++)
+  return std::find(info->knownInFaces.begin (), info->knownInFaces.end (), inFace.getId ()) != info->knownInFaces.end ();
+}
+
+void OMCCRF::addToKnownInFaces(const nfd::Face& inFace, shared_ptr<pit::Entry> pitEntry)
+{
+  shared_ptr<PendingInterestInfo> info = pitEntry->getStrategyInfo<PendingInterestInfo>();
+  if(info == NULL)
   {
-    if((*k) == inFace.getId ())
-      return true;
+    info = make_shared<PendingInterestInfo>();
+    pitEntry->setStrategyInfo (info);
   }
 
-  return false;
+  if(std::find(info->knownInFaces.begin (), info->knownInFaces.end (), inFace.getId ()) == info->knownInFaces.end ()) //if face not known as in face
+    info->knownInFaces.push_back (inFace.getId ()); //remember it
 }
 
-void OMCCRF::addToKnownInFaces(const nfd::Face& inFace, const ndn::Interest&interest)
+void OMCCRF::clearKnownFaces(shared_ptr<pit::Entry> pitEntry)
 {
-  KnownInFaceMap::iterator it = inFaceMap.find (interest.getName ().toUri());
-
-  if(it == inFaceMap.end ())
-    inFaceMap[interest.getName ().toUri ()] = std::list<int>();
+  //beforeSatisfyInterest may be called multiple times for 1 pit entry, the counts stay reachable for those calls
+  shared_ptr<PendingInterestInfo> info = pitEntry->getStrategyInfo<PendingInterestInfo>();
+  if(info != NULL)
+    info->knownInFaces.clear ();
+}
 
-  std::list<int> list = inFaceMap[interest.getName ().toUri ()];
+void OMCCRF::saveCheckpoint(std::ostream& os)
+{
+  std::map<nfd::Name, std::string> states = pendingCheckpoint;
+  std::vector<weak_ptr<measurements::Entry> > alive;
+  for(std::vector<weak_ptr<measurements::Entry> >::iterator it = prefixEntries.begin (); it != prefixEntries.end (); ++it)
+  {
+    shared_ptr<measurements::Entry> me = it->lock ();
+    if(me == NULL || me->getStrategyInfo<PrefixInfo>() == NULL)
+      continue;
+    alive.push_back (me);
+
+    shared_ptr<PrefixInfo> info = me->getStrategyInfo<PrefixInfo>();
+    std::ostringstream state;
+    checkpoint::write<uint32_t>(state, info->faces.size ());
+    for(unsigned int i = 0; i < info->faces.size (); i++)
+    {
+      checkpoint::write(state, info->faces[i]);
+      info->pics[i].saveCheckpoint (state);
+    }
+    states[me->getName ()] = state.str ();
+  }
+  prefixEntries.swap (alive);
 
-  if(std::find(list.begin (),list.end (), inFace.getId()) == list.end ()) //if face not known as in face
-    inFaceMap[interest.getName ().toUri ()].push_back(inFace.getId());    //remember it
+  checkpoint::write<uint32_t>(os, states.size ());
+  for(std::map<nfd::Name, std::string>::iterator it = states.begin (); it != states.end (); ++it)
+  {
+    checkpoint::write(os, it->first.toUri ());
+    checkpoint::write(os, it->second);
+  }
 }
 
-void OMCCRF::clearKnownFaces(const ndn::Interest&interest)
+void OMCCRF::loadCheckpoint(std::istream& is)
 {
-  KnownInFaceMap::iterator it = inFaceMap.find (interest.getName ().toUri());
-
-  if(it == inFaceMap.end ())
+  uint32_t size = 0;
+  checkpoint::read(is, size);
+  pendingCheckpoint.clear ();
+  for(uint32_t i = 0; i < size && is.good (); i++)
   {
-    //This may happen due to bad behavior of NDN core code!
-    //beforeSatisfyInterest may be called multiple times for 1 pit entry..
-    return;
+    std::string uri;
+    checkpoint::read(is, uri);
+    checkpoint::read(is, pendingCheckpoint[nfd::Name(uri)]);
   }
-  inFaceMap.erase (it);
 }
 
+void OMCCRF::determineNodeName()
+{
+  nodeName = "UnknownNode";
+  for(nfd::FaceTable::const_iterator it = getFaceTable ().begin (); it != getFaceTable ().end (); ++it)
+  {
+    if(ns3::ndn::NetDeviceFace* netf = dynamic_cast<ns3::ndn::NetDeviceFace*>(&(*(*it))))
+    {
+      nodeName = ns3::Names::FindName(netf->GetNetDevice()->GetNode());
+      return;
+    }
+  }
+}
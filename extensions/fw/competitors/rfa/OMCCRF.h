@@ -22,18 +22,23 @@
 
 #include "face/face.hpp"
 #include "fw/strategy.hpp"
+#include "fw/strategy-info.hpp"
 #include "pic.h"
 
 #include "boost/shared_ptr.hpp"
 #include "ns3/random-variable.h"
+#include "ns3/names.h"
+#include "ns3/ndnSIM/model/ndn-net-device-face.hpp"
 #include "../../../utils/parameterconfiguration.h"
+#include "../../../utils/checkpoint.h"
+#include "../../platform/ns3platform.h"
 
 namespace nfd
 {
 namespace fw
 {
 
-class OMCCRF : public nfd::fw::Strategy
+class OMCCRF : public nfd::fw::Strategy, public Checkpointable
 {
 public:
   OMCCRF(Forwarder &forwarder, const Name &name = STRATEGY_NAME);
@@ -45,40 +50,59 @@ public:
 
   static const Name STRATEGY_NAME;
 
+  virtual std::string getCheckpointKey(){return "OMCCRF/" + nodeName;}
+  virtual void saveCheckpoint(std::ostream& os);
+  virtual void loadCheckpoint(std::istream& is);
+
 protected:
 
-  typedef std::map
-    < int, /*face ID*/
-      boost::shared_ptr<PIC> /*Pending Interest Count*/
-    > FacePicEntryMap;
+  /*the pending interest counts of a prefix in face order, stored in the measurements entry of the prefix*/
+  class PrefixInfo : public StrategyInfo
+  {
+  public:
+    std::vector<int> faces; /*sorted face IDs*/
+    std::vector<PIC> pics; /*Pending Interest Count of faces[i]*/
 
-  typedef std::map
-    < std::string, /*prefix*/
-      FacePicEntryMap
-    > PrefixMap;
+    PIC* findPIC(int face_id);
+  };
 
-  std::string extractContentPrefix(nfd::Name name);
-  std::vector<int> getAllOutFaces(shared_ptr<pit::Entry> pitEntry);
-  std::vector<int> getAllInFaces(shared_ptr<pit::Entry> pitEntry);
+  /*the known in faces and the counts of a pending interest, stored in the pit entry*/
+  class PendingInterestInfo : public StrategyInfo
+  {
+  public:
+    PendingInterestInfo() : unlearned(false) {}
 
-  boost::shared_ptr<PIC> findPICEntry(int face_id, std::string prefix);
+    std::vector<int> knownInFaces;
+    shared_ptr<PrefixInfo> prefix; /*null until the interest was forwarded*/
+    bool unlearned; /*forwarded without counts, the prefix is outside the namespace of the strategy*/
+  };
 
-  PrefixMap pmap;
+  nfd::Name extractContentPrefix(const nfd::Name& name);
+  bool isInFace(shared_ptr<pit::Entry> pitEntry, int face_id);
 
-  ns3::UniformVariable randomVariable;
+  shared_ptr<PrefixInfo> findPrefixInfo(shared_ptr<pit::Entry> pitEntry);
+  shared_ptr<PrefixInfo> createPrefixInfo(shared_ptr<measurements::Entry> me, shared_ptr<fib::Entry> fibEntry);
 
-  typedef std::map<
-  std::string /*interest name*/,
-  std::list<int> /*known infaces*/
-  > KnownInFaceMap;
+  /**
+   * @brief forwards to a random next hop that is not an in face, without pending interest counts.
+   */
+  void forwardUnlearned(shared_ptr<pit::Entry> pitEntry, shared_ptr<fib::Entry> fibEntry);
 
-  KnownInFaceMap inFaceMap;
+  ns3::UniformVariable randomVariable;
 
-  bool isRtx(const nfd::Face& inFace, const ndn::Interest&interest);
-  void addToKnownInFaces(const nfd::Face& inFace, const ndn::Interest&interest);
-  void clearKnownFaces(const ndn::Interest&interest);
+  bool isRtx(const nfd::Face& inFace, shared_ptr<pit::Entry> pitEntry);
+  void addToKnownInFaces(const nfd::Face& inFace, shared_ptr<pit::Entry> pitEntry);
+  void clearKnownFaces(shared_ptr<pit::Entry> pitEntry);
+
+  void determineNodeName();
 
   int prefixComponents;
+  time::seconds prefixLifetime;
+
+  std::vector<weak_ptr<measurements::Entry> > prefixEntries; // for checkpoints, lookups use the measurements table
+  std::map<nfd::Name /*prefix*/, std::string /*state*/> pendingCheckpoint;
+  std::string nodeName;
+  bool outsideNamespaceReported;
 };
 
 
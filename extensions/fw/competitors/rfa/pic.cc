@@ -36,3 +36,16 @@ double  PIC::getWeight()
 {
   return weight;
 }
+
+void PIC::saveCheckpoint(std::ostream& os)
+{
+  checkpoint::write(os, avg_pic);
+  checkpoint::write(os, weight);
+}
+
+void PIC::loadCheckpoint(std::istream& is)
+{
+  pic = 0; // interests pending at the checkpoint never return in the restored run
+  checkpoint::read(is, avg_pic);
+  checkpoint::read(is, weight);
+}
@@ -20,16 +20,27 @@
 
 #define ALPHA_PIC 0.9 //as defined in OMCCRF paper
 
+#include "../../../utils/checkpoint.h"
+
 namespace nfd
 {
 namespace fw
 {
 
+/**
+ * @brief The PIC class counts the pending interests of a face for a prefix.
+ * The counts change on every arrival and departure, the EMA of the count and the weight only on update(), which the
+ * strategy calls for all faces of a prefix at once when it draws the next hop.
+ */
 class PIC
 {
 public:
   PIC();
   ~PIC();
+
+  /**
+   * @brief adds the current count to the EMA and recomputes the weight.
+   */
   void update();
 
   void increase();
@@ -37,6 +48,9 @@ public:
 
   double getWeight();
 
+  void saveCheckpoint(std::ostream& os);
+  void loadCheckpoint(std::istream& is);
+
 protected:
   int pic;
   double avg_pic;
@@ -15,12 +15,12 @@ FaceLimitManager::FaceLimitManager(shared_ptr< Face > face)
   //fprintf(stderr, "packets_per_sec %f\n", packets_per_sec );
   //fprintf(stderr, "tokenGenRate %f\n", tokenGenRate );
 
-  this->newTokenEvent = ns3::Simulator::Schedule(ns3::Seconds(0), &FaceLimitManager::newToken, this);
+  this->newTokenEvent = SAFPlatform::getInstance ()->schedule(0, boost::bind(&FaceLimitManager::newToken, this));
 }
 
 FaceLimitManager::~FaceLimitManager ()
 {
-  ns3::Simulator::Cancel(newTokenEvent);
+  SAFPlatform::getInstance ()->cancel(newTokenEvent);
 }
 
 bool FaceLimitManager::addNewPrefix(std::string content_prefix)
@@ -49,32 +49,12 @@ void  FaceLimitManager::newToken()
     }
     indizes = getAllNonFullBuckets ();
   }
-  this->newTokenEvent = ns3::Simulator::Schedule(ns3::MilliSeconds(TOKEN_FILL_INTERVALL), &FaceLimitManager::newToken, this);
+  this->newTokenEvent = SAFPlatform::getInstance ()->schedule(TOKEN_FILL_INTERVALL / 1000.0, boost::bind(&FaceLimitManager::newToken, this));
 }
 
 uint64_t FaceLimitManager::getPhysicalBitrate(shared_ptr< Face > face)
 {
-  if(ns3::ndn::NetDeviceFace *netf = dynamic_cast<ns3::ndn::NetDeviceFace*>(&(*face)))
-  {
-    /*ns3::Ptr<ns3::Node> node = netf->GetNetDevice()->GetNode ();
-    fprintf(stderr, "faceId = %d\n", netf->getId ());
-    for(int i = 0; i < node->GetNDevices (); i++)
-    {
-      fprintf(stderr, "Device[%d] found\n", i);
-    }
-    fprintf(stderr, "\n");*/
-    //-256 because 0-255 is resevred by ndn local faces;
-    ns3::Ptr<ns3::PointToPointNetDevice> nd1 = netf->GetNetDevice()->GetNode ()->GetDevice(netf->getId () - 256)->GetObject<ns3::PointToPointNetDevice>();
-    ns3::DataRateValue dv;
-    nd1->GetAttribute("DataRate", dv);
-    ns3::DataRate d = dv.Get();
-    //fprintf(stderr, "bitrate on face = %llu\n", d.GetBitRate());
-    return d.GetBitRate();
-  }
-  else
-  {
-    return ULONG_MAX;
-  }
+  return SAFPlatform::getInstance ()->getBitrate (*face);
 }
 
 std::vector<std::string> FaceLimitManager::getAllNonFullBuckets()
@@ -107,3 +87,27 @@ std::vector<std::string> FaceLimitManager::getAllRegisteredPrefixs()
   }
   return v;
 }
+
+void FaceLimitManager::saveCheckpoint(std::ostream& os)
+{
+  checkpoint::write<uint32_t>(os, bMap.size ());
+  for(LimitMap::iterator it = bMap.begin (); it != bMap.end (); ++it)
+  {
+    checkpoint::write(os, it->first);
+    it->second->saveCheckpoint (os);
+  }
+}
+
+void FaceLimitManager::loadCheckpoint(std::istream& is)
+{
+  uint32_t size = 0;
+  checkpoint::read(is, size);
+  for(uint32_t i = 0; i < size && is.good (); i++)
+  {
+    std::string prefix;
+    checkpoint::read(is, prefix);
+    if(bMap.find (prefix) == bMap.end ())
+      addNewPrefix (prefix);
+    bMap[prefix]->loadCheckpoint (is);
+  }
+}
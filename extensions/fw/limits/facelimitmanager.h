@@ -28,10 +28,9 @@
 #include "boost/shared_ptr.hpp"
 #include <limits>
 
-#include "ns3-dev/ns3/point-to-point-module.h"
-#include "ns3-dev/ns3/network-module.h"
-#include "ns3/simple-ref-count.h"
-#include "ns3/ndnSIM/model/ndn-net-device-face.hpp"
+#include <boost/bind.hpp>
+
+#include "../platform/safplatform.h"
 
 #include "limiter.h"
 
@@ -46,11 +45,15 @@ public:
   ~FaceLimitManager();
 
   bool addNewPrefix(std::string content_prefix);
+  bool hasPrefix(std::string content_prefix){return bMap.find (content_prefix) != bMap.end ();}
   bool tryForwardInterest(std::string prefix);
   void receivedNack(std::string prefix);
 
   std::vector<std::string> getAllRegisteredPrefixs();
 
+  void saveCheckpoint(std::ostream& os);
+  void loadCheckpoint(std::istream& is);
+
 protected:
 
   void newToken();
@@ -68,7 +71,7 @@ protected:
 
   uint64_t getPhysicalBitrate(shared_ptr< Face > face);
   double tokenGenRate;
-  ns3::EventId newTokenEvent;
+  SAFPlatform::TimerId newTokenEvent;
 };
 
 }
@@ -69,3 +69,15 @@ void Limiter::setNewMaxTokenSize(double maxTokens)
   if(tokens > maxTokens)
     tokens = maxTokens;
 }
+
+void Limiter::saveCheckpoint(std::ostream& os)
+{
+  checkpoint::write(os, tokens);
+  checkpoint::write(os, maxTokens);
+}
+
+void Limiter::loadCheckpoint(std::istream& is)
+{
+  checkpoint::read(is, tokens);
+  checkpoint::read(is, maxTokens);
+}
@@ -19,6 +19,7 @@
 #define LIMITER_H
 
 #include <algorithm>
+#include "../../utils/checkpoint.h"
 
 #define INITIAL_TOKENS 0.5
 
@@ -37,6 +38,9 @@ public:
   virtual bool isFull();
   virtual void setNewMaxTokenSize(double maxTokens);
 
+  virtual void saveCheckpoint(std::ostream& os);
+  virtual void loadCheckpoint(std::istream& is);
+
 protected:
 
   //all tokens are in interests a X bytes
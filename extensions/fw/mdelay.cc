@@ -2,6 +2,7 @@
 #include "climits"
 #include <iostream>
 #include "../utils/parameterconfiguration.h"
+#include "platform/safplatform.h"
 
 namespace nfd {
 namespace fw {
@@ -14,16 +15,61 @@ MDelay::MDelay(std::vector<int> faces, int max_delay_ms) : Mratio(faces)
   curMaxDelay = max_delay_ms;
 }
 
+void SAFSendTimes::stamp(shared_ptr<pit::Entry> pitEntry, int faceId, double time)
+{
+  shared_ptr<SAFSendTimes> info = pitEntry->getStrategyInfo<SAFSendTimes>();
+  if(info == NULL)
+  {
+    info = make_shared<SAFSendTimes>();
+    pitEntry->setStrategyInfo (info);
+  }
+
+  for(std::vector<std::pair<int, double> >::iterator it = info->times.begin (); it != info->times.end (); ++it)
+  {
+    if(it->first == faceId)
+    {
+      it->second = time;
+      return;
+    }
+  }
+  info->times.push_back (std::make_pair(faceId, time));
+}
+
+bool SAFSendTimes::getSendTime(shared_ptr<pit::Entry> pitEntry, int faceId, double& time)
+{
+  shared_ptr<SAFSendTimes> info = pitEntry->getStrategyInfo<SAFSendTimes>();
+  if(info == NULL)
+    return false;
+
+  for(std::vector<std::pair<int, double> >::iterator it = info->times.begin (); it != info->times.end (); ++it)
+  {
+    if(it->first == faceId)
+    {
+      time = it->second;
+      return true;
+    }
+  }
+  return false;
+}
+
 void MDelay::logSatisfiedInterest(shared_ptr<pit::Entry> pitEntry,const Face& inFace, const Data& data)
 {
   //time::steady_clock::TimePoint now = time::steady_clock::now();
-  int now = ns3::Simulator::Now ().GetMilliSeconds ();
+  double now = SAFPlatform::getInstance ()->now ();
 
-  std::list<nfd::pit::OutRecord>::const_iterator outRecord = pitEntry->getOutRecord(inFace);
+  int rtt = 0;
+  double sent = 0;
+  if(SAFSendTimes::getSendTime (pitEntry, inFace.getId (), sent))
+    rtt = (int) ((now - sent) * 1000);
+  else
+  {
+    //not stamped by the engine, fall back to the out record (only valid where NFD's clock is the platform clock)
+    std::list<nfd::pit::OutRecord>::const_iterator outRecord = pitEntry->getOutRecord(inFace);
 
-  //time::steady_clock::Duration rtt = boost::chrono::duration<long int, boost::ratio<1l, 1000000000l> >(now - outRecord->getLastRenewed());
-  int out_rec_ms = boost::chrono::duration_cast<boost::chrono::milliseconds>(outRecord->getLastRenewed().time_since_epoch ()).count();
-  int rtt = now - out_rec_ms;
+    //time::steady_clock::Duration rtt = boost::chrono::duration<long int, boost::ratio<1l, 1000000000l> >(now - outRecord->getLastRenewed());
+    int out_rec_ms = boost::chrono::duration_cast<boost::chrono::milliseconds>(outRecord->getLastRenewed().time_since_epoch ()).count();
+    rtt = (int) (now * 1000) - out_rec_ms;
+  }
 
   if (rtt > curMaxDelay)
     Mratio::logExpiredInterest(pitEntry);
@@ -7,6 +7,27 @@
 namespace nfd {
 namespace fw {
 
+/**
+ * @brief The SAFSendTimes class keeps the platform time an interest was sent on each face, attached to its pit entry.
+ * MDelay measures against these times, the out records use NFD's clock which does not advance outside of ndnSIM.
+ */
+class SAFSendTimes : public StrategyInfo
+{
+public:
+  /**
+   * @brief records the time the interest of the pit entry was sent on a face.
+   */
+  static void stamp(shared_ptr<pit::Entry> pitEntry, int faceId, double time);
+
+  /**
+   * @brief the time the interest of the pit entry was last sent on a face.
+   * @return false if there is no record for the face
+   */
+  static bool getSendTime(shared_ptr<pit::Entry> pitEntry, int faceId, double& time);
+
+  std::vector<std::pair<int /*face ID*/, double /*seconds*/> > times;
+};
+
 class MDelay : public Mratio
 {
 public:
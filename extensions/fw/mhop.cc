@@ -2,8 +2,7 @@
 #include "climits"
 #include <iostream>
 #include "../utils/parameterconfiguration.h"
-#include "ns3/ndnSIM/utils/ndn-fw-hop-count-tag.hpp"
-#include "ns3/ndnSIM/utils/ndn-ns3-packet-tag.hpp"
+#include "platform/safplatform.h"
 
 namespace nfd {
 namespace fw {
@@ -17,13 +16,7 @@ MHop::MHop(std::vector<int> faces, int max_hops) : Mratio(faces)
 void MHop::logSatisfiedInterest(shared_ptr<pit::Entry> pitEntry,const Face& inFace, const Data& data)
 {
 
-  int hopCount = 0;
-
-  auto ns3PacketTag = data.getTag<ns3::ndn::Ns3PacketTag>();
-
-  ns3::ndn::FwHopCountTag hopCountTag;
-  if (ns3PacketTag->getPacket()->PeekPacketTag(hopCountTag))
-    hopCount = hopCountTag.Get();
+  int hopCount = SAFPlatform::getInstance ()->getHopCount (data);
 
   if (hopCount > curMaxHop)
     Mratio::logExpiredInterest(pitEntry);
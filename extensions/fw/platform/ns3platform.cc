@@ -0,0 +1,132 @@
+#include "ns3platform.h"
+
+#include "ns3/names.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/ndnSIM/model/ndn-net-device-face.hpp"
+#include "ns3/ndnSIM/utils/ndn-fw-hop-count-tag.hpp"
+#include "ns3/ndnSIM/utils/ndn-ns3-packet-tag.hpp"
+
+#include <climits>
+#include <boost/lexical_cast.hpp>
+
+using namespace nfd;
+using namespace nfd::fw;
+
+NS3Platform* NS3Platform::ns3Instance = NULL;
+
+NS3Platform::NS3Platform()
+{
+  nextTimerId = 1;
+}
+
+void NS3Platform::install()
+{
+  if(SAFPlatform::hasInstance ())
+    return;
+
+  if(ns3Instance == NULL)
+    ns3Instance = new NS3Platform();
+  SAFPlatform::setInstance (ns3Instance);
+}
+
+double NS3Platform::now()
+{
+  return ns3::Simulator::Now ().GetSeconds ();
+}
+
+SAFPlatform::TimerId NS3Platform::schedule(double delay, const Callback& callback)
+{
+  TimerId id = nextTimerId++;
+  timers[id] = std::make_pair(ns3::Simulator::Schedule(ns3::Seconds(delay), &NS3Platform::fire, this, id), callback);
+  return id;
+}
+
+void NS3Platform::cancel(TimerId id)
+{
+  std::map<TimerId, std::pair<ns3::EventId, Callback> >::iterator it = timers.find (id);
+  if(it == timers.end ())
+    return;
+
+  ns3::Simulator::Cancel (it->second.first);
+  timers.erase (it);
+}
+
+void NS3Platform::fire(TimerId id)
+{
+  std::map<TimerId, std::pair<ns3::EventId, Callback> >::iterator it = timers.find (id);
+  if(it == timers.end ())
+    return;
+
+  Callback callback = it->second.second;
+  timers.erase (it); // the callback may schedule a new timer
+  callback();
+}
+
+boost::shared_ptr<SAFRandomStream> NS3Platform::createRandomStream()
+{
+  return boost::shared_ptr<SAFRandomStream>(new NS3RandomStream());
+}
+
+std::string NS3Platform::getNodeName(const FaceTable& table)
+{
+  for(nfd::FaceTable::const_iterator it = table.begin (); it != table.end (); ++it)
+  {
+    if(ns3::ndn::NetDeviceFace* netf = dynamic_cast<ns3::ndn::NetDeviceFace*>(&(*(*it))))
+      return ns3::Names::FindName(netf->GetNetDevice()->GetNode());
+  }
+  return "UnknownNode";
+}
+
+std::string NS3Platform::getRemoteName(const Face& face)
+{
+  const ns3::ndn::NetDeviceFace* netf = dynamic_cast<const ns3::ndn::NetDeviceFace*>(&face);
+  if(netf == NULL)
+    return "";
+
+  ns3::Ptr<ns3::NetDevice> device = netf->GetNetDevice();
+  ns3::Ptr<ns3::Channel> channel = device->GetChannel();
+  for(uint32_t i = 0; channel != NULL && i < channel->GetNDevices (); i++)
+  {
+    if(channel->GetDevice (i) != device)
+    {
+      ns3::Ptr<ns3::Node> node = channel->GetDevice (i)->GetNode();
+      std::string name = ns3::Names::FindName(node);
+      if(name.empty ())
+        name = "node" + boost::lexical_cast<std::string>(node->GetId ());
+      return name;
+    }
+  }
+  return "";
+}
+
+bool NS3Platform::isNetworkFace(const Face& face)
+{
+  return dynamic_cast<const ns3::ndn::NetDeviceFace*>(&face) != NULL;
+}
+
+uint64_t NS3Platform::getBitrate(const Face& face)
+{
+  if(const ns3::ndn::NetDeviceFace *netf = dynamic_cast<const ns3::ndn::NetDeviceFace*>(&face))
+  {
+    //-256 because 0-255 is resevred by ndn local faces;
+    ns3::Ptr<ns3::PointToPointNetDevice> nd1 = netf->GetNetDevice()->GetNode ()->GetDevice(netf->getId () - 256)->GetObject<ns3::PointToPointNetDevice>();
+    ns3::DataRateValue dv;
+    nd1->GetAttribute("DataRate", dv);
+    ns3::DataRate d = dv.Get();
+    return d.GetBitRate();
+  }
+  else
+  {
+    return ULONG_MAX;
+  }
+}
+
+int NS3Platform::getHopCount(const Data& data)
+{
+  int hopCount = 0;
+  auto ns3PacketTag = data.getTag<ns3::ndn::Ns3PacketTag>();
+  ns3::ndn::FwHopCountTag hopCountTag;
+  if (ns3PacketTag->getPacket()->PeekPacketTag(hopCountTag))
+    hopCount = hopCountTag.Get();
+  return hopCount;
+}
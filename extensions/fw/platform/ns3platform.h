@@ -0,0 +1,81 @@
+/**
+ * Copyright (c) 2015 Daniel Posch (Alpen-Adria Universität Klagenfurt)
+ *
+ * This file is part of the ndnSIM extension for Stochastic Adaptive Forwarding (SAF).
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NS3PLATFORM_H
+#define NS3PLATFORM_H
+
+#include "safplatform.h"
+
+#include "ns3/simulator.h"
+#include "ns3/random-variable.h"
+#include <map>
+
+namespace nfd
+{
+namespace fw
+{
+
+/**
+ * @brief The NS3RandomStream class wraps a ns3::UniformVariable.
+ */
+class NS3RandomStream : public SAFRandomStream
+{
+public:
+  virtual double getValue(){return randomVariable.GetValue ();}
+  virtual uint32_t getInteger(uint32_t min, uint32_t max){return randomVariable.GetInteger (min, max);}
+
+protected:
+  ns3::UniformVariable randomVariable;
+};
+
+/**
+ * @brief The NS3Platform class runs the forwarding core in ns-3/ndnSIM, time is the simulation time.
+ * The class uses a singleton pattern, install() makes it the SAFPlatform.
+ */
+class NS3Platform : public SAFPlatform
+{
+public:
+
+  /**
+   * @brief installs the ns-3 platform, unless another platform has been installed already.
+   */
+  static void install();
+
+  virtual double now();
+  virtual TimerId schedule(double delay, const Callback& callback);
+  virtual void cancel(TimerId id);
+  virtual boost::shared_ptr<SAFRandomStream> createRandomStream();
+
+  virtual std::string getNodeName(const FaceTable& table);
+  virtual std::string getRemoteName(const Face& face);
+  virtual bool isNetworkFace(const Face& face);
+  virtual uint64_t getBitrate(const Face& face);
+  virtual int getHopCount(const Data& data);
+
+protected:
+  NS3Platform();
+  void fire(TimerId id);
+
+  static NS3Platform* ns3Instance;
+
+  TimerId nextTimerId;
+  std::map<TimerId, std::pair<ns3::EventId, Callback> > timers;
+};
+
+}
+}
+#endif // NS3PLATFORM_H
@@ -0,0 +1,24 @@
+#include "safplatform.h"
+#include <cstdio>
+#include <cstdlib>
+
+using namespace nfd;
+using namespace nfd::fw;
+
+SAFPlatform* SAFPlatform::instance = NULL;
+bool SAFPlatform::debug = false;
+
+SAFPlatform* SAFPlatform::getInstance()
+{
+  if(instance == NULL)
+  {
+    fprintf(stderr, "No SAFPlatform installed!\n");
+    abort();
+  }
+  return instance;
+}
+
+void SAFPlatform::setInstance(SAFPlatform* platform)
+{
+  instance = platform;
+}
@@ -0,0 +1,148 @@
+/**
+ * Copyright (c) 2015 Daniel Posch (Alpen-Adria Universität Klagenfurt)
+ *
+ * This file is part of the ndnSIM extension for Stochastic Adaptive Forwarding (SAF).
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef SAFPLATFORM_H
+#define SAFPLATFORM_H
+
+#include "fw/face-table.hpp"
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <iostream>
+#include <string>
+#include <stdint.h>
+
+//logging of the forwarding core, a native build defines SAF_STANDALONE and logs to std::clog
+#ifdef SAF_STANDALONE
+#define SAF_LOG_COMPONENT_DEFINE(name) static const char* safLogComponent = name
+#define SAF_LOG_DEBUG(msg) \
+  do { if(nfd::fw::SAFPlatform::isDebugEnabled ()) std::clog << safLogComponent << ": " << msg << std::endl; } while(false)
+#else
+#include "ns3/log.h"
+#define SAF_LOG_COMPONENT_DEFINE(name) NS_LOG_COMPONENT_DEFINE(name)
+#define SAF_LOG_DEBUG(msg) NS_LOG_DEBUG(msg)
+#endif
+
+namespace nfd
+{
+namespace fw
+{
+
+/**
+ * @brief The SAFRandomStream class provides uniformly distributed random numbers.
+ * Each component draws from its own stream.
+ */
+class SAFRandomStream
+{
+public:
+  virtual ~SAFRandomStream(){}
+
+  /**
+   * @brief a random value in [0,1).
+   */
+  virtual double getValue() = 0;
+
+  /**
+   * @brief a random integer in [min,max].
+   */
+  virtual uint32_t getInteger(uint32_t min, uint32_t max) = 0;
+};
+
+/**
+ * @brief The SAFPlatform class abstracts everything the forwarding core needs from its environment:
+ * a clock, timers, random numbers and some properties of the faces.
+ * The ns-3 adapter (NS3Platform) is installed by the strategies, a native forwarder or a benchmark
+ * installs the StandalonePlatform (or its own adapter) before the first engine is created.
+ * The class uses a singleton pattern.
+ */
+class SAFPlatform
+{
+public:
+  typedef uint64_t TimerId;
+  typedef boost::function<void()> Callback;
+
+  virtual ~SAFPlatform(){}
+
+  /**
+   * @brief returns the installed platform.
+   */
+  static SAFPlatform* getInstance();
+
+  /**
+   * @brief installs a platform, the platform is owned by the caller.
+   */
+  static void setInstance(SAFPlatform* platform);
+  static bool hasInstance(){return instance != NULL;}
+
+  static void setDebugEnabled(bool enabled){debug = enabled;}
+  static bool isDebugEnabled(){return debug;}
+
+  /**
+   * @brief the current time in seconds.
+   */
+  virtual double now() = 0;
+
+  /**
+   * @brief schedules a callback.
+   * @param delay the delay in seconds
+   * @param callback the callback
+   * @return an id to cancel the timer, ids start at 1 so 0 can be used for "no timer"
+   */
+  virtual TimerId schedule(double delay, const Callback& callback) = 0;
+
+  /**
+   * @brief cancels a timer, canceling an expired or unknown timer has no effect.
+   */
+  virtual void cancel(TimerId id) = 0;
+
+  /**
+   * @brief creates a new independent stream of random numbers.
+   */
+  virtual boost::shared_ptr<SAFRandomStream> createRandomStream() = 0;
+
+  /**
+   * @brief the name of the node the face table belongs to.
+   */
+  virtual std::string getNodeName(const FaceTable& table) = 0;
+
+  /**
+   * @brief the name of the node at the other side of a face, empty if unknown.
+   */
+  virtual std::string getRemoteName(const Face& face) = 0;
+
+  /**
+   * @brief true if the face connects to another node (and is therefore limited), false for application faces.
+   */
+  virtual bool isNetworkFace(const Face& face) = 0;
+
+  /**
+   * @brief the bitrate of a face in bit/s.
+   */
+  virtual uint64_t getBitrate(const Face& face) = 0;
+
+  /**
+   * @brief the number of hops a data packet has travelled, -1 if unknown.
+   */
+  virtual int getHopCount(const Data& data) = 0;
+
+protected:
+  static SAFPlatform* instance;
+  static bool debug;
+};
+
+}
+}
+#endif // SAFPLATFORM_H
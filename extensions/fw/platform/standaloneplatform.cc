@@ -0,0 +1,81 @@
+#include "standaloneplatform.h"
+#include <climits>
+
+using namespace nfd;
+using namespace nfd::fw;
+
+StandalonePlatform::StandalonePlatform(uint32_t seed)
+{
+  currentTime = 0.0;
+  this->seed = seed;
+  streams = 0;
+  nextTimerId = 1;
+  nodeName = "StandaloneNode";
+}
+
+SAFPlatform::TimerId StandalonePlatform::schedule(double delay, const Callback& callback)
+{
+  TimerId id = nextTimerId++;
+  timers[id] = queue.insert (std::make_pair(std::make_pair(currentTime + std::max(0.0, delay), id), callback));
+  return id;
+}
+
+void StandalonePlatform::cancel(TimerId id)
+{
+  std::map<TimerId, TimerQueue::iterator>::iterator it = timers.find (id);
+  if(it == timers.end ())
+    return;
+
+  queue.erase (it->second);
+  timers.erase (it);
+}
+
+size_t StandalonePlatform::run(double time)
+{
+  size_t executed = 0;
+  while(!queue.empty () && queue.begin ()->first.first <= time)
+  {
+    TimerQueue::iterator next = queue.begin ();
+    currentTime = next->first.first;
+    Callback callback = next->second;
+    timers.erase (next->first.second);
+    queue.erase (next);
+
+    callback(); // may schedule new timers
+    executed++;
+  }
+  currentTime = std::max(currentTime, time);
+  return executed;
+}
+
+boost::shared_ptr<SAFRandomStream> StandalonePlatform::createRandomStream()
+{
+  // derive a distinct seed for each stream (golden ratio increment)
+  return boost::shared_ptr<SAFRandomStream>(new StandaloneRandomStream(seed + 0x9e3779b9 * (++streams)));
+}
+
+std::string StandalonePlatform::getRemoteName(const Face& face)
+{
+  std::map<int, std::pair<std::string, uint64_t> >::iterator it = networkFaces.find (face.getId ());
+  if(it == networkFaces.end ())
+    return "";
+  return it->second.first;
+}
+
+bool StandalonePlatform::isNetworkFace(const Face& face)
+{
+  return networkFaces.find (face.getId ()) != networkFaces.end ();
+}
+
+uint64_t StandalonePlatform::getBitrate(const Face& face)
+{
+  std::map<int, std::pair<std::string, uint64_t> >::iterator it = networkFaces.find (face.getId ());
+  if(it == networkFaces.end ())
+    return ULONG_MAX;
+  return it->second.second;
+}
+
+void StandalonePlatform::setNetworkFace(int faceId, const std::string& remoteName, uint64_t bitrate)
+{
+  networkFaces[faceId] = std::make_pair(remoteName, bitrate);
+}
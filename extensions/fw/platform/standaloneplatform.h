@@ -0,0 +1,113 @@
+/**
+ * Copyright (c) 2015 Daniel Posch (Alpen-Adria Universität Klagenfurt)
+ *
+ * This file is part of the ndnSIM extension for Stochastic Adaptive Forwarding (SAF).
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef STANDALONEPLATFORM_H
+#define STANDALONEPLATFORM_H
+
+#include "safplatform.h"
+
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_01.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
+#include <map>
+
+namespace nfd
+{
+namespace fw
+{
+
+/**
+ * @brief The StandaloneRandomStream class draws from a seeded mersenne twister.
+ */
+class StandaloneRandomStream : public SAFRandomStream
+{
+public:
+  StandaloneRandomStream(uint32_t seed) : generator(seed) {}
+
+  virtual double getValue(){return boost::random::uniform_01<double>()(generator);}
+  virtual uint32_t getInteger(uint32_t min, uint32_t max){return boost::random::uniform_int_distribution<uint32_t>(min, max)(generator);}
+
+protected:
+  boost::random::mt19937 generator;
+};
+
+/**
+ * @brief The StandalonePlatform class runs the forwarding core without a simulator.
+ * Time is virtual and only advances by run(), which executes the due timers in order. This makes
+ * replays and benchmarks deterministic and independent of the wall clock. The face properties are configured
+ * by the caller.
+ */
+class StandalonePlatform : public SAFPlatform
+{
+public:
+
+  /**
+   * @brief creates a new platform.
+   * @param seed the seed of the random streams, every stream gets its own seed derived from it
+   */
+  StandalonePlatform(uint32_t seed = 1);
+
+  virtual double now(){return currentTime;}
+  virtual TimerId schedule(double delay, const Callback& callback);
+  virtual void cancel(TimerId id);
+  virtual boost::shared_ptr<SAFRandomStream> createRandomStream();
+
+  virtual std::string getNodeName(const FaceTable& table){return nodeName;}
+  virtual std::string getRemoteName(const Face& face);
+  virtual bool isNetworkFace(const Face& face);
+  virtual uint64_t getBitrate(const Face& face);
+  virtual int getHopCount(const Data& data){return -1;}
+
+  /**
+   * @brief executes all timers due until the given time and advances the clock to it.
+   * @param time the time in seconds
+   * @return the number of executed timers
+   */
+  size_t run(double time);
+
+  /**
+   * @brief the number of pending timers.
+   */
+  size_t getPendingTimers(){return timers.size ();}
+
+  void setNodeName(const std::string& name){nodeName = name;}
+
+  /**
+   * @brief configures a face that connects to another node.
+   * @param faceId the face id
+   * @param remoteName the name of the node at the other side
+   * @param bitrate the bitrate in bit/s
+   */
+  void setNetworkFace(int faceId, const std::string& remoteName, uint64_t bitrate);
+
+protected:
+  double currentTime;
+  uint32_t seed;
+  uint32_t streams;
+  TimerId nextTimerId;
+  std::string nodeName;
+
+  typedef std::multimap<std::pair<double /*time*/, TimerId /*fifo for equal times*/>, Callback> TimerQueue;
+  TimerQueue queue;
+  std::map<TimerId, TimerQueue::iterator> timers;
+
+  std::map<int /*face ID*/, std::pair<std::string /*remote name*/, uint64_t /*bitrate*/> > networkFaces;
+};
+
+}
+}
+#endif // STANDALONEPLATFORM_H
@@ -7,8 +7,16 @@ const Name SAF::STRATEGY_NAME("ndn:/localhost/nfd/strategy/saf");
 
 SAF::SAF(Forwarder &forwarder, const Name &name) : Strategy(forwarder, name)
 {
+  NS3Platform::install ();
+
   const FaceTable& ft = getFaceTable();
-  engine = boost::shared_ptr<SAFEngine>(new SAFEngine(ft, (int) ParameterConfiguration::getInstance ()->getParameter ("PREFIX_COMPONENT")));
+  engine = boost::shared_ptr<SAFEngine>(new SAFEngine(ft, getMeasurements (), (int) ParameterConfiguration::getInstance ()->getParameter ("PREFIX_COMPONENT")));
+
+  if(ParameterConfiguration::getInstance ()->getParameter ("DROP_FILTER_LIFETIME") > 0)
+    dropFilter = boost::shared_ptr<SAFDropFilter>(new SAFDropFilter(
+                   (unsigned int) ParameterConfiguration::getInstance ()->getParameter ("DROP_FILTER_CAPACITY"),
+                   ParameterConfiguration::getInstance ()->getParameter ("DROP_FILTER_FP_RATE"),
+                   ParameterConfiguration::getInstance ()->getParameter ("DROP_FILTER_LIFETIME")));
 
   this->afterAddFace.connect([this] (shared_ptr<Face> face)
   {
@@ -27,23 +35,19 @@ SAF::~SAF()
 
 void SAF::afterReceiveInterest(const Face& inFace, const Interest& interest ,shared_ptr<fib::Entry> fibEntry, shared_ptr<pit::Entry> pitEntry)
 {
-  /* Attention!!! interest != pitEntry->interest*/ // necessary to emulate NACKs in ndnSIM2.0
-  /* interst could be /NACK/suffix, while pitEntry->getInterest is /suffix */
-
   //fprintf(stderr, "In f[%d]= %s\n", inFace.getId (),interest.getName ().toUri ().c_str ());
 
-  //find + exclude inface(s) and already tried outface(s)
-  std::vector<int> originInFaces = getAllInFaces(pitEntry);
-  std::vector<int> alreadyTriedFaces; // keep them empty for now and check if nack or retransmission?
-
-  std::string prefix = interest.getName().get(0).toUri();
-  if(prefix.compare("NACK") == 0)
+  //recently dropped names are nacked right away, the table would very likely drop them again.
+  //the table was not consulted, so the nack is not logged as drop (it would feed back into the drop probability)
+  if(dropFilter && !pitEntry->hasUnexpiredOutRecords() && dropFilter->contains (interest.getName ()))
   {
-    //fprintf(stderr, "Received Nack %s on face[%d]\n", interest.getName().toUri().c_str(), inFace.getId ());
-    //engine->logNack(inFace, pitEntry->getInterest()); //this is not needed anymore as we count this on beforeStatisfyInterest/rejectInterest
-    alreadyTriedFaces = getAllOutFaces(pitEntry);
+    rejectInterest(pitEntry);
+    return;
   }
-  else if(pitEntry->hasUnexpiredOutRecords() && ParameterConfiguration::getInstance ()->getParameter ("RTX_DETECTION") > 0) //possible rtx or just the same request from a "different" source (experimental)
+
+  std::vector<int> alreadyTriedFaces; // keep them empty for now and check if retransmission?
+
+  if(pitEntry->hasUnexpiredOutRecords() && ParameterConfiguration::getInstance ()->getParameter ("RTX_DETECTION") > 0) //possible rtx or just the same request from a "different" source (experimental)
   {
     if(isRtx(inFace, interest))
     {
@@ -56,9 +60,25 @@ void SAF::afterReceiveInterest(const Face& inFace, const Interest& interest ,sha
     }
   }
 
-  //if it wasnt a nack log the inface
-  if(prefix.compare("NACK") != 0)
-    addToKnownInFaces(inFace, interest);
+  addToKnownInFaces(inFace, interest);
+  forwardInterest(alreadyTriedFaces, fibEntry, pitEntry);
+}
+
+void SAF::afterReceiveNack(const Face& inFace, const Interest& nack, shared_ptr<fib::Entry> fibEntry, shared_ptr<pit::Entry> pitEntry)
+{
+  //fprintf(stderr, "Received Nack %s on face[%d]\n", nack.getName().toUri().c_str(), inFace.getId ());
+  //the nack itself is counted on beforeStatisfyInterest/rejectInterest, so just try the remaining faces
+  double dropProbability = 0.0;
+  if(ParameterConfiguration::getInstance ()->getParameter ("BACK_PRESSURE_WEIGHT") > 0 && SAFFeedbackTag::getDropProbability (nack, dropProbability))
+    engine->logDropProbability (inFace, nack, dropProbability);
+
+  forwardInterest(getAllOutFaces(pitEntry), fibEntry, pitEntry);
+}
+
+void SAF::forwardInterest(std::vector<int> alreadyTriedFaces, shared_ptr<fib::Entry> fibEntry, shared_ptr<pit::Entry> pitEntry)
+{
+  //find + exclude inface(s)
+  std::vector<int> originInFaces = getAllInFaces(pitEntry);
 
   const Interest int_to_forward = pitEntry->getInterest();
   int nextHop = engine->determineNextHop(int_to_forward, alreadyTriedFaces, fibEntry);
@@ -72,6 +92,7 @@ void SAF::afterReceiveInterest(const Face& inFace, const Interest& interest ,sha
     if(success)
     {
       //fprintf(stderr, "Transmitting %s on face[%d]\n", int_to_forward.getName().toUri().c_str(), nextHop);
+      engine->logForwardedInterest(pitEntry, nextHop);
       sendInterest(pitEntry, getFaceTable ().get (nextHop));
       return;
     }
@@ -87,7 +108,22 @@ void SAF::afterReceiveInterest(const Face& inFace, const Interest& interest ,sha
   }
   engine->logRejectedInterest(pitEntry, nextHop);
   clearKnownFaces(int_to_forward);
-  rejectPendingInterest(pitEntry);
+
+  if(dropFilter)
+    dropFilter->insert (int_to_forward.getName ());
+
+  rejectInterest(pitEntry);
+}
+
+void SAF::rejectInterest(shared_ptr<pit::Entry> pitEntry)
+{
+  if(ParameterConfiguration::getInstance ()->getParameter ("BACK_PRESSURE_WEIGHT") > 0)
+  {
+    SAFFeedbackTag feedback(engine->getDropProbability (pitEntry->getInterest()), ns3::Simulator::GetContext ());
+    rejectPendingInterest(pitEntry, &feedback);
+  }
+  else
+    rejectPendingInterest(pitEntry);
 }
 
 void SAF::beforeSatisfyInterest(shared_ptr<pit::Entry> pitEntry,const Face& inFace, const Data& data)
@@ -100,6 +136,16 @@ void SAF::beforeSatisfyInterest(shared_ptr<pit::Entry> pitEntry,const Face& inFa
   }
 
   engine->logSatisfiedInterest (pitEntry, inFace, data);
+
+  if(ParameterConfiguration::getInstance ()->getParameter ("BACK_PRESSURE_WEIGHT") > 0)
+  {
+    //consume the feedback of the upstream and replace it by the own one for the downstreams
+    double dropProbability = 0.0;
+    if(SAFFeedbackTag::getDropProbability (data, dropProbability))
+      engine->logDropProbability (inFace, pitEntry->getInterest(), dropProbability);
+    SAFFeedbackTag::setDropProbability (data, engine->getDropProbability (pitEntry->getInterest()));
+  }
+
   clearKnownFaces(pitEntry->getInterest());
   Strategy::beforeSatisfyInterest (pitEntry,inFace, data);
 }
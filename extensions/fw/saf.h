@@ -22,6 +22,10 @@
 #include "fw/strategy.hpp"
 #include "boost/shared_ptr.hpp"
 #include "safengine.h"
+#include "saffeedbacktag.h"
+#include "safdropfilter.h"
+#include "ns3/simulator.h"
+#include "platform/ns3platform.h"
 
 namespace nfd
 {
@@ -40,10 +44,14 @@ public:
   virtual void afterReceiveInterest(const nfd::Face& inFace, const ndn::Interest& interest,shared_ptr<fib::Entry> fibEntry, shared_ptr<pit::Entry> pitEntry);
   virtual void beforeSatisfyInterest(shared_ptr<pit::Entry> pitEntry,const nfd::Face& inFace, const ndn::Data& data);
   virtual void beforeExpirePendingInterest(shared_ptr< pit::Entry > pitEntry);
+  virtual void afterReceiveNack(const nfd::Face& inFace, const ndn::Interest& nack, shared_ptr<fib::Entry> fibEntry, shared_ptr<pit::Entry> pitEntry);
 
   static const Name STRATEGY_NAME;
 
 protected:
+  void forwardInterest(std::vector<int> alreadyTriedFaces, shared_ptr<fib::Entry> fibEntry, shared_ptr<pit::Entry> pitEntry);
+  void rejectInterest(shared_ptr<pit::Entry> pitEntry);
+
   std::vector<int> getAllInFaces(shared_ptr<pit::Entry> pitEntry);
   std::vector<int> getAllOutFaces(shared_ptr<pit::Entry> pitEntry);
 
@@ -52,6 +60,7 @@ protected:
   void clearKnownFaces(const ndn::Interest&interest);
 
   boost::shared_ptr<SAFEngine> engine;
+  boost::shared_ptr<SAFDropFilter> dropFilter; /*recently dropped names, NULL if disabled*/
 
   typedef std::map<
   std::string /*interest name*/,
@@ -0,0 +1,88 @@
+#include "safdropfilter.h"
+#include "platform/safplatform.h"
+#include <cmath>
+
+using namespace nfd;
+using namespace nfd::fw;
+
+SAFDropFilter::SAFDropFilter(unsigned int capacity, double fpRate, double lifetime)
+{
+  if(capacity == 0)
+    capacity = 1;
+  if(fpRate <= 0 || fpRate >= 1)
+    fpRate = 0.01;
+
+  // optimal bloom filter dimensions: m = -n*ln(p)/ln(2)^2, k = m/n*ln(2)
+  size_t m = (size_t) ceil(-((double) capacity) * log(fpRate) / (log(2.0) * log(2.0)));
+  hashes = std::max(1, (int) round(((double) m / (double) capacity) * log(2.0)));
+
+  bits = std::vector<bool>(m, false);
+  oldBits = std::vector<bool>(m, false);
+
+  generationTime = lifetime / 2.0;
+  lastRotation = SAFPlatform::getInstance ()->now ();
+  hits = 0;
+}
+
+void SAFDropFilter::insert(const Name& name)
+{
+  rotate();
+
+  uint32_t h1, h2;
+  hash(name, h1, h2);
+  for(unsigned int i = 0; i < hashes; i++)
+    bits[(h1 + i * h2) % bits.size ()] = true;
+}
+
+bool SAFDropFilter::contains(const Name& name)
+{
+  rotate();
+
+  uint32_t h1, h2;
+  hash(name, h1, h2);
+  if(!test(bits, h1, h2) && !test(oldBits, h1, h2))
+    return false;
+
+  hits++;
+  return true;
+}
+
+bool SAFDropFilter::test(const std::vector<bool>& generation, uint32_t h1, uint32_t h2) const
+{
+  for(unsigned int i = 0; i < hashes; i++)
+  {
+    if(!generation[(h1 + i * h2) % generation.size ()])
+      return false;
+  }
+  return true;
+}
+
+void SAFDropFilter::rotate()
+{
+  double now = SAFPlatform::getInstance ()->now ();
+  if(now - lastRotation < generationTime)
+    return;
+
+  // if more than one generation passed, everything is outdated
+  if(now - lastRotation >= 2 * generationTime)
+    oldBits.assign (bits.size (), false);
+  else
+    oldBits.swap (bits);
+
+  bits.assign (oldBits.size (), false);
+  lastRotation = now;
+}
+
+void SAFDropFilter::hash(const Name& name, uint32_t& h1, uint32_t& h2) const
+{
+  // 64bit FNV-1a over the wire encoding, the halves are used for double hashing
+  const Block& block = name.wireEncode ();
+  uint64_t h = 14695981039346656037ULL;
+  for(Block::const_iterator it = block.begin (); it != block.end (); ++it)
+  {
+    h ^= *it;
+    h *= 1099511628211ULL;
+  }
+  h1 = (uint32_t) h;
+  h2 = (uint32_t) (h >> 32) | 1; // odd, so all positions are reached
+}
@@ -0,0 +1,84 @@
+/**
+ * Copyright (c) 2015 Daniel Posch (Alpen-Adria Universität Klagenfurt)
+ *
+ * This file is part of the ndnSIM extension for Stochastic Adaptive Forwarding (SAF).
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef SAFDROPFILTER_H
+#define SAFDROPFILTER_H
+
+#include "fw/strategy.hpp"
+#include <vector>
+
+namespace nfd
+{
+namespace fw
+{
+
+/**
+ * @brief The SAFDropFilter class remembers recently dropped names in a time-decayed Bloom filter.
+ * Two generations of the filter are kept, the older one is discarded each lifetime/2, so a name is
+ * remembered between lifetime/2 and lifetime seconds after it has been dropped.
+ */
+class SAFDropFilter
+{
+public:
+
+  /**
+   * @brief creates a new filter.
+   * @param capacity the number of names a generation is dimensioned for
+   * @param fpRate the false positive rate at full capacity
+   * @param lifetime the time in seconds a dropped name is remembered
+   */
+  SAFDropFilter(unsigned int capacity, double fpRate, double lifetime);
+
+  /**
+   * @brief remembers a dropped name.
+   * @param name the name
+   */
+  void insert(const Name& name);
+
+  /**
+   * @brief checks if a name has been dropped recently.
+   * @param name the name
+   * @return true if the name (or a false positive) is in the filter.
+   */
+  bool contains(const Name& name);
+
+  /**
+   * @brief the memory used by the filter in bytes.
+   */
+  size_t getMemorySize() const {return 2 * bits.size () / 8;}
+
+  /**
+   * @brief the number of names found in the filter, these interests never reach the forwarding table statistics.
+   */
+  uint64_t getHits() const {return hits;}
+
+protected:
+  void rotate();
+  void hash(const Name& name, uint32_t& h1, uint32_t& h2) const;
+  bool test(const std::vector<bool>& generation, uint32_t h1, uint32_t h2) const;
+
+  std::vector<bool> bits;    /*current generation*/
+  std::vector<bool> oldBits; /*previous generation*/
+  unsigned int hashes;
+  double generationTime;
+  double lastRotation;
+  uint64_t hits;
+};
+
+}
+}
+#endif // SAFDROPFILTER_H
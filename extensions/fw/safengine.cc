@@ -1,17 +1,41 @@
 #include "safengine.h"
+#include "mdelay.h"
 
 using namespace nfd;
 using namespace nfd::fw;
 
-NS_LOG_COMPONENT_DEFINE ("SAFEngine");
+SAF_LOG_COMPONENT_DEFINE ("SAFEngine");
 
-SAFEngine::SAFEngine(const FaceTable& table, unsigned int prefixComponentNumber)
+SAFEngine::SAFEngine(const FaceTable& table, MeasurementsAccessor& measurements, unsigned int prefixComponentNumber)
+  : measurements(measurements), updateEventFWT(0), snapshotEvent(0), outsideNamespaceReported(false)
+  , budgetEntries(0), budgetCountedAt(-1)
 {
   initFaces(table);
   this->prefixComponentNumber = prefixComponentNumber;
+  entryLifetime = time::seconds((int) ParameterConfiguration::getInstance ()->getParameter ("MEASUREMENTS_LIFETIME"));
 
-  updateEventFWT = ns3::Simulator::Schedule(
-        ns3::Seconds(ParameterConfiguration::getInstance ()->getParameter ("UPDATE_INTERVALL")), &SAFEngine::update, this);
+  updateEventFWT = SAFPlatform::getInstance ()->schedule(
+        ParameterConfiguration::getInstance ()->getParameter ("UPDATE_INTERVALL"), boost::bind(&SAFEngine::update, this));
+
+  if(!SAFSnapshot::getDirectory ().empty ())
+  {
+    snapshot = boost::shared_ptr<SAFSnapshot>(new SAFSnapshot(getSnapshotFile()));
+    if(!snapshot->isValid ())
+      snapshot.reset ();
+
+    if(ParameterConfiguration::getInstance ()->getParameter ("SNAPSHOT_INTERVAL") > 0)
+      snapshotEvent = SAFPlatform::getInstance ()->schedule(
+            ParameterConfiguration::getInstance ()->getParameter ("SNAPSHOT_INTERVAL"), boost::bind(&SAFEngine::writeSnapshot, this));
+  }
+
+  CheckpointRegistry::getInstance ()->registerComponent (this);
+}
+
+SAFEngine::~SAFEngine()
+{
+  CheckpointRegistry::getInstance ()->unregisterComponent (this);
+  SAFPlatform::getInstance ()->cancel (updateEventFWT);
+  SAFPlatform::getInstance ()->cancel (snapshotEvent);
 }
 
 void SAFEngine::initFaces(const nfd::FaceTable& table)
@@ -20,6 +44,8 @@ void SAFEngine::initFaces(const nfd::FaceTable& table)
   faces.push_back (DROP_FACE_ID);
 
   fbMap.clear ();
+  faceIdentities.clear ();
+  faceIdentities[DROP_FACE_ID] = "drop";
 
   for(nfd::FaceTable::const_iterator it = table.begin (); it != table.end (); ++it)
   {
@@ -28,6 +54,7 @@ void SAFEngine::initFaces(const nfd::FaceTable& table)
       continue;
     faces.push_back((*it)->getId());
     fbMap[(*it)->getId()] = boost::shared_ptr<FaceLimitManager>(new FaceLimitManager(*it));
+    faceIdentities[(*it)->getId()] = determineFaceIdentity(*it);
   }
 
   std::sort(faces.begin(), faces.end());
@@ -37,74 +64,523 @@ void SAFEngine::initFaces(const nfd::FaceTable& table)
 int SAFEngine::determineNextHop(const Interest& interest, std::vector<int> alreadyTriedFaces, shared_ptr<fib::Entry> fibEntry)
 {
   //check if content prefix has been seen
-  std::string prefix = extractContentPrefix(interest.getName());
+  nfd::Name prefix = interest.getName().getPrefix(prefixComponentNumber + 1);
 
-  if(entryMap.find(prefix) == entryMap.end ())
+  if(!lookUpEntry(prefix))
   {
-    entryMap[prefix] = boost::shared_ptr<SAFEntry>(new SAFEntry(faces, fibEntry, prefix));
+    boost::shared_ptr<SAFEntry> entry = createEntry(interest.getName(), prefixComponentNumber, fibEntry);
+    entry->setSplittable (prefixComponentNumber);
+    bool cached = insertEntry(prefix, entry);
 
     // add buckets for all faces
     for(FaceLimitMap::iterator it = fbMap.begin (); it != fbMap.end (); it++)
     {
-      it->second->addNewPrefix(prefix);
+      if(!it->second->hasPrefix(extractContentPrefix(interest.getName()))) // buckets outlive expired entries
+        it->second->addNewPrefix(extractContentPrefix(interest.getName()));
     }
+
+    if(!cached) // decide with the fresh entry, nothing is learned for this prefix
+      return entry->determineNextHop(interest, alreadyTriedFaces);
   }
 
-  boost::shared_ptr<SAFEntry> entry = entryMap.find(prefix)->second;
+  boost::shared_ptr<SAFEntry> entry = findEntry(interest.getName(), fibEntry);
   return entry->determineNextHop(interest, alreadyTriedFaces);
 }
 
+boost::shared_ptr<SAFEntry> SAFEngine::findEntry(const nfd::Name& name, shared_ptr<fib::Entry> fibEntry)
+{
+  unsigned int component = prefixComponentNumber;
+  boost::shared_ptr<SAFEntry> entry = lookUpEntry(name.getPrefix(component + 1));
+  if(!entry)
+    return entry;
+
+  //follow split entries down to the most specific entry
+  while(entry->isSplit () && component + 2 < name.size ()) // never split by the segment number
+  {
+    component++;
+    nfd::Name childPrefix = name.getPrefix(component + 1);
+    boost::shared_ptr<SAFEntry> child = lookUpEntry(childPrefix);
+    if(child)
+    {
+      entry = child;
+      continue;
+    }
+
+    //children are created on demand by forwarding decisions only, and only within the entry budget
+    if(fibEntry == NULL || !isWithinEntryBudget (1))
+    {
+      component--;
+      break;
+    }
+
+    SAF_LOG_DEBUG("Creating child entry " << childPrefix);
+    child = boost::shared_ptr<SAFEntry>(new SAFEntry(faces, fibEntry, extractContentPrefix(name, component), entry));
+    child->setSplittable (component);
+    if(!insertEntry(childPrefix, child))
+    {
+      component--;
+      break;
+    }
+    entry->getChildren ().insert (childPrefix);
+    budgetEntries++;
+    entry = child;
+  }
+
+  //forwarding decisions keep the entry (and its parents) alive
+  if(fibEntry != NULL)
+    extendLifetime(name.getPrefix(component + 1));
+
+  return entry;
+}
+
+boost::shared_ptr<SAFEntry> SAFEngine::lookUpEntry(const nfd::Name& prefix)
+{
+  shared_ptr<measurements::Entry> me = measurements.findExactMatch (prefix);
+  if(me == NULL)
+    return boost::shared_ptr<SAFEntry>();
+
+  shared_ptr<SAFStrategyInfo> info = me->getStrategyInfo<SAFStrategyInfo>();
+  if(info == NULL)
+    return boost::shared_ptr<SAFEntry>();
+
+  return info->entry;
+}
+
+bool SAFEngine::insertEntry(const nfd::Name& prefix, boost::shared_ptr<SAFEntry> entry)
+{
+  shared_ptr<measurements::Entry> me = measurements.get (prefix);
+  if(me == NULL) // the prefix is not under the namespace of the strategy
+  {
+    if(!outsideNamespaceReported)
+    {
+      fprintf(stderr, "SAFEngine: %s is outside the namespace of the strategy, its state is not kept (check PREFIX_COMPONENT)\n",
+              prefix.toUri ().c_str ());
+      outsideNamespaceReported = true;
+    }
+    return false;
+  }
+
+  shared_ptr<SAFStrategyInfo> info = make_shared<SAFStrategyInfo>(entry);
+  me->setStrategyInfo (info);
+
+  measurements.extendLifetime (*me, entryLifetime);
+  info->expiry = time::steady_clock::now () + entryLifetime;
+
+  entries.push_back (me);
+
+  if(snapshot)
+    restoreEntry(entry);
+
+  std::map<nfd::Name, std::string>::iterator it = pendingCheckpoint.find (prefix);
+  if(it != pendingCheckpoint.end ())
+  {
+    SAF_LOG_DEBUG("Restoring entry " << prefix << " from checkpoint");
+    std::istringstream is(it->second);
+    entry->loadCheckpoint (is);
+    pendingCheckpoint.erase (it);
+  }
+  return true;
+}
+
+void SAFEngine::saveCheckpoint(std::ostream& os)
+{
+  checkpoint::write<uint32_t>(os, fbMap.size ());
+  for(FaceLimitMap::iterator it = fbMap.begin (); it != fbMap.end (); ++it)
+  {
+    std::ostringstream limits;
+    it->second->saveCheckpoint (limits);
+    checkpoint::write(os, it->first);
+    checkpoint::write(os, limits.str ());
+  }
+
+  pruneEntries();
+  std::map<nfd::Name, std::string> states = pendingCheckpoint; // entries not recreated since the last restore are kept
+  for(SAFEntryList::iterator it = entries.begin (); it != entries.end (); ++it)
+  {
+    shared_ptr<measurements::Entry> me = it->lock ();
+    std::ostringstream state;
+    me->getStrategyInfo<SAFStrategyInfo>()->entry->saveCheckpoint (state);
+    states[me->getName ()] = state.str ();
+  }
+
+  checkpoint::write<uint32_t>(os, states.size ());
+  for(std::map<nfd::Name, std::string>::iterator it = states.begin (); it != states.end (); ++it)
+  {
+    checkpoint::write(os, it->first.toUri ());
+    checkpoint::write(os, it->second);
+  }
+}
+
+void SAFEngine::loadCheckpoint(std::istream& is)
+{
+  uint32_t size = 0;
+  checkpoint::read(is, size);
+  for(uint32_t i = 0; i < size && is.good (); i++)
+  {
+    int faceId;
+    std::string limits;
+    checkpoint::read(is, faceId);
+    checkpoint::read(is, limits);
+
+    FaceLimitMap::iterator it = fbMap.find (faceId);
+    if(it == fbMap.end ())
+      continue;
+    std::istringstream ls(limits);
+    it->second->loadCheckpoint (ls);
+  }
+
+  pendingCheckpoint.clear ();
+  checkpoint::read(is, size);
+  for(uint32_t i = 0; i < size && is.good (); i++)
+  {
+    std::string uri;
+    checkpoint::read(is, uri);
+    checkpoint::read(is, pendingCheckpoint[nfd::Name(uri)]);
+  }
+}
+
+void SAFEngine::restoreEntry(boost::shared_ptr<SAFEntry> entry)
+{
+  SAFSnapshot::Record record;
+  if(!snapshot->find (entry->getPrefix (), record))
+    return;
+
+  //remap the rows of the snapshot to the current face ids
+  std::map<std::string, int> faceIds;
+  for(std::map<int, std::string>::iterator it = faceIdentities.begin (); it != faceIdentities.end (); ++it)
+    faceIds[it->second] = it->first;
+
+  size_t layers = record.reliability.size ();
+  std::map<int, std::vector<double> > probabilities;
+  for(size_t f = 0; f < record.faces.size (); f++)
+  {
+    std::map<std::string, int>::iterator id = faceIds.find (record.faces[f]);
+    if(id == faceIds.end ())
+      continue; // the link does not exist any more
+
+    probabilities[id->second] = std::vector<double>(record.probabilities.begin () + f * layers,
+                                                    record.probabilities.begin () + (f + 1) * layers);
+    for(size_t layer = 0; layer < layers; layer++)
+      entry->getStatisticMeasure ()->restoreFaceStatistics (id->second, layer,
+                                                            record.faceReliability[f * layers + layer],
+                                                            record.emaAlpha[f * layers + layer]);
+  }
+
+  SAF_LOG_DEBUG("Restoring entry " << entry->getPrefix () << " from snapshot, " << probabilities.size () << " faces remapped");
+  entry->getForwardingTable ()->restore (probabilities, record.reliability);
+}
+
+void SAFEngine::writeSnapshot()
+{
+  int layers = (int) ParameterConfiguration::getInstance ()->getParameter ("MAX_LAYERS");
+  std::vector<SAFSnapshot::Record> records;
+
+  pruneEntries();
+  for(SAFEntryList::iterator it = entries.begin (); it != entries.end (); ++it)
+  {
+    boost::shared_ptr<SAFEntry> entry = it->lock ()->getStrategyInfo<SAFStrategyInfo>()->entry;
+    boost::shared_ptr<SAFForwardingTable> ftable = entry->getForwardingTable ();
+    std::map<int, double> reliability = ftable->getCurrentReliability ();
+    std::vector<int> tableFaces = ftable->getFaces ();
+
+    SAFSnapshot::Record record;
+    record.prefix = entry->getPrefix ();
+    for(int layer = 0; layer < layers; layer++)
+      record.reliability.push_back (reliability[layer]);
+
+    for(std::vector<int>::iterator f = tableFaces.begin (); f != tableFaces.end (); ++f)
+    {
+      record.faces.push_back (faceIdentities[*f]);
+      for(int layer = 0; layer < layers; layer++)
+      {
+        record.probabilities.push_back (ftable->getForwardingProbability (*f, layer));
+        record.faceReliability.push_back (entry->getStatisticMeasure ()->getFaceReliability (*f, layer));
+        record.emaAlpha.push_back (entry->getStatisticMeasure ()->getEMAAlpha (*f, layer));
+      }
+    }
+    records.push_back (record);
+  }
+
+  SAFSnapshot::write (getSnapshotFile(), records);
+
+  snapshotEvent = SAFPlatform::getInstance ()->schedule(
+        ParameterConfiguration::getInstance ()->getParameter ("SNAPSHOT_INTERVAL"), boost::bind(&SAFEngine::writeSnapshot, this));
+}
+
+std::string SAFEngine::getSnapshotFile()
+{
+  return SAFSnapshot::getDirectory () + "/" + nodeName + ".saf";
+}
+
+std::string SAFEngine::determineFaceIdentity(shared_ptr<Face> face)
+{
+  std::string identity = face->getRemoteUri ().toString ();
+
+  std::string remote = SAFPlatform::getInstance ()->getRemoteName (*face);
+  if(!remote.empty ())
+    identity = remote;
+
+  //faces that look the same (e.g. several application faces) are told apart by their order
+  std::string unique = identity;
+  for(int n = 1; ; n++)
+  {
+    bool used = false;
+    for(std::map<int, std::string>::iterator it = faceIdentities.begin (); it != faceIdentities.end (); ++it)
+      used |= (it->first != face->getId () && it->second == unique);
+    if(!used)
+      return unique;
+    unique = identity + "#" + boost::lexical_cast<std::string>(n);
+  }
+}
+
+void SAFEngine::extendLifetime(const nfd::Name& prefix)
+{
+  time::steady_clock::TimePoint now = time::steady_clock::now ();
+  nfd::Name name = prefix;
+
+  //walk up the parents, each entry has its parent at the next shorter prefix
+  while(true)
+  {
+    shared_ptr<measurements::Entry> me = measurements.findExactMatch (name);
+    if(me == NULL)
+      return;
+
+    shared_ptr<SAFStrategyInfo> info = me->getStrategyInfo<SAFStrategyInfo>();
+    if(info == NULL)
+      return;
+
+    //rescheduling the cleanup is not for free, so extend only once the entry has lived half of its lifetime
+    if(info->expiry - now < entryLifetime / 2)
+    {
+      measurements.extendLifetime (*me, entryLifetime);
+      info->expiry = now + entryLifetime;
+    }
+
+    if(!info->entry->getParent ())
+      return;
+    name = name.getPrefix(-1);
+  }
+}
+
+void SAFEngine::pruneEntries()
+{
+  SAFEntryList alive;
+  for(SAFEntryList::iterator it = entries.begin (); it != entries.end (); ++it)
+  {
+    shared_ptr<measurements::Entry> me = it->lock ();
+    if(me != NULL && me->getStrategyInfo<SAFStrategyInfo>() != NULL)
+      alive.push_back (me);
+  }
+  entries.swap (alive);
+}
+
+size_t SAFEngine::countBudgetEntries()
+{
+  pruneEntries();
+
+  //only forwarding entries of the adaptive granularity count, i.e., neither split entries nor hierarchical parents
+  size_t count = 0;
+  for(SAFEntryList::iterator it = entries.begin (); it != entries.end (); ++it)
+  {
+    boost::shared_ptr<SAFEntry> entry = it->lock ()->getStrategyInfo<SAFStrategyInfo>()->entry;
+    if(entry->isSplittable () && !entry->isSplit ())
+      count++;
+  }
+
+  budgetEntries = count;
+  budgetCountedAt = SAFPlatform::getInstance ()->now ();
+  return count;
+}
+
+bool SAFEngine::isWithinEntryBudget(size_t additional)
+{
+  double budget = ParameterConfiguration::getInstance ()->getParameter ("ADAPTIVE_ENTRY_BUDGET");
+
+  //the list also holds expired and non-budget entries, so it bounds the count from above
+  if(entries.size () + additional <= budget)
+    return true;
+
+  //recount at most once per point in time, interests of a full node would otherwise recount each time
+  if(budgetCountedAt != SAFPlatform::getInstance ()->now ())
+    countBudgetEntries();
+
+  return budgetEntries + additional <= budget;
+}
+
+void SAFEngine::adaptGranularity()
+{
+  ParameterConfiguration* p = ParameterConfiguration::getInstance ();
+  double splitThreshold = p->getParameter ("ADAPTIVE_SPLIT_THRESHOLD");
+  if(splitThreshold <= 0)
+    return;
+
+  //find split entries whose children are all leafs and behave (almost) identically
+  std::multimap<double /*distance*/, nfd::Name /*prefix*/> mergeCandidates;
+  for(SAFEntryList::iterator it = entries.begin (); it != entries.end (); ++it)
+  {
+    shared_ptr<measurements::Entry> me = it->lock ();
+    if(me == NULL || me->getStrategyInfo<SAFStrategyInfo>() == NULL)
+      continue;
+
+    boost::shared_ptr<SAFEntry> entry = me->getStrategyInfo<SAFStrategyInfo>()->entry;
+    if(!entry->isSplit ())
+      continue;
+
+    double distance = determineChildDistance (entry);
+    if(distance >= 0)
+      mergeCandidates.insert (std::make_pair(distance, me->getName ()));
+  }
+
+  //merge identical children, and the most similar ones as long as the budget is exceeded
+  double budget = p->getParameter ("ADAPTIVE_ENTRY_BUDGET");
+  size_t used = countBudgetEntries ();
+  for(std::multimap<double, nfd::Name>::iterator it = mergeCandidates.begin (); it != mergeCandidates.end (); ++it)
+  {
+    if(it->first > p->getParameter ("ADAPTIVE_MERGE_THRESHOLD") && used <= budget)
+      break;
+    mergeEntry (it->second);
+    used = countBudgetEntries ();
+  }
+
+  //split entries whose child prefixes diverge
+  for(SAFEntryList::iterator it = entries.begin (); it != entries.end (); ++it)
+  {
+    shared_ptr<measurements::Entry> me = it->lock ();
+    if(me == NULL || me->getStrategyInfo<SAFStrategyInfo>() == NULL)
+      continue;
+
+    boost::shared_ptr<SAFEntry> entry = me->getStrategyInfo<SAFStrategyInfo>()->entry;
+    if(!entry->isSplittable () || entry->isSplit ())
+      continue;
+
+    double divergence = entry->getShadowDivergence ((unsigned int) p->getParameter ("ADAPTIVE_MIN_SAMPLES"));
+    entry->resetShadowStats ();
+
+    if(divergence > splitThreshold && used + 1 < budget)
+    {
+      SAF_LOG_DEBUG("Splitting entry " << me->getName () << " divergence=" << divergence);
+      entry->setSplit (true);
+      used++; // the entry is replaced by at least two children
+    }
+  }
+}
+
+double SAFEngine::determineChildDistance(boost::shared_ptr<SAFEntry> entry)
+{
+  std::map<int /*faceId x layer*/, std::pair<double /*min*/, double /*max*/> > range;
+  int layers = (int) ParameterConfiguration::getInstance ()->getParameter ("MAX_LAYERS");
+  double distance = 0.0;
+
+  //children start with the table of the parent, they are compared once they have learned on their own
+  if(entry->getChildren ().size () < 2)
+    return -1;
+
+  for(std::set<nfd::Name>::iterator it = entry->getChildren ().begin (); it != entry->getChildren ().end (); ++it)
+  {
+    boost::shared_ptr<SAFEntry> child = lookUpEntry(*it);
+    if(!child) // expired in the measurements table
+      continue;
+
+    if(child->isSplit ()) // merge bottom up
+      return -1;
+
+    if(child->getSamples () < ParameterConfiguration::getInstance ()->getParameter ("ADAPTIVE_MIN_SAMPLES"))
+      return -1;
+
+    for(int layer = 0; layer < layers; layer++)
+    {
+      for(std::vector<int>::iterator f = faces.begin (); f != faces.end (); ++f)
+      {
+        double prob = child->getForwardingTable ()->getForwardingProbability (*f, layer);
+        int key = (*f) * layers + layer;
+        if(range.find (key) == range.end ())
+          range[key] = std::make_pair(prob, prob);
+        else
+        {
+          range[key].first = std::min(range[key].first, prob);
+          range[key].second = std::max(range[key].second, prob);
+        }
+        distance = std::max(distance, range[key].second - range[key].first);
+      }
+    }
+  }
+  return distance;
+}
+
+void SAFEngine::mergeEntry(const nfd::Name& prefix)
+{
+  boost::shared_ptr<SAFEntry> entry = lookUpEntry(prefix);
+  if(!entry)
+    return;
+
+  SAF_LOG_DEBUG("Merging children of entry " << prefix);
+  for(std::set<nfd::Name>::iterator c = entry->getChildren ().begin (); c != entry->getChildren ().end (); ++c)
+  {
+    //the measurements entry itself is removed by the table once it expires
+    shared_ptr<measurements::Entry> me = measurements.findExactMatch (*c);
+    if(me != NULL)
+      me->clearStrategyInfo ();
+  }
+
+  entry->getChildren ().clear ();
+  entry->setSplit (false);
+}
+
 bool SAFEngine::tryForwardInterest(const Interest& interest, shared_ptr<Face> outFace)
 {
-  if( dynamic_cast<ns3::ndn::NetDeviceFace*>(&(*outFace)) == NULL) //check if its a NetDevice
+  if(!SAFPlatform::getInstance ()->isNetworkFace (*outFace)) //check if its a NetDevice
   {
     return true;
   }
 
-  std::string prefix = extractContentPrefix(interest.getName());
-  SAFEntryMap::iterator it = entryMap.find (prefix);
-  if(it == entryMap.end ())
+  //the buckets are created with the entry, but also exist for prefixes whose entry could not be kept
+  FaceLimitMap::iterator it = fbMap.find (outFace->getId ());
+  if(it == fbMap.end () || !it->second->hasPrefix(extractContentPrefix(interest.getName())))
   {
     fprintf(stderr,"Error in SAFEntryLookUp\n");
     return false;
   }
-  else
-  {
-    return fbMap[outFace->getId ()]->tryForwardInterest(prefix);
-  }
+  return it->second->tryForwardInterest(extractContentPrefix(interest.getName()));
 }
 
 void SAFEngine::update ()
 {
-  NS_LOG_DEBUG("\nFWT UPDATE at SimTime " << ns3::Simulator::Now ().GetSeconds () << " for Node: '" << nodeName);
-  for(SAFEntryMap::iterator it = entryMap.begin (); it != entryMap.end (); ++it)
+  SAF_LOG_DEBUG("\nFWT UPDATE at SimTime " << SAFPlatform::getInstance ()->now () << " for Node: '" << nodeName);
+  pruneEntries();
+  for(SAFEntryList::iterator it = entries.begin (); it != entries.end (); ++it)
   {
-    NS_LOG_DEBUG("Updating Prefix " << it->first);
-    it->second->update();
+    shared_ptr<measurements::Entry> me = it->lock ();
+    SAF_LOG_DEBUG("Updating Prefix " << me->getName ());
+    me->getStrategyInfo<SAFStrategyInfo>()->entry->update();
   }
 
-  updateEventFWT = ns3::Simulator::Schedule(
-        ns3::Seconds(ParameterConfiguration::getInstance ()->getParameter ("UPDATE_INTERVALL")), &SAFEngine::update, this);
+  adaptGranularity();
+
+  updateEventFWT = SAFPlatform::getInstance ()->schedule(
+        ParameterConfiguration::getInstance ()->getParameter ("UPDATE_INTERVALL"), boost::bind(&SAFEngine::update, this));
+}
+
+void SAFEngine::logForwardedInterest(shared_ptr<pit::Entry> pitEntry, int face_id)
+{
+  SAFSendTimes::stamp (pitEntry, face_id, SAFPlatform::getInstance ()->now ());
 }
 
 void SAFEngine::logSatisfiedInterest(shared_ptr<pit::Entry> pitEntry,const Face& inFace, const Data& data)
 {
-  std::string prefix = extractContentPrefix(pitEntry->getName());
-  SAFEntryMap::iterator it = entryMap.find (prefix);
-  if(it == entryMap.end ())
-    fprintf(stderr,"Error in SAFEntryLookUp\n");
+  boost::shared_ptr<SAFEntry> entry = findEntry(pitEntry->getName());
+  if(!entry)
+    SAF_LOG_DEBUG("No entry for " << pitEntry->getName ()); // expired, or outside the namespace of the strategy
   else
-    it->second->logSatisfiedInterest(pitEntry,inFace,data);
+    entry->logSatisfiedInterest(pitEntry,inFace,data);
 }
 
 void SAFEngine::logExpiredInterest(shared_ptr< pit::Entry > pitEntry)
 {
-  std::string prefix = extractContentPrefix(pitEntry->getName());
-  SAFEntryMap::iterator it = entryMap.find (prefix);
-  if(it == entryMap.end ())
-    fprintf(stderr,"Error in SAFEntryLookUp\n");
+  boost::shared_ptr<SAFEntry> entry = findEntry(pitEntry->getName());
+  if(!entry)
+    SAF_LOG_DEBUG("No entry for " << pitEntry->getName ()); // expired, or outside the namespace of the strategy
   else
-    it->second->logExpiredInterest(pitEntry);
+    entry->logExpiredInterest(pitEntry);
 }
 
 void SAFEngine::logNack(const Face& inFace, const Interest& interest)
@@ -115,11 +591,11 @@ void SAFEngine::logNack(const Face& inFace, const Interest& interest)
 
   //log the nack
   std::string prefix = extractContentPrefix(interest.getName());
-  SAFEntryMap::iterator it = entryMap.find (prefix);
-  if(it == entryMap.end ())
-    fprintf(stderr,"Error in SAFEntryLookUp\n");
+  boost::shared_ptr<SAFEntry> entry = findEntry(interest.getName());
+  if(!entry)
+    SAF_LOG_DEBUG("No entry for " << interest.getName ()); // expired, or outside the namespace of the strategy
   else
-    it->second->logNack(inFace, interest);
+    entry->logNack(inFace, interest);
 
   //return the token?
   FaceLimitMap::iterator i = fbMap.find (inFace.getId ());
@@ -129,22 +605,62 @@ void SAFEngine::logNack(const Face& inFace, const Interest& interest)
     fbMap[inFace.getId ()]->receivedNack(prefix);
 }
 
+void SAFEngine::logDropProbability(const Face& inFace, const Interest& interest, double dropProbability)
+{
+  boost::shared_ptr<SAFEntry> entry = findEntry(interest.getName());
+  if(!entry)
+    SAF_LOG_DEBUG("No entry for " << interest.getName ()); // expired, or outside the namespace of the strategy
+  else
+    entry->logDropProbability(inFace, interest, dropProbability);
+}
+
+double SAFEngine::getDropProbability(const Interest& interest)
+{
+  boost::shared_ptr<SAFEntry> entry = findEntry(interest.getName());
+  if(!entry)
+    return 0.0;
+  return entry->getDropProbability(interest);
+}
+
 void SAFEngine::logRejectedInterest(shared_ptr<pit::Entry> pitEntry, int face_id)
 {
-  std::string prefix = extractContentPrefix(pitEntry->getName());
-  SAFEntryMap::iterator it = entryMap.find (prefix);
-  if(it == entryMap.end ())
-    fprintf(stderr,"Error in SAFEntryLookUp\n");
+  boost::shared_ptr<SAFEntry> entry = findEntry(pitEntry->getName());
+  if(!entry)
+    SAF_LOG_DEBUG("No entry for " << pitEntry->getName ()); // expired, or outside the namespace of the strategy
   else
-    it->second->logRejectedInterest(pitEntry, face_id);
+    entry->logRejectedInterest(pitEntry, face_id);
+}
+
+boost::shared_ptr<SAFEntry> SAFEngine::createEntry(const nfd::Name& name, unsigned int component, shared_ptr<fib::Entry> fibEntry)
+{
+  boost::shared_ptr<SAFEntry> parent;
+
+  //in hierarchical mode each entry has a parent at the next shorter prefix
+  if(component > 0 && ParameterConfiguration::getInstance ()->getParameter ("HIERARCHICAL_SAMPLE_THRESHOLD") > 0)
+  {
+    nfd::Name parentPrefix = name.getPrefix(component);
+    parent = lookUpEntry(parentPrefix);
+    if(!parent)
+    {
+      parent = createEntry(name, component - 1, fibEntry);
+      insertEntry(parentPrefix, parent);
+    }
+  }
+
+  return boost::shared_ptr<SAFEntry>(new SAFEntry(faces, fibEntry, extractContentPrefix(name, component), parent));
 }
 
 std::string SAFEngine::extractContentPrefix(nfd::Name name)
+{
+  return extractContentPrefix(name, prefixComponentNumber);
+}
+
+std::string SAFEngine::extractContentPrefix(const nfd::Name& name, unsigned int component)
 {
   //fprintf(stderr, "extracting from %s\n", name.toUri ().c_str ());
 
   std::string prefix = "";
-  for(unsigned int i=0; i <= prefixComponentNumber; i++)
+  for(unsigned int i=0; i <= component; i++)
   {
     prefix.append ("/");
     prefix.append (name.get (i).toUri ());
@@ -154,15 +670,9 @@ std::string SAFEngine::extractContentPrefix(nfd::Name name)
 
 void SAFEngine::determineNodeName(const nfd::FaceTable& table)
 {
-  for(nfd::FaceTable::const_iterator it = table.begin (); it != table.end (); ++it)
-  {
-    if(ns3::ndn::NetDeviceFace* netf = dynamic_cast<ns3::ndn::NetDeviceFace*>(&(*(*it))))
-    {
-      nodeName = ns3::Names::FindName(netf->GetNetDevice()->GetNode());
-      return;
-    }
-  }
-  nodeName = "UnknownNode";
+  nodeName = SAFPlatform::getInstance ()->getNodeName (table);
+  if(nodeName.empty ())
+    nodeName = "UnknownNode";
 }
 
 void SAFEngine::addFace(shared_ptr<Face> face)
@@ -178,13 +688,15 @@ void SAFEngine::addFace(shared_ptr<Face> face)
     registeredPrefixes = fbMap.begin ()->second->getAllRegisteredPrefixs();
   }
   fbMap[face->getId()] = boost::shared_ptr<FaceLimitManager>(new FaceLimitManager(face));
+  faceIdentities[face->getId()] = determineFaceIdentity(face);
   for(unsigned int i=0; i < registeredPrefixes.size (); i++)
     fbMap[face->getId()]->addNewPrefix(registeredPrefixes.at (i));
 
   std::sort(faces.begin(), faces.end());
-  for(SAFEntryMap::iterator it = entryMap.begin (); it != entryMap.end (); ++it)
+  pruneEntries();
+  for(SAFEntryList::iterator it = entries.begin (); it != entries.end (); ++it)
   {
-    it->second->addFace(face);
+    it->lock ()->getStrategyInfo<SAFStrategyInfo>()->entry->addFace(face);
   }
 }
 
@@ -193,13 +705,15 @@ void SAFEngine::removeFace(shared_ptr<Face> face)
   if(face->getId() <= nfd::FACEID_RESERVED_MAX) //SAF is not used for management faces
     return;
 
-  for(SAFEntryMap::iterator it = entryMap.begin (); it != entryMap.end (); ++it)
+  pruneEntries();
+  for(SAFEntryList::iterator it = entries.begin (); it != entries.end (); ++it)
   {
-    it->second->removeFace(face);
+    it->lock ()->getStrategyInfo<SAFStrategyInfo>()->entry->removeFace(face);
   }
 
   faces.erase(std::find(faces.begin (), faces.end (), face->getId()));
   fbMap.erase (face->getId());
+  faceIdentities.erase (face->getId());
   std::sort(faces.begin(), faces.end());
 
 }
@@ -19,32 +19,51 @@
 #define SAFENGINE_H
 
 #include "fw/face-table.hpp"
-#include "ns3/event-id.h"
+#include "fw/strategy-info.hpp"
+#include "table/measurements-accessor.hpp"
 #include <vector>
 #include "limits/facelimitmanager.h"
-#include "ns3/names.h"
-#include "ns3/log.h"
+#include <boost/lexical_cast.hpp>
+#include "platform/safplatform.h"
+#include <boost/bind.hpp>
 #include "safentry.h"
+#include "safsnapshot.h"
+#include "../utils/checkpoint.h"
 
 namespace nfd
 {
 namespace fw
 {
 
+/**
+ * @brief The SAFStrategyInfo class attaches a SAFEntry to the measurements entry of its prefix.
+ */
+class SAFStrategyInfo : public StrategyInfo
+{
+public:
+  SAFStrategyInfo(boost::shared_ptr<SAFEntry> entry) : entry(entry) {}
+
+  boost::shared_ptr<SAFEntry> entry;
+  time::steady_clock::TimePoint expiry; /*expiry of the measurements entry as last extended by the engine*/
+};
+
 /**
  * @brief The SAFEngine class is the forwarding engine for SAF.
  * It manages multiple FWT as it considers different contents and for each content different layers.
  */
-class SAFEngine
+class SAFEngine : public Checkpointable
 {
 public:
 
   /**
    * @brief creates a new SAF enginem
    * @param table all faces of the current node
+   * @param measurements the measurements table of the strategy, the entries are stored as its strategy info
    * @param prefixComponentNumber the number of name components that specify a distinct content/prefix.
    */
-  SAFEngine(const nfd::FaceTable& table, unsigned int prefixComponentNumber);
+  SAFEngine(const nfd::FaceTable& table, MeasurementsAccessor& measurements, unsigned int prefixComponentNumber);
+
+  virtual ~SAFEngine();
 
   /**
    * @brief determines the next hop for a given interest.
@@ -62,6 +81,13 @@ public:
    */
   bool tryForwardInterest(const Interest& interest, shared_ptr<Face>);
 
+  /**
+   * @brief logs that the interest of a pit entry has been sent on a face, the time is taken from the platform clock.
+   * @param pitEntry the corresponding pit-entry
+   * @param face_id the id of the face the interest was sent on
+   */
+  void logForwardedInterest(shared_ptr<pit::Entry> pitEntry, int face_id);
+
   /**
    * @brief logs a satisfied interest.
    * @param pitEntry the corresponding pit-entry
@@ -90,6 +116,21 @@ public:
    */
   void logRejectedInterest(shared_ptr<pit::Entry> pitEntry, int face_id);
 
+  /**
+   * @brief logs the drop probability reported by an upstream node.
+   * @param inFace the face that received the feedback
+   * @param interest the interest the feedback belongs to
+   * @param dropProbability the drop probability of the upstream node
+   */
+  void logDropProbability(const Face& inFace, const Interest& interest, double dropProbability);
+
+  /**
+   * @brief provides the drop probability of the current node for the prefix and layer of an interest.
+   * @param interest the interest
+   * @return the drop probability, 0 if the prefix is unknown.
+   */
+  double getDropProbability(const Interest& interest);
+
   /**
    * @brief addFace
    * @param face
@@ -102,20 +143,96 @@ public:
    */
   void removeFace(shared_ptr<Face> face);
 
+  /**
+   * @brief checkpoints the limiters and all entries of the node.
+   * Entries of a loaded checkpoint are restored when they are created again.
+   */
+  virtual std::string getCheckpointKey(){return "SAF/" + nodeName;}
+  virtual void saveCheckpoint(std::ostream& os);
+  virtual void loadCheckpoint(std::istream& is);
+
 protected:
   void initFaces(const nfd::FaceTable& table);
   std::string extractContentPrefix(nfd::Name name);
+  std::string extractContentPrefix(const nfd::Name& name, unsigned int component);
+  boost::shared_ptr<SAFEntry> createEntry(const nfd::Name& name, unsigned int component, shared_ptr<fib::Entry> fibEntry);
+
+  /**
+   * @brief provides the entry stored for exactly the given prefix.
+   * @return the entry, NULL if there is none.
+   */
+  boost::shared_ptr<SAFEntry> lookUpEntry(const nfd::Name& prefix);
+
+  /**
+   * @brief stores an entry as strategy info of the measurements entry of the given prefix.
+   * @return false if the prefix is outside the namespace of the strategy, the entry is not kept then.
+   */
+  bool insertEntry(const nfd::Name& prefix, boost::shared_ptr<SAFEntry> entry);
+
+  /**
+   * @brief keeps the measurements entries of a prefix and its parent prefixes alive.
+   */
+  void extendLifetime(const nfd::Name& prefix);
+
+  /**
+   * @brief drops expired measurements entries and entries that no longer hold SAF state.
+   */
+  void pruneEntries();
+
+  /**
+   * @brief prunes the entries and counts those within ADAPTIVE_ENTRY_BUDGET, the forwarding entries of the
+   * adaptive granularity (split entries and hierarchical parents are not counted).
+   */
+  size_t countBudgetEntries();
+
+  /**
+   * @brief whether the given number of entries can be added without exceeding ADAPTIVE_ENTRY_BUDGET.
+   */
+  bool isWithinEntryBudget(size_t additional);
+
+  /**
+   * @brief warm-starts a new entry from the snapshot, if it contains the prefix of the entry.
+   */
+  void restoreEntry(boost::shared_ptr<SAFEntry> entry);
+
+  /**
+   * @brief writes the learned state of all entries to the snapshot of the node, called each SNAPSHOT_INTERVAL.
+   */
+  void writeSnapshot();
+  std::string getSnapshotFile();
+
+  /**
+   * @brief identifies a face independent of its id, i.e., by the node at the other side of the link.
+   */
+  std::string determineFaceIdentity(shared_ptr<Face> face);
+
+  /**
+   * @brief finds the most specific entry of a name, following split entries.
+   * @param name the name
+   * @param fibEntry if set, missing children of split entries are created
+   * @return the entry, NULL if the content prefix is unknown.
+   */
+  boost::shared_ptr<SAFEntry> findEntry(const nfd::Name& name, shared_ptr<fib::Entry> fibEntry = shared_ptr<fib::Entry>());
+
+  /**
+   * @brief splits entries whose child prefixes diverge and merges children that behave identically.
+   */
+  void adaptGranularity();
+  double determineChildDistance(boost::shared_ptr<SAFEntry> entry);
+  void mergeEntry(const nfd::Name& prefix);
   void determineNodeName(const nfd::FaceTable& table);
   std::vector<int> faces;
 
   void update();
 
-  typedef std::map
-    < std::string, /*content-prefix*/
-      boost::shared_ptr<SAFEntry> /*forwarding prob. table*/
-    > SAFEntryMap;
+  MeasurementsAccessor& measurements;
+  time::seconds entryLifetime;
 
-  SAFEntryMap entryMap;
+  typedef std::vector
+    < weak_ptr<measurements::Entry> /*content-prefix, in hierarchical mode also the shorter (parent) prefixes*/
+    > SAFEntryList;
+
+  SAFEntryList entries; // for the periodic update, lookups use the measurements table
 
   typedef std::map
     < int, /*face ID*/
@@ -124,7 +241,16 @@ protected:
 
   FaceLimitMap fbMap;
 
-  ns3::EventId updateEventFWT;
+  SAFPlatform::TimerId updateEventFWT;
+  SAFPlatform::TimerId snapshotEvent;
+  bool outsideNamespaceReported; /*prefixes outside the namespace of the strategy are reported once*/
+  size_t budgetEntries; /*entries within the budget at the last count, plus the children created since*/
+  double budgetCountedAt; /*platform time of the last count*/
+
+  boost::shared_ptr<SAFSnapshot> snapshot;
+  std::map<int /*face ID*/, std::string /*identity*/> faceIdentities;
+
+  std::map<nfd::Name /*prefix*/, std::string /*state*/> pendingCheckpoint; /*entries of a loaded checkpoint not created yet*/
 
   unsigned int prefixComponentNumber;
   std::string nodeName;
@@ -3,15 +3,34 @@
 using namespace nfd;
 using namespace nfd::fw;
 
-SAFEntry::SAFEntry(std::vector<int> faces, shared_ptr<fib::Entry> fibEntry, std::string prefix)
+SAFEntry::SAFEntry(std::vector<int> faces, shared_ptr<fib::Entry> fibEntry, std::string prefix, boost::shared_ptr<SAFEntry> parent)
 {
   this->fibEntry = fibEntry;
   this->faces = faces;
+  this->parent = parent;
+  this->prefix = prefix;
+  randomVariable = SAFPlatform::getInstance ()->createRandomStream ();
   initFaces();
 
   smeasure = SAFMeasureFactory::getInstance ()->getMeasure (prefix, faces);
-  ftable = boost::shared_ptr<SAFForwardingTable>(new SAFForwardingTable(this->faces, this->preferedFaces));
+
+  //a new prefix under an already learned namespace starts with the table of its parent instead of the fib costs
+  if(parent && parent->getSamples () >= ParameterConfiguration::getInstance ()->getParameter ("HIERARCHICAL_SAMPLE_THRESHOLD"))
+    ftable = boost::shared_ptr<SAFForwardingTable>(new SAFForwardingTable(*(parent->ftable)));
+  else
+    ftable = boost::shared_ptr<SAFForwardingTable>(new SAFForwardingTable(this->faces, this->preferedFaces));
+
   fallbackCounter = 0;
+  samples = 0;
+  splittable = false;
+  split = false;
+  component = 0;
+}
+
+void SAFEntry::setSplittable(unsigned int component)
+{
+  this->splittable = true;
+  this->component = component;
 }
 
 void SAFEntry::initFaces ()
@@ -30,6 +49,14 @@ void SAFEntry::initFaces ()
 
 int SAFEntry::determineNextHop(const Interest& interest, std::vector<int> alreadyTriedFaces)
 {
+  //as long as there are not enough samples, decisions are blended with the parent: P(parent) = 1 - samples/threshold
+  if(parent)
+  {
+    double threshold = ParameterConfiguration::getInstance ()->getParameter ("HIERARCHICAL_SAMPLE_THRESHOLD");
+    if(samples < threshold && randomVariable->getValue () * threshold >= samples)
+      return parent->determineNextHop (interest, alreadyTriedFaces);
+  }
+
   return ftable->determineNextHop (interest,alreadyTriedFaces);
 }
 
@@ -37,7 +64,9 @@ void SAFEntry::update()
 {
   smeasure->update(ftable->getCurrentReliability ());
   ftable->update (smeasure);
-  //ftable->crossLayerAdaptation (smeasure);
+
+  if(ParameterConfiguration::getInstance ()->getParameter ("CONTENT_AWARE_ADAPTATION") > 0)
+    ftable->crossLayerAdaptation (smeasure);
 
   /*if(!evaluateFallback())
     ftable->update (smeasure);
@@ -48,21 +77,110 @@ void SAFEntry::update()
 void SAFEntry::logSatisfiedInterest(shared_ptr<pit::Entry> pitEntry,const Face& inFace, const Data& data)
 {
   smeasure->logSatisfiedInterest (pitEntry,inFace,data);
+  samples++;
+
+  if(splittable && !split)
+    logShadow (pitEntry->getName (), inFace.getId (), true);
+
+  //the parent learns from the traffic of all its children
+  if(parent)
+    parent->logSatisfiedInterest (pitEntry, inFace, data);
 }
 
 void SAFEntry::logExpiredInterest(shared_ptr< pit::Entry > pitEntry)
 {
   smeasure->logExpiredInterest (pitEntry);
+  samples++;
+
+  if(splittable && !split)
+  {
+    const nfd::pit::OutRecordCollection& records = pitEntry->getOutRecords();
+    for(nfd::pit::OutRecordCollection::const_iterator it = records.begin (); it!=records.end (); ++it)
+      logShadow (pitEntry->getName (), (*it).getFace()->getId(), false);
+  }
+
+  if(parent)
+    parent->logExpiredInterest (pitEntry);
 }
 
 void SAFEntry::logNack(const Face& inFace, const Interest& interest)
 {
   smeasure->logNack (inFace, interest);
+
+  if(parent)
+    parent->logNack (inFace, interest);
 }
 
 void SAFEntry::logRejectedInterest(shared_ptr<pit::Entry> pitEntry, int face_id)
 {
   smeasure->logRejectedInterest(pitEntry, face_id);
+
+  if(parent)
+    parent->logRejectedInterest (pitEntry, face_id);
+}
+
+void SAFEntry::logDropProbability(const Face& inFace, const Interest& interest, double dropProbability)
+{
+  ftable->logDropProbability (inFace.getId (), SAFStatisticMeasure::determineContentLayer(interest), dropProbability);
+}
+
+double SAFEntry::getDropProbability(const Interest& interest)
+{
+  return ftable->getDropProbability (SAFStatisticMeasure::determineContentLayer(interest));
+}
+
+void SAFEntry::logShadow(const Name& name, int faceId, bool satisfied)
+{
+  //the last component is the segment number, entries are never split by it
+  if(component + 2 >= name.size ())
+    return;
+
+  const name::Component& child = name.get (component + 1);
+  ShadowStatsMap::iterator it = shadows.find (child);
+  if(it == shadows.end ())
+  {
+    if(shadows.size () >= MAX_SHADOW_CHILDREN)
+      return;
+    it = shadows.insert (std::make_pair(child, std::map<int, std::pair<unsigned int, unsigned int> >())).first;
+  }
+
+  std::pair<unsigned int, unsigned int>& stats = it->second[faceId];
+  if(satisfied)
+    stats.first++;
+  stats.second++;
+}
+
+double SAFEntry::getShadowDivergence(unsigned int minSamples)
+{
+  std::map<int, double> minReliability;
+  std::map<int, double> maxReliability;
+
+  for(ShadowStatsMap::iterator it = shadows.begin (); it != shadows.end (); ++it)
+  {
+    for(std::map<int, std::pair<unsigned int, unsigned int> >::iterator f = it->second.begin (); f != it->second.end (); ++f)
+    {
+      if(f->second.second < minSamples)
+        continue;
+
+      double reliability = (double) f->second.first / (double) f->second.second;
+      if(minReliability.find (f->first) == minReliability.end ())
+      {
+        minReliability[f->first] = reliability;
+        maxReliability[f->first] = reliability;
+      }
+      else
+      {
+        minReliability[f->first] = std::min(minReliability[f->first], reliability);
+        maxReliability[f->first] = std::max(maxReliability[f->first], reliability);
+      }
+    }
+  }
+
+  double divergence = 0.0;
+  for(std::map<int, double>::iterator it = minReliability.begin (); it != minReliability.end (); ++it)
+    divergence = std::max(divergence, maxReliability[it->first] - it->second);
+
+  return divergence;
 }
 
 bool SAFEntry::evaluateFallback()
@@ -119,3 +237,32 @@ void SAFEntry::removeFace(shared_ptr<Face> face)
   smeasure->removeFace (face);
   //pthread_mutex_unlock( &mutex);
 }
+
+void SAFEntry::saveCheckpoint(std::ostream& os)
+{
+  std::vector<std::string> childUris;
+  for(std::set<nfd::Name>::iterator it = children.begin (); it != children.end (); ++it)
+    childUris.push_back (it->toUri ());
+
+  checkpoint::write(os, samples);
+  checkpoint::write(os, split);
+  checkpoint::write(os, childUris);
+  ftable->saveCheckpoint (os);
+  smeasure->saveCheckpoint (os);
+}
+
+void SAFEntry::loadCheckpoint(std::istream& is)
+{
+  std::vector<std::string> childUris;
+  checkpoint::read(is, samples);
+  checkpoint::read(is, split);
+  checkpoint::read(is, childUris);
+
+  //children are created again on demand, and restored from the checkpoint then
+  children.clear ();
+  for(std::vector<std::string>::iterator it = childUris.begin (); it != childUris.end (); ++it)
+    children.insert (nfd::Name(*it));
+
+  ftable->loadCheckpoint (is);
+  smeasure->loadCheckpoint (is);
+}
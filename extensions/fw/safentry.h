@@ -22,6 +22,9 @@
 #include "safforwardingtable.h"
 #include "fw/strategy.hpp"
 #include "safmeasurefactory.h"
+#include <set>
+
+#define MAX_SHADOW_CHILDREN 16
 
 namespace nfd
 {
@@ -40,8 +43,11 @@ public:
    * @brief creates a new entry for given faces and a corresponding fibEntry.
    * @param faces the faces
    * @param fibEntry the fib-entry
+   * @param prefix the prefix of the entry
+   * @param parent the entry of the next shorter prefix, used until this entry has enough samples (hierarchical mode)
    */
-  SAFEntry(std::vector<int> faces, shared_ptr<fib::Entry> fibEntry, std::string prefix);
+  SAFEntry(std::vector<int> faces, shared_ptr<fib::Entry> fibEntry, std::string prefix,
+           boost::shared_ptr<SAFEntry> parent = boost::shared_ptr<SAFEntry>());
 
   /**
    * @brief determines the next hop for an interest
@@ -79,11 +85,87 @@ public:
    */
   void logRejectedInterest(shared_ptr<pit::Entry> pitEntry, int face_id);
 
+  /**
+   * @brief logs the drop probability reported by an upstream node.
+   * @param inFace the face that received the feedback
+   * @param interest the interest the feedback belongs to
+   * @param dropProbability the drop probability of the upstream node
+   */
+  void logDropProbability(const Face& inFace, const Interest& interest, double dropProbability);
+
+  /**
+   * @brief provides the drop probability for the layer of an interest.
+   * @param interest the interest
+   * @return
+   */
+  double getDropProbability(const Interest& interest);
+
   /**
    * @brief trigges a update for the current entry. Called at the end of each period.
    */
   void update();
 
+  /**
+   * @brief the entry of the next shorter prefix, NULL if there is none.
+   */
+  boost::shared_ptr<SAFEntry> getParent(){return parent;}
+
+  /**
+   * @brief the number of interests this entry (or its children) has seen satisfied or expired.
+   */
+  unsigned int getSamples(){return samples;}
+
+  /**
+   * @brief provides the forwarding table of the entry.
+   */
+  boost::shared_ptr<SAFForwardingTable> getForwardingTable(){return ftable;}
+
+  /**
+   * @brief provides the statistic measure of the entry.
+   */
+  boost::shared_ptr<SAFStatisticMeasure> getStatisticMeasure(){return smeasure;}
+
+  /**
+   * @brief the prefix of the entry.
+   */
+  std::string getPrefix(){return prefix;}
+
+  /**
+   * @brief writes/restores the state of the entry, i.e., its table, statistics, samples and split state.
+   */
+  void saveCheckpoint(std::ostream& os);
+  void loadCheckpoint(std::istream& is);
+
+  /**
+   * @brief enables shadow statistics for the child prefixes of this entry (adaptive prefix granularity).
+   * @param component the index of the last name component of the entry's prefix
+   */
+  void setSplittable(unsigned int component);
+  bool isSplittable(){return splittable;}
+
+  /**
+   * @brief split entries forward via entries of their child prefixes.
+   */
+  bool isSplit(){return split;}
+  void setSplit(bool split){this->split = split;}
+
+  /**
+   * @brief the prefixes of the child entries created since the entry has been split.
+   */
+  std::set<nfd::Name>& getChildren(){return children;}
+
+  /**
+   * @brief determines how much the reliabilities of the child prefixes diverge.
+   * @param minSamples the samples a child prefix needs on a face to be considered
+   * @return the max. difference of the reliabilities of a face among the child prefixes.
+   */
+  double getShadowDivergence(unsigned int minSamples);
+
+  /**
+   * @brief clears the shadow statistics, called at the end of each period.
+   */
+  void resetShadowStats(){shadows.clear ();}
+
   /**
    * @brief addFace
    * @param face
@@ -100,10 +182,12 @@ protected:
 
   void initFaces();
   bool evaluateFallback();
+  void logShadow(const Name& name, int faceId, bool satisfied);
 
   boost::shared_ptr<SAFStatisticMeasure> smeasure;
   boost::shared_ptr<SAFForwardingTable> ftable;
 
+  std::string prefix;
   std::vector<int> faces;
   typedef std::map<
   int/*faceId*/,
@@ -113,6 +197,21 @@ protected:
   shared_ptr<fib::Entry> fibEntry;
 
   int fallbackCounter;
+
+  boost::shared_ptr<SAFEntry> parent;
+  unsigned int samples;
+  boost::shared_ptr<SAFRandomStream> randomVariable;
+
+  bool splittable;
+  bool split;
+  unsigned int component;
+  std::set<nfd::Name> children;
+
+  typedef std::map<
+  name::Component /*next component of the name*/,
+  std::map<int /*faceId*/, std::pair<unsigned int /*satisfied*/, unsigned int /*total*/> >
+  > ShadowStatsMap;
+  ShadowStatsMap shadows;
 };
 
 }
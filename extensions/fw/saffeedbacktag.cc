@@ -0,0 +1,83 @@
+#include "saffeedbacktag.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/ndnSIM/utils/ndn-ns3-packet-tag.hpp"
+
+using namespace nfd;
+using namespace nfd::fw;
+
+NS_OBJECT_ENSURE_REGISTERED(SAFFeedbackTag);
+
+ns3::TypeId SAFFeedbackTag::GetTypeId()
+{
+  static ns3::TypeId tid = ns3::TypeId("nfd::fw::SAFFeedbackTag")
+                             .SetParent<ns3::Tag>()
+                             .AddConstructor<SAFFeedbackTag>();
+  return tid;
+}
+
+SAFFeedbackTag::SAFFeedbackTag(double dropProbability, uint32_t origin)
+{
+  this->dropProbability = dropProbability;
+  this->origin = origin;
+}
+
+bool SAFFeedbackTag::getDropProbability(const ndn::TagHost& packet, double& dropProbability)
+{
+  auto ns3PacketTag = packet.getTag<ns3::ndn::Ns3PacketTag>();
+  if(ns3PacketTag == nullptr)
+    return false;
+
+  SAFFeedbackTag tag;
+  if(!ns3PacketTag->getPacket()->PeekPacketTag(tag))
+    return false;
+
+  // events of a node run in the context of its node id
+  if(tag.getOrigin () == ns3::Simulator::GetContext ())
+    return false;
+
+  dropProbability = tag.getDropProbability ();
+  return true;
+}
+
+void SAFFeedbackTag::setDropProbability(const ndn::TagHost& packet, double dropProbability)
+{
+  ns3::Ptr<ns3::Packet> p;
+  auto ns3PacketTag = packet.getTag<ns3::ndn::Ns3PacketTag>();
+  if(ns3PacketTag == nullptr)
+    p = ns3::Create<ns3::Packet>();
+  else
+    p = ns3PacketTag->getPacket()->Copy(); // keep the other tags (e.g. hop count)
+
+  SAFFeedbackTag old;
+  p->RemovePacketTag(old);
+  p->AddPacketTag(SAFFeedbackTag(dropProbability, ns3::Simulator::GetContext ()));
+  packet.setTag(std::make_shared<ns3::ndn::Ns3PacketTag>(p));
+}
+
+ns3::TypeId SAFFeedbackTag::GetInstanceTypeId() const
+{
+  return SAFFeedbackTag::GetTypeId();
+}
+
+uint32_t SAFFeedbackTag::GetSerializedSize() const
+{
+  return sizeof(double) + sizeof(uint32_t);
+}
+
+void SAFFeedbackTag::Serialize(ns3::TagBuffer i) const
+{
+  i.WriteDouble(dropProbability);
+  i.WriteU32(origin);
+}
+
+void SAFFeedbackTag::Deserialize(ns3::TagBuffer i)
+{
+  dropProbability = i.ReadDouble();
+  origin = i.ReadU32();
+}
+
+void SAFFeedbackTag::Print(std::ostream& os) const
+{
+  os << "DropProbability=" << dropProbability << " Origin=" << origin;
+}
@@ -0,0 +1,71 @@
+/**
+ * Copyright (c) 2015 Daniel Posch (Alpen-Adria Universität Klagenfurt)
+ *
+ * This file is part of the ndnSIM extension for Stochastic Adaptive Forwarding (SAF).
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef SAFFEEDBACKTAG_H
+#define SAFFEEDBACKTAG_H
+
+#include "ns3/tag.h"
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+namespace nfd
+{
+namespace fw
+{
+
+/**
+ * @brief The SAFFeedbackTag class piggybacks the drop probability of an upstream SAF node on Data and NACK packets.
+ * The tag remembers the node that attached it, so a node never takes its own feedback for feedback of its upstream.
+ */
+class SAFFeedbackTag : public ns3::Tag
+{
+public:
+  static ns3::TypeId GetTypeId(void);
+
+  SAFFeedbackTag(double dropProbability = 0.0, uint32_t origin = 0);
+
+  /**
+   * @brief reads the feedback of an upstream node from a packet.
+   * @param packet the Data or NACK
+   * @param dropProbability is set to the drop probability of the upstream node
+   * @return true if the packet carries feedback of another node, else false.
+   */
+  static bool getDropProbability(const ndn::TagHost& packet, double& dropProbability);
+
+  /**
+   * @brief attaches the drop probability of the current node to a packet, replacing previous feedback.
+   * @param packet the Data or NACK
+   * @param dropProbability the drop probability
+   */
+  static void setDropProbability(const ndn::TagHost& packet, double dropProbability);
+
+  double getDropProbability() const {return dropProbability;}
+  uint32_t getOrigin() const {return origin;}
+
+  virtual ns3::TypeId GetInstanceTypeId() const;
+  virtual uint32_t GetSerializedSize() const;
+  virtual void Serialize(ns3::TagBuffer i) const;
+  virtual void Deserialize(ns3::TagBuffer i);
+  virtual void Print(std::ostream& os) const;
+
+protected:
+  double dropProbability;
+  uint32_t origin; /*node id of the node that attached the feedback*/
+};
+
+}
+}
+#endif // SAFFEEDBACKTAG_H
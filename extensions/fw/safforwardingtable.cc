@@ -4,7 +4,7 @@ using namespace nfd;
 using namespace nfd::fw;
 using namespace boost::numeric::ublas;
 
-NS_LOG_COMPONENT_DEFINE("SAFForwardingTable");
+SAF_LOG_COMPONENT_DEFINE("SAFForwardingTable");
 
 SAFForwardingTable::SAFForwardingTable(std::vector<int> faceIds, std::map<int, int> preferedFacesIds)
 {
@@ -13,9 +13,17 @@ SAFForwardingTable::SAFForwardingTable(std::vector<int> faceIds, std::map<int, i
 
   this->faces = faceIds;
   this->preferedFaces = preferedFacesIds;
+  randomVariable = SAFPlatform::getInstance ()->createRandomStream ();
+  flowSalt = drawFlowSalt ();
   initTable ();
 }
 
+uint32_t SAFForwardingTable::drawFlowSalt()
+{
+  //not getInteger (0, UINT_MAX), ns-3 computes the interval as [min, max+1) which wraps to 0 here
+  return (uint32_t) (randomVariable->getValue () * 4294967296.0);
+}
+
 std::map<int, double> SAFForwardingTable::calcInitForwardingProb(std::map<int, int> preferedFacesIds, double gamma)
 {
   std::map<int, double> res;
@@ -152,7 +160,10 @@ int SAFForwardingTable::determineNextHop(const Interest& interest, std::vector<i
   }
 
   // choose one face as outgoing according to the probability
-  return chooseFaceAccordingProbability(tmp_matrix, ilayer, face_list);
+  if(ParameterConfiguration::getInstance ()->getParameter ("FLOW_STICKY") > 0)
+    return chooseFaceForFlow(tmp_matrix, ilayer, face_list, interest);
+
+  return chooseFaceAccordingProbability(tmp_matrix, ilayer, face_list, randomVariable->getValue ());
 }
 
 void SAFForwardingTable::update(boost::shared_ptr<SAFStatisticMeasure> stats)
@@ -161,11 +172,11 @@ void SAFForwardingTable::update(boost::shared_ptr<SAFStatisticMeasure> stats)
   std::vector<int> ur_faces; /*unreliable faces*/
   std::vector<int> p_faces;  /*probing faces*/
 
-  NS_LOG_DEBUG("FWT Before Update:\n" << table); /* prints matrix line by line ( (first line), (second line) )*/
+  SAF_LOG_DEBUG("FWT Before Update:\n" << table); /* prints matrix line by line ( (first line), (second line) )*/
 
   for(int layer = 0; layer < (int)ParameterConfiguration::getInstance ()->getParameter ("MAX_LAYERS"); layer++) // for each layer
   {
-    NS_LOG_DEBUG("Updating Layer[" << layer << "] with reliability_t=" << curReliability[layer]);
+    SAF_LOG_DEBUG("Updating Layer[" << layer << "] with reliability_t=" << curReliability[layer]);
 
     //determine the set of (un)reliable faces
     r_faces = stats->getReliableFaces (layer, curReliability[layer]);
@@ -184,15 +195,15 @@ void SAFForwardingTable::update(boost::shared_ptr<SAFStatisticMeasure> stats)
     }
 
     for(std::vector<int>::iterator it = r_faces.begin(); it != r_faces.end(); ++it)
-      NS_LOG_DEBUG("Reliable Face[" << *it << "]=" << stats->getFaceReliability(*it,layer)
+      SAF_LOG_DEBUG("Reliable Face[" << *it << "]=" << stats->getFaceReliability(*it,layer)
                    << "\t "<< stats->getForwardedInterests (*it,layer) << " interest forwarded");
     for(std::vector<int>::iterator it = ur_faces.begin(); it != ur_faces.end(); ++it)
-      NS_LOG_DEBUG("Unreliable Face[" << *it << "]=" << stats->getFaceReliability(*it,layer)
+      SAF_LOG_DEBUG("Unreliable Face[" << *it << "]=" << stats->getFaceReliability(*it,layer)
                    << "\t "<< stats->getForwardedInterests (*it,layer) << " interest forwarded");
     for(std::vector<int>::iterator it = p_faces.begin(); it != p_faces.end(); ++it)
-      NS_LOG_DEBUG("Probe Face[" << *it << "]=" << stats->getFaceReliability(*it,layer)
+      SAF_LOG_DEBUG("Probe Face[" << *it << "]=" << stats->getFaceReliability(*it,layer)
                    << "\t "<< stats->getForwardedInterests (*it,layer) << " interest forwarded");
-    NS_LOG_DEBUG("Drop Face[" << DROP_FACE_ID << "]=" << stats->getFaceReliability(DROP_FACE_ID,layer)
+    SAF_LOG_DEBUG("Drop Face[" << DROP_FACE_ID << "]=" << stats->getFaceReliability(DROP_FACE_ID,layer)
                  << "\t "<< stats->getForwardedInterests (DROP_FACE_ID,layer) << " interest forwarded");
 
     // ok treat the unreliable faces first...
@@ -204,13 +215,13 @@ void SAFForwardingTable::update(boost::shared_ptr<SAFStatisticMeasure> stats)
 
       if(utf_face <= table(determineRowOfFace (*it),layer))
       {
-        NS_LOG_DEBUG("Face[" << *it <<"]: Removing alpha[" << *it <<"]*UT[" << *it << "]="
+        SAF_LOG_DEBUG("Face[" << *it <<"]: Removing alpha[" << *it <<"]*UT[" << *it << "]="
                  << stats->getAlpha(*it, layer) << "*" << stats->getUT(*it, layer) << "=" << utf_face);
       }
       else
       {
         utf_face = table(determineRowOfFace (*it),layer);
-        NS_LOG_DEBUG("Face[" << *it <<"]: Removing all =" << utf_face);
+        SAF_LOG_DEBUG("Face[" << *it <<"]: Removing all =" << utf_face);
       }
 
       // remove traffic and store removed fraction
@@ -218,7 +229,7 @@ void SAFForwardingTable::update(boost::shared_ptr<SAFStatisticMeasure> stats)
       utf += utf_face;
     }
 
-    NS_LOG_DEBUG("Total UTF = " << utf);
+    SAF_LOG_DEBUG("Total UTF = " << utf);
 
     if(utf > 0)
     {
@@ -229,26 +240,26 @@ void SAFForwardingTable::update(boost::shared_ptr<SAFStatisticMeasure> stats)
         double ts_sum = 0.0;
         for(std::vector<int>::iterator it = r_faces.begin(); it != r_faces.end(); ++it) // for each r_face
         {
-          NS_LOG_DEBUG("Face[" << *it <<"]: getS() / curReliability[*it] = "
+          SAF_LOG_DEBUG("Face[" << *it <<"]: getS() / curReliability[*it] = "
                        << ((double)stats->getS (*it, layer)) << "/" << curReliability[layer]);
           ts[*it] = ((double)stats->getS (*it, layer)) / curReliability[layer];
           ts[*it] -= stats->getForwardedInterests (*it, layer);
           ts_sum += ts[*it];
-          NS_LOG_DEBUG("Face[" << *it <<"]: still can take " <<  ts[*it] << " more Interests");
+          SAF_LOG_DEBUG("Face[" << *it <<"]: still can take " <<  ts[*it] << " more Interests");
         }
-        NS_LOG_DEBUG("Total Interests that can be taken by F_R = " << ts_sum);
+        SAF_LOG_DEBUG("Total Interests that can be taken by F_R = " << ts_sum);
 
         // find the minium fraction that can be AND should be shifted
         double min_fraction = (ts_sum / (double) stats->getTotalForwardedInterests (layer));
         if(min_fraction > utf)
           min_fraction = utf;
 
-        NS_LOG_DEBUG("Total fraction that will be shifted to F_R= " << min_fraction);
+        SAF_LOG_DEBUG("Total fraction that will be shifted to F_R= " << min_fraction);
 
         //now shift traffic to r_faces
         for(std::vector<int>::iterator it = r_faces.begin(); it != r_faces.end(); ++it) // for each r_face
         {
-          NS_LOG_DEBUG("Face[" << *it <<"]: Adding (min_fraction*ts[" << *it << "]) / (ts_sum)="
+          SAF_LOG_DEBUG("Face[" << *it <<"]: Adding (min_fraction*ts[" << *it << "]) / (ts_sum)="
                      << "(" << min_fraction << "*" << ts[*it] << ") / (" <<
                      ts_sum << ")=" << (min_fraction * ts[*it]) / ts_sum );
 
@@ -259,7 +270,7 @@ void SAFForwardingTable::update(boost::shared_ptr<SAFStatisticMeasure> stats)
       }
 
       //set the remaining utf to the dropping face
-      NS_LOG_DEBUG("UTF remaining for the Dropping Face = "<< utf);
+      SAF_LOG_DEBUG("UTF remaining for the Dropping Face = "<< utf);
       table(determineRowOfFace (DROP_FACE_ID), layer) = utf;
 
       //check if probing could be done
@@ -274,10 +285,14 @@ void SAFForwardingTable::update(boost::shared_ptr<SAFStatisticMeasure> stats)
     else if(stats->getTotalForwardedInterests (layer) > 0)
       increaseReliabilityThreshold (layer);
 
+    applyBackPressure (layer);
   }
   //finally just normalize to remove the rounding errors
   table = normalizeColumns(table);
-  NS_LOG_DEBUG("FWT After Update:\n" << table); /* prints matrix line by line ( (first line), (second line) )*/
+
+  //sticky flows may be mapped to a different face in the next period
+  flowSalt = drawFlowSalt ();
+  SAF_LOG_DEBUG("FWT After Update:\n" << table); /* prints matrix line by line ( (first line), (second line) )*/
 }
 
 void SAFForwardingTable::probeColumn(std::vector<int> faces, int layer, boost::shared_ptr<SAFStatisticMeasure> stats)
@@ -289,15 +304,15 @@ void SAFForwardingTable::probeColumn(std::vector<int> faces, int layer, boost::s
 
   double lweight = (1.0/((double) (pow(1.0+(double)layer,2.0) - layer)));
   double probe = table(determineRowOfFace (DROP_FACE_ID), layer) * stats->getRho (layer) * lweight;
-  NS_LOG_DEBUG("Probing! Probe Size = p(F_D) * rho * lweight= " << table(determineRowOfFace (DROP_FACE_ID), layer)
+  SAF_LOG_DEBUG("Probing! Probe Size = p(F_D) * rho * lweight= " << table(determineRowOfFace (DROP_FACE_ID), layer)
                  << "*" << stats->getRho (layer) << " * "<< lweight << "=" << probe);
 
   if(probe < 0.001) // if probe is zero return
     return;
 
-  /*NS_LOG_DEBUG("Probing! Probe Size = p(F_D) * rho = " << table(determineRowOfFace (DROP_FACE_ID), layer)
+  /*SAF_LOG_DEBUG("Probing! Probe Size = p(F_D) * rho = " << table(determineRowOfFace (DROP_FACE_ID), layer)
                << "*" << ParameterConfiguration::getInstance ()->getParameter ("PROBING_TRAFFIC") << "=" << probe);*/
-  NS_LOG_DEBUG("Probing! Probe Size = p(F_D) * rho = " << table(determineRowOfFace (DROP_FACE_ID), layer)
+  SAF_LOG_DEBUG("Probing! Probe Size = p(F_D) * rho = " << table(determineRowOfFace (DROP_FACE_ID), layer)
                  << "*" << stats->getRho (layer) << "=" << probe);
 
   //remove the probing traffic from F_D
@@ -325,30 +340,30 @@ void SAFForwardingTable::probeColumn(std::vector<int> faces, int layer, boost::s
 
 void SAFForwardingTable::crossLayerAdaptation(boost::shared_ptr<SAFStatisticMeasure> smeasure)
 {
+  int layers = (int)ParameterConfiguration::getInstance ()->getParameter ("MAX_LAYERS");
+  int dropRow = determineRowOfFace (DROP_FACE_ID);
+
   //investigate all layers for dropping traffic
   std::vector<int> adp_layers;
-  for(int layer = 0; layer < (int)ParameterConfiguration::getInstance ()->getParameter ("MAX_LAYERS") - 1; layer++) // -1 as last layer can not be adapted anyway
+  for(int layer = 0; layer < layers - 1; layer++) // -1 as last layer can not be adapted anyway
   {
+    std::map<int,int>::iterator observed = observed_layers.find (layer);
+
     //if under layer is under observation
-    if(observed_layers.find (layer) != observed_layers.end ())
+    if(observed != observed_layers.end ())
     {
       //check if steps are left
-      if(observed_layers[layer] > 0)
-        observed_layers[layer] -= 1; // reduce steps by 1
+      if(observed->second > 0)
+        observed->second -= 1; // reduce steps by 1
       else
       {
         adp_layers.push_back (layer);
-        observed_layers.erase (observed_layers.find (layer));
+        observed_layers.erase (observed);
       }
     }
     // check if we currently drop traffic for non observed layer
-    else if(table(determineRowOfFace(DROP_FACE_ID),layer) > 0)
+    else if(table(dropRow,layer) > 0)
     {
-      //if under investigation skip this layer
-      if(observed_layers.find (layer) != observed_layers.end ())
-        continue;
-
-      //get the set of unreliable faces:
       double n = 0;
       double n_max = 0;
       double rel_t = curReliability[layer];
@@ -357,15 +372,11 @@ void SAFForwardingTable::crossLayerAdaptation(boost::shared_ptr<SAFStatisticMeas
       double p0 = 0.0;
       double ema_alpha = 0.0;
 
-      //ensure that I > 0
+      //ensure that I > 0, else skip it for this period as we cant really say what to do
       if(total_interests == 0)
-      {
-        //observed_layers[layer] = MAX_OBSERVATION_PERIODS;
-        //skip it for this perios and wait for next as we cant really say what do
         continue;
-      }
 
-      NS_LOG_DEBUG("Calculating number of periods to wait for layer " << layer << " to stabilize");
+      SAF_LOG_DEBUG("Calculating number of periods to wait for layer " << layer << " to stabilize");
       std::vector<int> ur_faces = smeasure->getUnreliableFaces (layer, rel_t);
       for(std::vector<int>::iterator it = ur_faces.begin (); it != ur_faces.end (); ++it)
       {
@@ -378,13 +389,13 @@ void SAFForwardingTable::crossLayerAdaptation(boost::shared_ptr<SAFStatisticMeas
         if(satisfied_interests < 1)
         {
           //actually we are very likly that *it is a probing face, so just skip it
-          NS_LOG_DEBUG( "n["<< *it << "] = skipped, \t We think it is a probing face");
+          SAF_LOG_DEBUG( "n["<< *it << "] = skipped, \t We think it is a probing face");
           continue;
         }
 
         if( p0 * total_interests < satisfied_interests)//means the update procedure made the face already reliable
         {
-          NS_LOG_DEBUG( "n["<< *it << "] = skipped, \t We think the previous update procedure made the face already reliable");
+          SAF_LOG_DEBUG( "n["<< *it << "] = skipped, \t We think the previous update procedure made the face already reliable");
           continue;
         }
 
@@ -392,95 +403,177 @@ void SAFForwardingTable::crossLayerAdaptation(boost::shared_ptr<SAFStatisticMeas
         n -= log((p0 * total_interests) - satisfied_interests);
         n /= log(1-ema_alpha);
 
-        NS_LOG_DEBUG( "n["<< *it << "] = [ ln(S(i)/t[i] - S(i)) - ln(p(i)*I - S(i))] / ln(1 - ema_alpha(i)) = "
+        SAF_LOG_DEBUG( "n["<< *it << "] = [ ln(S(i)/t[i] - S(i)) - ln(p(i)*I - S(i))] / ln(1 - ema_alpha(i)) = "
                       << " [ ln(" << satisfied_interests << "/" << rel_t << "-"  << satisfied_interests << ") - "
                       << "ln(" << p0 << "*" << total_interests << " - " << satisfied_interests << ")] / "
                       << "ln(1-" << ema_alpha << ") = " << n);
 
         n_max = std::max(n_max, n);
       }
-      NS_LOG_DEBUG("Layer " << layer << " is under observation for std::min(" << n_max << "," << MAX_OBSERVATION_PERIODS << ") steps") ;
+      SAF_LOG_DEBUG("Layer " << layer << " is under observation for std::min(" << n_max << "," << MAX_OBSERVATION_PERIODS << ") steps") ;
       observed_layers[layer] = ceil(std::min(n_max, MAX_OBSERVATION_PERIODS));
     }
   }
 
-  std::sort(adp_layers.begin (),adp_layers.end ()); // just for the case they are not sorted in ascending order...
+  if(adp_layers.empty ())
+    return;
+
+  // adp_layers is in ascending order and the dropping layer only moves downwards,
+  // so each iteration either ends the shifting for a layer or consumes a dropping layer: O(layers * faces)
+  int droppingLayer = getDroppingLayer ();
   for(std::vector<int>::iterator it = adp_layers.begin (); it != adp_layers.end (); ++it)
   {
-    NS_LOG_DEBUG("Observation Phase for layer " << *it << " is over. Dropping traffic will be shifted\n");
+    SAF_LOG_DEBUG("Observation Phase for layer " << *it << " is over. Dropping traffic will be shifted");
     int curLayer = *it;
-    int droppingLayer = getDroppingLayer ();
+    double curInterests = smeasure->getTotalForwardedInterests (curLayer);
+
+    // interests dropped in curLayer
+    double theta = table(dropRow, curLayer) * curInterests;
 
-    while(curLayer < droppingLayer)
+    while(theta > 0 && curLayer < droppingLayer)
     {
-      // interest forwared to the dropping face of curLayer
-      double theta = table(determineRowOfFace (DROP_FACE_ID), curLayer) * smeasure->getTotalForwardedInterests (curLayer);
+      double dropInterests = smeasure->getTotalForwardedInterests (droppingLayer);
 
-      //max traffic that can be shifted towards face(s) of last
-      double chi = (1.0 - table(determineRowOfFace (DROP_FACE_ID), droppingLayer)) * smeasure->getTotalForwardedInterests (droppingLayer);
+      // interests of the dropping layer that are still forwarded and could be dropped instead
+      double chi = (1.0 - table(dropRow, droppingLayer)) * dropInterests;
 
-      if (theta == 0)
-      {
-        for(std::vector<int>::iterator it = faces.begin(); it != faces.end(); ++it)
-        {
-          if(*it == DROP_FACE_ID)
-            table(determineRowOfFace (*it), curLayer) = 0;
-          else
-            table(determineRowOfFace (*it), curLayer) = 1.0 / (faces.size ()-1);
-        }
-      }
-      else if(chi == 0) // nothing has been forwarded via the last face, set drop prob to 100%
+      // if the dropping layer can not take all, it drops everything afterwards
+      bool exhausted = (chi <= theta);
+
+      if(chi > 0)
       {
-        for(std::vector<int>::iterator it = faces.begin(); it != faces.end(); ++it)
-        {
-          if(*it == DROP_FACE_ID)
-            table(determineRowOfFace (*it), droppingLayer) = 1;
-          else
-            table(determineRowOfFace (*it), droppingLayer) = 0;
-        }
+        double shift = std::min(theta, chi);
+        SAF_LOG_DEBUG("Shifting " << shift << " dropped Interests from layer " << curLayer << " to layer " << droppingLayer);
+
+        shiftDroppingTraffic (curLayer, -shift / curInterests);
+        shiftDroppingTraffic (droppingLayer, shift / dropInterests);
+        theta -= shift;
       }
-      else
-      {
-        if(chi > theta) //if we can shift more than we need to, we just shift how much we need
-          chi = theta;
 
-        //reduce dropping prob for lower layer
-        table(determineRowOfFace (DROP_FACE_ID), curLayer) -= (chi / smeasure->getTotalForwardedInterests (curLayer));
+      // nothing more can be dropped in this layer, continue with the next lower one
+      if(exhausted)
+        droppingLayer--;
+    }
+  }
+}
 
-        //increase dropping prob for higher layer
-        table(determineRowOfFace (DROP_FACE_ID), droppingLayer)  += (chi / smeasure->getTotalForwardedInterests (droppingLayer));
+void SAFForwardingTable::shiftDroppingTraffic(int layer, double delta)
+{
+  int dropRow = determineRowOfFace (DROP_FACE_ID);
 
-        //calc n_frist , n_last normalization value without dropping face;
-        double n_first = 0;
-        double n_last = 0;
+  double oldDrop = table(dropRow, layer);
+  double newDrop = std::min(1.0, std::max(0.0, oldDrop + delta));
 
-        for(std::vector<int>::iterator it = faces.begin(); it != faces.end(); ++it)
-        {
-          if(*it == DROP_FACE_ID)
-            continue;
+  //the remaining probability is split among the faces according to their current share
+  double n = 1.0 - oldDrop;
+  for(unsigned int i = 0; i < table.size1 (); i++)
+  {
+    if((int) i == dropRow)
+      continue;
 
-          n_first += table(determineRowOfFace (*it), curLayer);
-          n_last +=  table(determineRowOfFace (*it), droppingLayer);
-        }
+    if(n > 0)
+      table(i, layer) *= (1.0 - newDrop) / n;
+    else
+      table(i, layer) = (1.0 - newDrop) / ((double) table.size1 () - 1.0);
+  }
+  table(dropRow, layer) = newDrop;
+}
 
-        //increase & decrease other faces accordingly
-        for(std::vector<int>::iterator it = faces.begin(); it != faces.end(); ++it)
-        {
-          if(*it == DROP_FACE_ID)
-            continue;
+void SAFForwardingTable::applyBackPressure(int layer)
+{
+  std::map<int, std::map<int, double> >::iterator bp = backPressure.find (layer);
+  if(bp == backPressure.end ())
+    return;
 
-          table(determineRowOfFace (*it), curLayer) += (chi/smeasure->getTotalForwardedInterests (curLayer)) * (table(determineRowOfFace (*it), curLayer)/n_first);
-          table(determineRowOfFace (*it), droppingLayer) -= (chi/smeasure->getTotalForwardedInterests (droppingLayer)) * (table(determineRowOfFace (*it), droppingLayer)/n_last);
-        }
-      }
+  std::map<int, double>& feedback = bp->second;
 
-      //check if we can break the while loop already
-      if(droppingLayer == getDroppingLayer ())
-        break;
-      else
-        droppingLayer = getDroppingLayer ();
-    }
+  // a weight above 1 would turn probabilities negative
+  double weight = std::min(1.0, ParameterConfiguration::getInstance ()->getParameter ("BACK_PRESSURE_WEIGHT"));
+
+  // shift traffic away from faces whose upstreams drop, before the losses show up in the statistics
+  std::map<int, double> shifted;
+  double total = 0.0;
+  double remaining = 0.0;
+  for(std::vector<int>::iterator it = faces.begin(); it != faces.end(); ++it)
+  {
+    if(*it == DROP_FACE_ID)
+      continue;
+
+    double p = table(determineRowOfFace (*it), layer);
+    total += p;
+
+    std::map<int, double>::iterator f = feedback.find (*it);
+    if(f != feedback.end ())
+      p *= std::max(0.0, 1.0 - weight * f->second);
+
+    shifted[*it] = p;
+    remaining += p;
   }
+
+  // the EMA is kept across periods, a face without feedback in this period counts as reporting no drops
+  std::set<int>& renewed = backPressureRenewed[layer];
+  for(std::map<int, double>::iterator f = feedback.begin (); f != feedback.end (); ++f)
+  {
+    if(renewed.find (f->first) == renewed.end ())
+      f->second *= (1.0 - BACK_PRESSURE_EMA_ALPHA);
+  }
+  renewed.clear ();
+
+  if(total <= 0 || remaining <= 0) // all upstreams drop, nothing can be shifted
+    return;
+
+  SAF_LOG_DEBUG("Back-Pressure for Layer[" << layer << "] shifts " << (total - remaining) / total << " of the traffic");
+
+  // the forwarding probability of the layer stays the same, only the distribution among the faces changes
+  for(std::map<int, double>::iterator it = shifted.begin(); it != shifted.end(); ++it)
+    table(determineRowOfFace (it->first), layer) = it->second * total / remaining;
+}
+
+void SAFForwardingTable::restore(const std::map<int, std::vector<double> >& probabilities, const std::vector<double>& reliability)
+{
+  for(unsigned int layer = 0; layer < table.size2 () && layer < reliability.size (); layer++)
+    curReliability[layer] = reliability[layer];
+
+  for(std::map<int, std::vector<double> >::const_iterator it = probabilities.begin (); it != probabilities.end (); ++it)
+  {
+    int row = determineRowOfFace(it->first);
+    if(row == FACE_NOT_FOUND)
+      continue;
+
+    for(unsigned int layer = 0; layer < table.size2 () && layer < it->second.size (); layer++)
+      table(row, layer) = it->second[layer];
+  }
+
+  //faces that are new since the snapshot keep a share of their initial probability
+  table = normalizeColumns(table);
+  SAF_LOG_DEBUG("FWT After Restore:\n" << table);
+}
+
+double SAFForwardingTable::getForwardingProbability(int faceId, int layer)
+{
+  int row = determineRowOfFace (faceId);
+  if(row == FACE_NOT_FOUND)
+    return 0.0;
+  return table(row, layer);
+}
+
+double SAFForwardingTable::getDropProbability(int layer)
+{
+  return table(determineRowOfFace (DROP_FACE_ID), layer);
+}
+
+void SAFForwardingTable::logDropProbability(int faceId, int layer, double dropProbability)
+{
+  if(determineRowOfFace (faceId) == FACE_NOT_FOUND)
+    return;
+
+  std::map<int, double>& feedback = backPressure[layer];
+  backPressureRenewed[layer].insert (faceId);
+  std::map<int, double>::iterator it = feedback.find (faceId);
+  if(it == feedback.end ())
+    feedback[faceId] = dropProbability;
+  else
+    it->second = BACK_PRESSURE_EMA_ALPHA * dropProbability + (1.0 - BACK_PRESSURE_EMA_ALPHA) * it->second;
 }
 
 int SAFForwardingTable::getDroppingLayer()
@@ -498,7 +591,7 @@ int SAFForwardingTable::determineRowOfFace(int face_uid)
   return determineRowOfFace (face_uid, table, faces);
 }
 
-int SAFForwardingTable::determineRowOfFace(int face_id, boost::numeric::ublas::matrix<double> tab, std::vector<int> faces)
+int SAFForwardingTable::determineRowOfFace(int face_id, const matrix<double>& tab, const std::vector<int>& faces)
 {
   // check if table fits to faces
   if(tab.size1 () != faces.size ())
@@ -507,22 +600,12 @@ int SAFForwardingTable::determineRowOfFace(int face_id, boost::numeric::ublas::m
     return FACE_NOT_FOUND;
   }
 
-  //determine row of face
-  int faceRow = FACE_NOT_FOUND;
-  std::sort(faces.begin(), faces.end());//order
+  //faces are kept in ascending order, so the row is found by binary search
+  std::vector<int>::const_iterator it = std::lower_bound(faces.begin (), faces.end (), face_id);
+  if(it == faces.end () || *it != face_id)
+    return FACE_NOT_FOUND;
 
-  int rowCounter = 0;
-  for(std::vector<int>::iterator i = faces.begin (); i != faces.end() ; ++i)
-  {
-    //fprintf(stderr, "*i=%d ; face_id=%d\n",*i,face_id);
-    if(*i == face_id)
-    {
-      faceRow = rowCounter;
-      break;
-    }
-    rowCounter++;
-  }
-  return faceRow;
+  return it - faces.begin ();
 }
 
 matrix<double> SAFForwardingTable::removeFaceFromTable (int faceId, matrix<double> tab, std::vector<int> faces)
@@ -590,9 +673,83 @@ matrix<double> SAFForwardingTable::normalizeColumns(matrix<double> m)
   return m;
 }
 
-int SAFForwardingTable::chooseFaceAccordingProbability(matrix<double> m, int ilayer, std::vector<int> faceList)
+uint64_t SAFForwardingTable::mixHash(uint64_t h)
+{
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+uint64_t SAFForwardingTable::determineFlowHash(const Interest& interest)
+{
+  // hash the name without the segment number, so all segments of a flow get the same value within a period
+  const Name& name = interest.getName ();
+  uint64_t h = 14695981039346656037ULL ^ flowSalt;
+  for(size_t i = 0; i + 1 < name.size (); i++)
+  {
+    const name::Component& c = name.get (i);
+    for(Block::const_iterator it = c.begin (); it != c.end (); ++it)
+    {
+      h ^= *it;
+      h *= 1099511628211ULL;
+    }
+  }
+
+  // final mix, as flows usually differ only in a few bytes
+  return mixHash(h);
+}
+
+int SAFForwardingTable::chooseFaceForFlow(matrix<double> m, int ilayer, std::vector<int> faceList, const Interest& interest)
+{
+  if(faceList.size () != m.size1 ())
+  {
+    fprintf(stderr, "Error ForwardingMatrix invalid cant choose Face\n!");
+    return DROP_FACE_ID;
+  }
+
+  double total = 0.0;
+  double dropping = 0.0;
+  for(unsigned int i = 0; i < m.size1 (); i++)
+  {
+    total += m(i, ilayer);
+    if(faceList.at (i) == DROP_FACE_ID)
+      dropping += m(i, ilayer);
+  }
+
+  if(total <= 0.0)
+    return DROP_FACE_ID;
+
+  // dropping is decided per interest, so a flow is not starved for a whole period by its hash
+  if(randomVariable->getValue () * total < dropping)
+    return DROP_FACE_ID;
+
+  // weighted rendezvous hashing over the forwarding faces: a flow takes the face with the highest score, so it picks a
+  // face with a probability proportional to its share, and excluding a face only moves the flows that were on it
+  uint64_t flow = determineFlowHash(interest);
+  int face = DROP_FACE_ID;
+  double best = 0.0;
+  for(unsigned int i = 0; i < m.size1 (); i++)
+  {
+    if(faceList.at (i) == DROP_FACE_ID || m(i, ilayer) <= 0.0)
+      continue;
+
+    uint64_t h = mixHash(flow ^ ((uint64_t) faceList.at (i) * 0x9e3779b97f4a7c15ULL));
+    double u = ((double) (h >> 11) + 0.5) / (double) (1ULL << 53); /*(0,1)*/
+    double score = -m(i, ilayer) / log(u);
+    if(face == DROP_FACE_ID || score > best)
+    {
+      face = faceList.at (i);
+      best = score;
+    }
+  }
+  return face;
+}
+
+int SAFForwardingTable::chooseFaceAccordingProbability(matrix<double> m, int ilayer, std::vector<int> faceList, double rvalue)
 {
-  double rvalue = randomVariable.GetValue ();
   double sum = 0.0;
 
   if(faceList.size () != m.size1 ())
@@ -643,9 +800,9 @@ void SAFForwardingTable::updateReliabilityThreshold(int layer, bool increase)
   if(new_t != curReliability[layer])
   {
   if(increase)
-    NS_LOG_DEBUG("Increasing reliability[" << layer << "]=" << new_t);
+    SAF_LOG_DEBUG("Increasing reliability[" << layer << "]=" << new_t);
   else
-    NS_LOG_DEBUG("Decreasing reliability[" << layer << "]=" << new_t);
+    SAF_LOG_DEBUG("Decreasing reliability[" << layer << "]=" << new_t);
   }
 
   curReliability[layer] = new_t;
@@ -690,7 +847,7 @@ void SAFForwardingTable::removeFace(shared_ptr<Face> face)
 
   if(faceRow == FACE_NOT_FOUND)
   {
-    NS_LOG_DEBUG("Could not remove Face from Table as it does not exist");
+    SAF_LOG_DEBUG("Could not remove Face from Table as it does not exist");
     return;
   }
 
@@ -716,4 +873,56 @@ void SAFForwardingTable::removeFace(shared_ptr<Face> face)
 
   faces.erase(std::find(faces.begin (),faces.end (),face->getId()));
   table = normalizeColumns (m);
+
+  for(std::map<int, std::map<int, double> >::iterator it = backPressure.begin (); it != backPressure.end (); ++it)
+    it->second.erase (face->getId());
+  for(std::map<int, std::set<int> >::iterator it = backPressureRenewed.begin (); it != backPressureRenewed.end (); ++it)
+    it->second.erase (face->getId());
+}
+
+void SAFForwardingTable::saveCheckpoint(std::ostream& os)
+{
+  checkpoint::write(os, faces);
+  checkpoint::write<uint32_t>(os, table.size1 ());
+  checkpoint::write<uint32_t>(os, table.size2 ());
+  for(unsigned int row = 0; row < table.size1 (); row++)
+    for(unsigned int layer = 0; layer < table.size2 (); layer++)
+      checkpoint::write(os, table(row, layer));
+
+  checkpoint::write(os, curReliability);
+  checkpoint::write(os, observed_layers);
+  checkpoint::write(os, backPressure);
+}
+
+void SAFForwardingTable::loadCheckpoint(std::istream& is)
+{
+  std::vector<int> savedFaces;
+  uint32_t rows = 0, layers = 0;
+  checkpoint::read(is, savedFaces);
+  checkpoint::read(is, rows);
+  checkpoint::read(is, layers);
+
+  matrix<double> savedTable(rows, layers);
+  for(unsigned int row = 0; row < rows; row++)
+    for(unsigned int layer = 0; layer < layers; layer++)
+      checkpoint::read(is, savedTable(row, layer));
+
+  std::map<int, double> savedReliability;
+  std::map<int, int> savedObservedLayers;
+  std::map<int, std::map<int, double> > savedBackPressure;
+  checkpoint::read(is, savedReliability);
+  checkpoint::read(is, savedObservedLayers);
+  checkpoint::read(is, savedBackPressure);
+
+  if(savedFaces != faces || layers != table.size2 ())
+  {
+    fprintf(stderr, "Ignoring checkpoint of a forwarding table with different faces\n");
+    return;
+  }
+
+  table = savedTable;
+  curReliability = savedReliability;
+  observed_layers = savedObservedLayers;
+  backPressure = savedBackPressure;
+  backPressureRenewed.clear ();
 }
@@ -20,17 +20,19 @@
 
 #include <boost/numeric/ublas/matrix.hpp>
 #include <boost/numeric/ublas/io.hpp>
-#include "ns3/random-variable.h"
 
 #include "../utils/parameterconfiguration.h"
+#include "../utils/checkpoint.h"
 #include "safstatisticmeasure.h"
 
 #include "fw/face-table.hpp"
 #include "iostream"
 #include "climits"
-#include "ns3/log.h"
+#include <set>
+#include "platform/safplatform.h"
 
 #define MAX_OBSERVATION_PERIODS 10.0
+#define BACK_PRESSURE_EMA_ALPHA 0.3
 
 namespace nfd
 {
@@ -66,17 +68,61 @@ public:
   void update(boost::shared_ptr<SAFStatisticMeasure> smeasure);
 
   /**
-   * @brief enables cross layer adaptation. EXPERIMENTAL and DISABLED
-   * @param smeasure
+   * @brief shifts dropping traffic from lower to higher layers, enabled by CONTENT_AWARE_ADAPTATION.
+   * A layer that drops is observed until its unreliable faces are expected to recover,
+   * afterwards its dropped traffic is taken over by the highest layer that still forwards.
+   * @param smeasure the statistic measure object that logged the traffic
    */
   void crossLayerAdaptation(boost::shared_ptr<SAFStatisticMeasure> smeasure);
 
+  /**
+   * @brief provides the forwarding probability of a face.
+   * @param faceId the face
+   * @param layer the layer
+   * @return the probability, 0 if the face is unknown.
+   */
+  double getForwardingProbability(int faceId, int layer);
+
+  /**
+   * @brief provides the drop probability of a layer, that is reported as feedback to the downstream nodes.
+   * @param layer the layer
+   * @return
+   */
+  double getDropProbability(int layer);
+
+  /**
+   * @brief logs the drop probability reported by the upstream node of a face.
+   * @param faceId the face the feedback was received on
+   * @param layer the layer
+   * @param dropProbability the drop probability of the upstream node
+   */
+  void logDropProbability(int faceId, int layer, double dropProbability);
+
   /**
    * @brief provides the current reliability threshold for each layer.
    * @return
    */
   std::map<int /*layer*/,double/*reliabilty*/> getCurrentReliability(){return this->curReliability;}
 
+  /**
+   * @brief provides the faces of the table in the order of its rows.
+   * @return
+   */
+  std::vector<int> getFaces(){return faces;}
+
+  /**
+   * @brief overwrites the table with learned values (warm start).
+   * @param probabilities the forwarding probability per layer for each known face, other faces keep their initial values
+   * @param reliability the reliability threshold per layer
+   */
+  void restore(const std::map<int, std::vector<double> >& probabilities, const std::vector<double>& reliability);
+
+  /**
+   * @brief writes/restores the complete state of the table, the table is only restored if the faces did not change.
+   */
+  void saveCheckpoint(std::ostream& os);
+  void loadCheckpoint(std::istream& is);
+
   /**
    * @brief addFace
    * @param face
@@ -91,15 +137,19 @@ public:
 
   protected:
   void initTable();
+  uint32_t drawFlowSalt();
   std::map<int, double> calcInitForwardingProb(std::map<int, int> preferedFacesIds, double gamma);
   std::map<int, double> minHop(std::map<int, int> preferedFacesIds);
 
-  int determineRowOfFace(int face_uid, boost::numeric::ublas::matrix<double> tab, std::vector<int> faces);
+  int determineRowOfFace(int face_uid, const boost::numeric::ublas::matrix<double>& tab, const std::vector<int>& faces);
   int determineRowOfFace(int face_uid);
   boost::numeric::ublas::matrix<double> removeFaceFromTable (int faceId, boost::numeric::ublas::matrix<double> tab, std::vector<int> faces);
   boost::numeric::ublas::matrix<double> normalizeColumns(boost::numeric::ublas::matrix<double> m);
 
-  int chooseFaceAccordingProbability(boost::numeric::ublas::matrix<double> m, int ilayer, std::vector<int> faceList);
+  int chooseFaceAccordingProbability(boost::numeric::ublas::matrix<double> m, int ilayer, std::vector<int> faceList, double rvalue);
+  int chooseFaceForFlow(boost::numeric::ublas::matrix<double> m, int ilayer, std::vector<int> faceList, const Interest& interest);
+  uint64_t determineFlowHash(const Interest& interest);
+  static uint64_t mixHash(uint64_t h);
 
   void probeColumn(std::vector<int> faces, int layer, boost::shared_ptr<SAFStatisticMeasure> smeasure);
 
@@ -108,14 +158,21 @@ public:
   void updateReliabilityThreshold(int layer, bool increase);
 
   int getDroppingLayer();
+  void shiftDroppingTraffic(int layer, double delta);
+
+  void applyBackPressure(int layer);
 
   boost::numeric::ublas::matrix<double> table;
   std::vector<int> faces;
   std::map<int /*faceId*/,int/*costs/metric*/> preferedFaces;
   std::map<int /*layer*/,double/*reliabilty*/> curReliability;
-  ns3::UniformVariable randomVariable;
+  boost::shared_ptr<SAFRandomStream> randomVariable;
+  uint32_t flowSalt; /*changed each period, so sticky flows are redistributed*/
 
   std::map<int /*layer*/,int/*steps_left*/> observed_layers;
+
+  std::map<int /*layer*/, std::map<int /*faceId*/, double /*drop prob. of upstream*/> > backPressure; /*EMA over periods*/
+  std::map<int /*layer*/, std::set<int /*faceId*/> > backPressureRenewed; /*faces with feedback in the current period*/
 };
 
 }
@@ -0,0 +1,147 @@
+#include "saflayerclassifier.h"
+#include "../utils/parameterconfiguration.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace nfd;
+using namespace nfd::fw;
+
+SAFLayerClassifier* SAFLayerClassifier::instance = NULL;
+
+SAFLayerClassifier::SAFLayerClassifier()
+{
+}
+
+SAFLayerClassifier* SAFLayerClassifier::getInstance()
+{
+  if(instance == NULL)
+    instance = new SAFLayerClassifier();
+
+  return instance;
+}
+
+void SAFLayerClassifier::registerComponentRule(std::string prefix, unsigned int position, std::string marker)
+{
+  Rule rule;
+  rule.prefix = Name(prefix);
+  rule.type = ComponentPosition;
+  rule.position = position;
+  rule.marker = marker;
+  addRule(rule);
+}
+
+void SAFLayerClassifier::registerSuffixRule(std::string prefix, std::string marker, std::string suffix)
+{
+  Rule rule;
+  rule.prefix = Name(prefix);
+  rule.type = ComponentSuffix;
+  rule.position = 0;
+  rule.marker = marker;
+  rule.suffix = suffix;
+  addRule(rule);
+}
+
+void SAFLayerClassifier::addRule(const Rule& rule)
+{
+  //replace an existing rule for the prefix
+  for(std::vector<Rule>::iterator it = rules.begin (); it != rules.end (); ++it)
+  {
+    if(it->prefix == rule.prefix)
+    {
+      rules.erase (it);
+      break;
+    }
+  }
+
+  std::vector<Rule>::iterator it = rules.begin ();
+  while(it != rules.end () && it->prefix.size () >= rule.prefix.size ())
+    ++it;
+  rules.insert (it, rule);
+}
+
+void SAFLayerClassifier::clear()
+{
+  rules.clear ();
+}
+
+int SAFLayerClassifier::classify(const Name& name)
+{
+  for(std::vector<Rule>::iterator it = rules.begin (); it != rules.end (); ++it)
+  {
+    if(!it->prefix.isPrefixOf (name))
+      continue;
+
+    int layer = 0;
+    if(it->type == ComponentPosition)
+      layer = matchComponentPosition (*it, name);
+    else
+      layer = matchComponentSuffix (*it, name);
+
+    // the table has no column for this layer, MAX_LAYERS may be set after the rules are registered
+    int maxLayer = std::max(0, (int) ParameterConfiguration::getInstance ()->getParameter ("MAX_LAYERS") - 1);
+    if(layer > maxLayer)
+      layer = maxLayer;
+    if(layer < 0)
+      layer = 0;
+
+    return layer;
+  }
+  return 0;
+}
+
+int SAFLayerClassifier::matchComponentPosition(const Rule& rule, const Name& name)
+{
+  if(rule.position >= name.size ())
+    return 0;
+
+  const name::Component& c = name.get (rule.position);
+  if(c.value_size () <= rule.marker.size () || memcmp(c.value (), rule.marker.data (), rule.marker.size ()) != 0)
+    return 0;
+
+  return parseLayer (c.value () + rule.marker.size (), c.value () + c.value_size ());
+}
+
+int SAFLayerClassifier::matchComponentSuffix(const Rule& rule, const Name& name)
+{
+  for(size_t i = rule.prefix.size (); i < name.size (); i++)
+  {
+    const name::Component& c = name.get (i);
+    const uint8_t* begin = c.value ();
+    const uint8_t* end = c.value () + c.value_size ();
+
+    if(c.value_size () <= rule.marker.size () + rule.suffix.size ())
+      continue;
+
+    if(memcmp(end - rule.suffix.size (), rule.suffix.data (), rule.suffix.size ()) != 0)
+      continue;
+
+    //walk back over the digits to the marker
+    const uint8_t* digits = end - rule.suffix.size ();
+    while(digits > begin && *(digits - 1) >= '0' && *(digits - 1) <= '9')
+      digits--;
+
+    if(digits == end - rule.suffix.size () || digits - begin < (int) rule.marker.size ())
+      continue;
+
+    if(memcmp(digits - rule.marker.size (), rule.marker.data (), rule.marker.size ()) != 0)
+      continue;
+
+    return parseLayer (digits, end - rule.suffix.size ());
+  }
+  return 0;
+}
+
+int SAFLayerClassifier::parseLayer(const uint8_t* begin, const uint8_t* end)
+{
+  // larger values are clamped by classify anyway, so accumulating stops before the int can overflow
+  int limit = (int) ParameterConfiguration::getInstance ()->getParameter ("MAX_LAYERS");
+  int layer = 0;
+  for(const uint8_t* it = begin; it != end; ++it)
+  {
+    if(*it < '0' || *it > '9')
+      return 0;
+    if(layer <= limit)
+      layer = layer * 10 + (*it - '0');
+  }
+  return layer;
+}
@@ -0,0 +1,100 @@
+/**
+ * Copyright (c) 2015 Daniel Posch (Alpen-Adria Universität Klagenfurt)
+ *
+ * This file is part of the ndnSIM extension for Stochastic Adaptive Forwarding (SAF).
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef SAFLAYERCLASSIFIER_H
+#define SAFLAYERCLASSIFIER_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "fw/strategy.hpp"
+
+namespace nfd
+{
+namespace fw
+{
+
+/**
+ * @brief The SAFLayerClassifier class determines the content layer of an interest by rules configured per prefix.
+ * Rules work on the raw bytes of the name components, the name is never converted to an uri.
+ * The class uses a singleton pattern.
+ */
+class SAFLayerClassifier
+{
+public:
+
+  enum RuleType
+  {
+    ComponentPosition, /*component at a given position is <marker><n>, e.g. /video/layer1/seg0*/
+    ComponentSuffix    /*a component ends with <marker><n><suffix>, e.g. /video/bunny-L1.svc/seg0*/
+  };
+
+  static SAFLayerClassifier* getInstance();
+
+  /**
+   * @brief registers a component position rule.
+   * @param prefix the prefix the rule applies to
+   * @param position the position of the component that contains the layer
+   * @param marker the bytes in front of the layer number, e.g. "layer"
+   */
+  void registerComponentRule(std::string prefix, unsigned int position, std::string marker);
+
+  /**
+   * @brief registers a suffix rule.
+   * @param prefix the prefix the rule applies to
+   * @param marker the bytes in front of the layer number, e.g. "-L"
+   * @param suffix the bytes after the layer number, e.g. ".svc"
+   */
+  void registerSuffixRule(std::string prefix, std::string marker, std::string suffix);
+
+  /**
+   * @brief removes all rules.
+   */
+  void clear();
+
+  /**
+   * @brief determines the layer of a name, using the rule of the longest matching prefix.
+   * @param name the name
+   * @return the layer, 0 if no rule matches.
+   */
+  int classify(const Name& name);
+
+protected:
+  SAFLayerClassifier();
+  static SAFLayerClassifier* instance;
+
+  struct Rule
+  {
+    Name prefix;
+    RuleType type;
+    unsigned int position;
+    std::string marker;
+    std::string suffix;
+  };
+
+  void addRule(const Rule& rule);
+  int matchComponentPosition(const Rule& rule, const Name& name);
+  int matchComponentSuffix(const Rule& rule, const Name& name);
+  int parseLayer(const uint8_t* begin, const uint8_t* end);
+
+  std::vector<Rule> rules; /*sorted by prefix length, longest first*/
+};
+
+}
+}
+#endif // SAFLAYERCLASSIFIER_H
@@ -0,0 +1,180 @@
+#include "safsnapshot.h"
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+
+using namespace nfd;
+using namespace nfd::fw;
+
+std::string SAFSnapshot::directory = "";
+
+namespace
+{
+
+template<typename T>
+bool readValue(const char*& pos, const char* end, T& value)
+{
+  if(pos + sizeof(T) > end)
+    return false;
+  memcpy(&value, pos, sizeof(T));
+  pos += sizeof(T);
+  return true;
+}
+
+bool readString(const char*& pos, const char* end, std::string& value)
+{
+  uint16_t length;
+  if(!readValue(pos, end, length) || pos + length > end)
+    return false;
+  value.assign (pos, length);
+  pos += length;
+  return true;
+}
+
+bool readDoubles(const char*& pos, const char* end, std::vector<double>& values, size_t n)
+{
+  if(pos + n * sizeof(double) > end)
+    return false;
+  values.resize (n);
+  if(n > 0)
+    memcpy(&values[0], pos, n * sizeof(double));
+  pos += n * sizeof(double);
+  return true;
+}
+
+template<typename T>
+void writeValue(std::ofstream& out, T value)
+{
+  out.write ((const char*) &value, sizeof(T));
+}
+
+void writeString(std::ofstream& out, const std::string& value)
+{
+  writeValue<uint16_t>(out, (uint16_t) value.size ());
+  out.write (value.data (), value.size ());
+}
+
+void writeDoubles(std::ofstream& out, const std::vector<double>& values)
+{
+  if(!values.empty ())
+    out.write ((const char*) &values[0], values.size () * sizeof(double));
+}
+
+}
+
+SAFSnapshot::SAFSnapshot(const std::string& file)
+{
+  valid = false;
+  end = NULL;
+
+  try
+  {
+    this->file = boost::interprocess::file_mapping(file.c_str (), boost::interprocess::read_only);
+    region = boost::interprocess::mapped_region(this->file, boost::interprocess::read_only);
+  }
+  catch(boost::interprocess::interprocess_exception& e)
+  {
+    return; // no snapshot, start cold
+  }
+
+  const char* pos = (const char*) region.get_address ();
+  end = pos + region.get_size ();
+
+  uint32_t magic, version, records;
+  if(!readValue(pos, end, magic) || !readValue(pos, end, version) || !readValue(pos, end, records)
+     || magic != SAF_SNAPSHOT_MAGIC || version != SAF_SNAPSHOT_VERSION)
+  {
+    fprintf(stderr, "Ignoring invalid SAF snapshot %s\n", file.c_str ());
+    return;
+  }
+
+  //index the records, they are decoded on demand
+  Record record;
+  for(uint32_t i = 0; i < records; i++)
+  {
+    const char* start = pos;
+    if(!decode(pos, record, true))
+    {
+      fprintf(stderr, "Ignoring truncated SAF snapshot %s\n", file.c_str ());
+      index.clear ();
+      return;
+    }
+    index[record.prefix] = start;
+  }
+  valid = true;
+}
+
+bool SAFSnapshot::find(const std::string& prefix, Record& record)
+{
+  std::map<std::string, const char*>::iterator it = index.find (prefix);
+  if(it == index.end ())
+    return false;
+
+  const char* pos = it->second;
+  return decode(pos, record, false);
+}
+
+bool SAFSnapshot::decode(const char*& pos, Record& record, bool prefixOnly)
+{
+  uint16_t nFaces, nLayers;
+  if(!readString(pos, end, record.prefix) || !readValue(pos, end, nFaces) || !readValue(pos, end, nLayers))
+    return false;
+
+  record.faces.resize (nFaces);
+  for(uint16_t f = 0; f < nFaces; f++)
+  {
+    if(!readString(pos, end, record.faces[f]))
+      return false;
+  }
+
+  size_t cells = (size_t) nFaces * nLayers;
+  if(prefixOnly) // skip the values
+  {
+    size_t size = (nLayers + 3 * cells) * sizeof(double);
+    if(pos + size > end)
+      return false;
+    pos += size;
+    return true;
+  }
+
+  return readDoubles(pos, end, record.reliability, nLayers)
+      && readDoubles(pos, end, record.probabilities, cells)
+      && readDoubles(pos, end, record.faceReliability, cells)
+      && readDoubles(pos, end, record.emaAlpha, cells);
+}
+
+bool SAFSnapshot::write(const std::string& file, const std::vector<Record>& records)
+{
+  std::string tmp = file + ".tmp";
+  std::ofstream out(tmp.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+  if(!out.is_open ())
+  {
+    fprintf(stderr, "Could not write SAF snapshot %s\n", tmp.c_str ());
+    return false;
+  }
+
+  writeValue<uint32_t>(out, SAF_SNAPSHOT_MAGIC);
+  writeValue<uint32_t>(out, SAF_SNAPSHOT_VERSION);
+  writeValue<uint32_t>(out, (uint32_t) records.size ());
+
+  for(std::vector<Record>::const_iterator it = records.begin (); it != records.end (); ++it)
+  {
+    writeString(out, it->prefix);
+    writeValue<uint16_t>(out, (uint16_t) it->faces.size ());
+    writeValue<uint16_t>(out, (uint16_t) it->reliability.size ());
+    for(std::vector<std::string>::const_iterator f = it->faces.begin (); f != it->faces.end (); ++f)
+      writeString(out, *f);
+    writeDoubles(out, it->reliability);
+    writeDoubles(out, it->probabilities);
+    writeDoubles(out, it->faceReliability);
+    writeDoubles(out, it->emaAlpha);
+  }
+
+  out.close ();
+  if(out.fail () || std::rename(tmp.c_str (), file.c_str ()) != 0)
+  {
+    fprintf(stderr, "Could not write SAF snapshot %s\n", file.c_str ());
+    return false;
+  }
+  return true;
+}
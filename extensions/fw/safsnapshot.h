@@ -0,0 +1,109 @@
+/**
+ * Copyright (c) 2015 Daniel Posch (Alpen-Adria Universität Klagenfurt)
+ *
+ * This file is part of the ndnSIM extension for Stochastic Adaptive Forwarding (SAF).
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef SAFSNAPSHOT_H
+#define SAFSNAPSHOT_H
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/shared_ptr.hpp>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <map>
+
+#define SAF_SNAPSHOT_MAGIC 0x53414653 // "SAFS"
+#define SAF_SNAPSHOT_VERSION 1
+
+namespace nfd
+{
+namespace fw
+{
+
+/**
+ * @brief The SAFSnapshot class stores the learned state of the SAF entries of a node in a compact binary file.
+ * Faces are identified by the node on the other side of the link, so the rows of a table can be remapped
+ * to the face ids of a later run. Snapshots are memory-mapped and a record is decoded only when the entry
+ * of its prefix is created.
+ *
+ * File layout (host byte order): magic, version, number of records, followed by the records.
+ * Record: prefix, number of faces, number of layers, face identities, reliability threshold per layer,
+ * and per face and layer the forwarding probability, the last reliability and the EMA of alpha.
+ */
+class SAFSnapshot
+{
+public:
+
+  struct Record
+  {
+    std::string prefix;
+    std::vector<std::string> faces;       /*face identities*/
+    std::vector<double> reliability;      /*reliability threshold per layer*/
+    std::vector<double> probabilities;    /*faces x layers, row major*/
+    std::vector<double> faceReliability;  /*faces x layers, row major*/
+    std::vector<double> emaAlpha;         /*faces x layers, row major*/
+  };
+
+  /**
+   * @brief memory-maps an existing snapshot.
+   * @param file the snapshot file
+   */
+  SAFSnapshot(const std::string& file);
+
+  /**
+   * @brief false if the file could not be mapped or is not a valid snapshot.
+   */
+  bool isValid(){return valid;}
+
+  /**
+   * @brief decodes the record of a prefix.
+   * @param prefix the prefix
+   * @param record the decoded record
+   * @return false if the snapshot has no record for the prefix.
+   */
+  bool find(const std::string& prefix, Record& record);
+
+  /**
+   * @brief writes a snapshot. The file is replaced atomically, so a running simulation never leaves a partial snapshot.
+   * @param file the snapshot file
+   * @param records the records
+   * @return false if the file could not be written.
+   */
+  static bool write(const std::string& file, const std::vector<Record>& records);
+
+  /**
+   * @brief sets the directory snapshots are read from and written to, empty disables snapshots.
+   */
+  static void setDirectory(const std::string& directory){SAFSnapshot::directory = directory;}
+  static std::string getDirectory(){return directory;}
+
+protected:
+  bool decode(const char*& pos, Record& record, bool prefixOnly);
+
+  boost::interprocess::file_mapping file;
+  boost::interprocess::mapped_region region;
+  bool valid;
+
+  std::map<std::string /*prefix*/, const char* /*record*/> index;
+  const char* end;
+
+  static std::string directory;
+};
+
+}
+}
+#endif // SAFSNAPSHOT_H
@@ -3,7 +3,7 @@
 using namespace nfd;
 using namespace nfd::fw;
 
-NS_LOG_COMPONENT_DEFINE("SAFStatisticMeasure");
+SAF_LOG_COMPONENT_DEFINE("SAFStatisticMeasure");
 
 SAFStatisticMeasure::SAFStatisticMeasure(std::vector<int> faces)
 {
@@ -138,32 +138,7 @@ double SAFStatisticMeasure::getFaceReliability(int face_id, int layer)
 
 int SAFStatisticMeasure::determineContentLayer(const Interest& interest)
 {
-  //TODO once content layers are introduced
-
-  /*std::string layer = interest.getName ().get (1).toUri ();
-  //fprintf(stderr, "layer = %s\n",interest.getName ().get (1).toUri ().c_str ());
-
-  if(layer.compare ("layer0") == 0)
-    return 0;
-
-  if(layer.compare ("layer1") == 0)
-    return 1;
-
-  if(layer.compare ("layer2") == 0)
-    return 2;
-
-  layer = interest.getName ().toUri ();
-
-  if(layer.find ("-L0.svc") != std::string::npos)
-    return 0;
-
-  if(layer.find ("-L1.svc") != std::string::npos)
-    return 1;
-
-  if(layer.find ("-L2.svc") != std::string::npos)
-    return 2;*/
-
-  return 0;
+  return SAFLayerClassifier::getInstance ()->classify (interest.getName ());
 }
 
 void SAFStatisticMeasure::updateVariance (int layer)
@@ -217,6 +192,15 @@ double SAFStatisticMeasure::getAlpha(int face_id, int layer)
   return 1.0/(1.0 + std::sqrt(stats[layer].satisfaction_variance[face_id]));
 }
 
+void SAFStatisticMeasure::restoreFaceStatistics(int face_id, int layer, double reliability, double emaAlpha)
+{
+  if(std::find(faces.begin (), faces.end (), face_id) == faces.end ())
+    return;
+
+  stats[layer].last_reliability[face_id] = reliability;
+  stats[layer].ema_alpha[face_id] = emaAlpha;
+}
+
 double SAFStatisticMeasure::getEMAAlpha(int face_id, int layer)
 {
   return stats[layer].ema_alpha[face_id];
@@ -284,3 +268,39 @@ void SAFStatisticMeasure::removeFace(shared_ptr<Face> face)
     stats[layer].ema_alpha.erase(id);
   }
 }
+
+void SAFStatisticMeasure::saveCheckpoint(std::ostream& os)
+{
+  checkpoint::write<uint32_t>(os, stats.size ());
+  for(SAFMesureMap::iterator it = stats.begin (); it != stats.end (); ++it)
+  {
+    checkpoint::write(os, it->first);
+    checkpoint::write(os, it->second.total_forwarded_requests);
+    checkpoint::write(os, it->second.last_reliability);
+    checkpoint::write(os, it->second.last_actual_forwarding_probs);
+    checkpoint::write(os, it->second.last_satisfied_requests);
+    checkpoint::write(os, it->second.last_unsatisfied_requests);
+    checkpoint::write(os, it->second.satisfaction_variance);
+    checkpoint::write(os, it->second.satisfied_requests_history);
+    checkpoint::write(os, it->second.ema_alpha);
+  }
+}
+
+void SAFStatisticMeasure::loadCheckpoint(std::istream& is)
+{
+  uint32_t size = 0;
+  checkpoint::read(is, size);
+  for(uint32_t i = 0; i < size && is.good (); i++)
+  {
+    int layer;
+    checkpoint::read(is, layer);
+    checkpoint::read(is, stats[layer].total_forwarded_requests);
+    checkpoint::read(is, stats[layer].last_reliability);
+    checkpoint::read(is, stats[layer].last_actual_forwarding_probs);
+    checkpoint::read(is, stats[layer].last_satisfied_requests);
+    checkpoint::read(is, stats[layer].last_unsatisfied_requests);
+    checkpoint::read(is, stats[layer].satisfaction_variance);
+    checkpoint::read(is, stats[layer].satisfied_requests_history);
+    checkpoint::read(is, stats[layer].ema_alpha);
+  }
+}
@@ -20,13 +20,15 @@
 #define SAFSTATISTICMEASURE_H
 
 #include "../utils/parameterconfiguration.h"
+#include "../utils/checkpoint.h"
 #include <boost/shared_ptr.hpp>
 #include "fw/strategy.hpp"
 #include <vector>
 #include <map>
-#include "ns3/log.h"
+#include "platform/safplatform.h"
 #include <math.h>
 #include <list>
+#include "saflayerclassifier.h"
 
 #define INIT_VARIANCE 1000 // inital variance
 
@@ -133,6 +135,21 @@ public:
    */
   double getEMAAlpha(int face_id, int layer);
 
+  /**
+   * @brief restores the learned statistics of a face (warm start).
+   * @param face_id the face
+   * @param layer the layer
+   * @param reliability the reliability of the face in the last period
+   * @param emaAlpha the EMA of alpha
+   */
+  void restoreFaceStatistics(int face_id, int layer, double reliability, double emaAlpha);
+
+  /**
+   * @brief writes/restores the statistics of the last periods, the counters of the current period are not part of a checkpoint.
+   */
+  void saveCheckpoint(std::ostream& os);
+  void loadCheckpoint(std::istream& is);
+
   /**
    * @brief gets the number of satisfied interests for a given face
    * @param face_id the face
@@ -173,7 +190,7 @@ public:
   double getRho(int layer);
 
   /**
-   * @brief determines the content layer of an Interest.
+   * @brief determines the content layer of an Interest by the rules of the SAFLayerClassifier.
    * @param interest the interest.
    * @return
    */
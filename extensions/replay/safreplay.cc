@@ -0,0 +1,348 @@
+#include "safreplay.h"
+#include <boost/chrono.hpp>
+#include <algorithm>
+#include <cstring>
+#include <unistd.h>
+
+using namespace nfd;
+using namespace nfd::fw;
+
+const Name ReplayStrategy::STRATEGY_NAME("ndn:/localhost/nfd/strategy/saf-replay");
+
+namespace
+{
+
+double elapsed(const boost::chrono::steady_clock::time_point& begin)
+{
+  return boost::chrono::duration<double>(boost::chrono::steady_clock::now () - begin).count ();
+}
+
+}
+
+ReplayFace::ReplayFace(const std::string& remote)
+  : Face(FaceUri("replay://" + remote), FaceUri("replay://localhost"))
+{
+}
+
+ReplayStrategy::ReplayStrategy(Forwarder& forwarder) : Strategy(forwarder, STRATEGY_NAME)
+{
+}
+
+SAFReplay::SAFReplay(const SAFReplayTrace& trace, StandalonePlatform& platform)
+  : trace(trace), platform(platform)
+{
+  memset(&stats, 0, sizeof(stats));
+  randomVariable = platform.createRandomStream ();
+  faceDown = std::vector<bool>(trace.faces.size (), false);
+  requested = std::vector<bool>(trace.prefixes.size (), false);
+
+  for(uint16_t i = 0; i < trace.faces.size (); i++)
+  {
+    shared_ptr<Face> face = make_shared<ReplayFace>(trace.faces[i].remote);
+    forwarder.addFace (face);
+    faces.push_back (face);
+    faceIndex[face->getId ()] = i;
+    platform.setNetworkFace (face->getId (), trace.faces[i].remote, trace.faces[i].bitrate);
+  }
+
+  //the engine stores its entries in the measurements of the strategy responsible for the namespace
+  strategy = make_shared<ReplayStrategy>(forwarder);
+  forwarder.getStrategyChoice ().install (strategy);
+  forwarder.getStrategyChoice ().insert ("/", ReplayStrategy::STRATEGY_NAME);
+
+  fibEntry = forwarder.getFib ().insert ("/").first;
+  for(uint16_t i = 0; i < trace.faces.size (); i++)
+  {
+    if(trace.faces[i].upstream)
+      fibEntry->addNextHop (faces[i], i);
+  }
+
+  engine = boost::shared_ptr<SAFEngine>(new SAFEngine(forwarder.getFaceTable (), strategy->getMeasurementsAccessor (),
+                                                      (int) ParameterConfiguration::getInstance ()->getParameter ("PREFIX_COMPONENT")));
+}
+
+SAFReplay::~SAFReplay()
+{
+  pending.clear ();
+  responses.clear ();
+  engine.reset ();
+}
+
+void SAFReplay::run()
+{
+  long memory = getResidentMemory ();
+  boost::chrono::steady_clock::time_point begin = boost::chrono::steady_clock::now ();
+
+  for(std::vector<SAFReplayTrace::Event>::const_iterator it = trace.events.begin (); it != trace.events.end (); ++it)
+  {
+    advance(it->time);
+    stats.events++;
+
+    PendingMap::iterator p;
+    switch(it->type)
+    {
+      case SAFReplayTrace::Interest:
+        onInterest(*it);
+        break;
+      case SAFReplayTrace::Data:
+        p = pending.find (getName(*it));
+        if(p != pending.end ())
+          satisfyInterest(p->second.entry, faces[it->face]->getId ());
+        break;
+      case SAFReplayTrace::Nack:
+        p = pending.find (getName(*it));
+        if(p != pending.end ())
+          nackInterest(p->second.entry, faces[it->face]->getId ());
+        break;
+      case SAFReplayTrace::Expire:
+        p = pending.find (getName(*it));
+        if(p != pending.end ())
+          expireInterest(p->second.entry);
+        break;
+      case SAFReplayTrace::FaceDown:
+        faceDown[it->face] = true;
+        break;
+      case SAFReplayTrace::FaceUp:
+        faceDown[it->face] = false;
+        break;
+      default:
+        fprintf(stderr, "Unknown replay event type %d\n", it->type);
+        break;
+    }
+  }
+
+  //let the outstanding interests be answered or expire
+  double end = platform.now () + trace.interestLifetime;
+  if(!responses.empty ())
+    end = std::max(end, responses.rbegin ()->first);
+  advance(end);
+
+  stats.wallTime = elapsed(begin);
+  stats.updateIntervals = platform.now () / ParameterConfiguration::getInstance ()->getParameter ("UPDATE_INTERVALL");
+
+  long after = getResidentMemory ();
+  stats.memoryGrowth = (memory < 0 || after < 0) ? -1 : after - memory;
+}
+
+void SAFReplay::advance(double time)
+{
+  //answers and engine timers are interleaved in time order, answers may schedule further answers
+  while(!responses.empty () && responses.begin ()->first <= time)
+  {
+    std::multimap<double, Response>::iterator it = responses.begin ();
+    runTimers(it->first);
+    Response response = it->second;
+    responses.erase (it);
+    onResponse(response);
+  }
+  runTimers(time);
+}
+
+void SAFReplay::runTimers(double time)
+{
+  boost::chrono::steady_clock::time_point begin = boost::chrono::steady_clock::now ();
+  if(platform.run (time) == 0)
+    return;
+
+  double duration = elapsed(begin);
+  stats.maintenanceTime += duration;
+  stats.maxMaintenanceTime = std::max(stats.maxMaintenanceTime, duration);
+}
+
+void SAFReplay::onInterest(const SAFReplayTrace::Event& e)
+{
+  nfd::Name name = getName(e);
+  stats.interests++;
+  if(!requested[e.prefix])
+  {
+    requested[e.prefix] = true;
+    stats.prefixes++;
+  }
+
+  Interest interest(name);
+  interest.setInterestLifetime (time::milliseconds((long) (trace.interestLifetime * 1000)));
+
+  //the pending interest answers the aggregated one as well
+  PendingMap::iterator it = pending.find (name);
+  if(it != pending.end ())
+  {
+    it->second.entry->insertOrUpdateInRecord (faces[e.face], interest);
+    return;
+  }
+
+  PendingInterest p;
+  p.entry = make_shared<pit::Entry>(interest);
+  p.entry->insertOrUpdateInRecord (faces[e.face], interest);
+  p.modeled = (e.flags & SAFReplayTrace::ModeledResponse) != 0;
+  p.arrival = platform.now ();
+  pending[name] = p;
+
+  Response expiry;
+  expiry.type = SAFReplayTrace::Expire;
+  expiry.entry = p.entry;
+  expiry.face = 0;
+  responses.insert (std::make_pair(platform.now () + trace.interestLifetime, expiry));
+
+  forwardInterest(p.entry, std::vector<int>());
+}
+
+void SAFReplay::onResponse(const Response& response)
+{
+  //the interest may have been answered, rejected or replaced by a new one of the same name meanwhile
+  PendingMap::iterator it = pending.find (response.entry->getName ());
+  if(it == pending.end () || it->second.entry != response.entry)
+    return;
+
+  if(response.type == SAFReplayTrace::Expire)
+  {
+    expireInterest(response.entry);
+    return;
+  }
+
+  if(faceDown[faceIndex[response.face]]) // failed faces do not answer, the interest expires
+    return;
+
+  if(response.type == SAFReplayTrace::Data)
+    satisfyInterest(response.entry, response.face);
+  else
+    nackInterest(response.entry, response.face);
+}
+
+void SAFReplay::satisfyInterest(shared_ptr<pit::Entry> pitEntry, int faceId)
+{
+  shared_ptr<Face> inFace = forwarder.getFace (faceId);
+
+  //recorded answers may come from a face the engine did not pick, the recording sent it when the interest arrived
+  if(pitEntry->getOutRecord (*inFace) == pitEntry->getOutRecords ().end ())
+  {
+    pitEntry->insertOrUpdateOutRecord (inFace, pitEntry->getInterest ());
+    SAFSendTimes::stamp (pitEntry, faceId, pending[pitEntry->getName ()].arrival);
+  }
+
+  const nfd::pit::OutRecordCollection& records = pitEntry->getOutRecords ();
+  for(nfd::pit::OutRecordCollection::const_iterator it = records.begin (); it != records.end (); ++it)
+  {
+    if((*it).getFace()->getId() != faceId)
+      engine->logNack (*(*it).getFace(), pitEntry->getInterest ()); // as the strategy does
+  }
+
+  Data data(pitEntry->getName ());
+  engine->logSatisfiedInterest (pitEntry, *inFace, data);
+
+  stats.satisfied++;
+  pending.erase (pitEntry->getName ());
+}
+
+void SAFReplay::nackInterest(shared_ptr<pit::Entry> pitEntry, int faceId)
+{
+  //the nack is counted when the interest is satisfied or rejected, just try the remaining faces
+  stats.nacked++;
+  forwardInterest(pitEntry, getAllOutFaces(pitEntry));
+}
+
+void SAFReplay::expireInterest(shared_ptr<pit::Entry> pitEntry)
+{
+  engine->logExpiredInterest (pitEntry);
+
+  stats.expired++;
+  pending.erase (pitEntry->getName ());
+}
+
+void SAFReplay::forwardInterest(shared_ptr<pit::Entry> pitEntry, std::vector<int> alreadyTriedFaces)
+{
+  std::vector<int> originInFaces = getAllInFaces(pitEntry);
+  const Interest& interest = pitEntry->getInterest ();
+
+  boost::chrono::steady_clock::time_point begin = boost::chrono::steady_clock::now ();
+  int nextHop = engine->determineNextHop (interest, alreadyTriedFaces, fibEntry);
+  stats.decisions++;
+
+  if(nextHop != DROP_FACE_ID && std::find(originInFaces.begin (), originInFaces.end (), nextHop) == originInFaces.end ())
+  {
+    //the limits are disabled in the strategy, the result is ignored there as well
+    engine->tryForwardInterest (interest, forwarder.getFace (nextHop));
+    stats.decisionTime += elapsed(begin);
+
+    pitEntry->insertOrUpdateOutRecord (forwarder.getFace (nextHop), interest);
+    engine->logForwardedInterest (pitEntry, nextHop);
+    if(pending[pitEntry->getName ()].modeled)
+      scheduleResponse(pitEntry, nextHop);
+    return;
+  }
+  stats.decisionTime += elapsed(begin);
+
+  for(unsigned int i = 0; i < alreadyTriedFaces.size (); i++)
+    engine->logRejectedInterest (pitEntry, alreadyTriedFaces.at (i));
+  engine->logRejectedInterest (pitEntry, nextHop);
+
+  stats.rejected++;
+  pending.erase (pitEntry->getName ());
+}
+
+void SAFReplay::scheduleResponse(shared_ptr<pit::Entry> pitEntry, int faceId)
+{
+  const SAFReplayTrace::Face& face = trace.faces[faceIndex[faceId]];
+
+  Response response;
+  response.type = randomVariable->getValue () < face.satisfaction ? SAFReplayTrace::Data : SAFReplayTrace::Nack;
+  response.entry = pitEntry;
+  response.face = faceId;
+  responses.insert (std::make_pair(platform.now () + face.delay, response));
+}
+
+nfd::Name SAFReplay::getName(const SAFReplayTrace::Event& e)
+{
+  return nfd::Name(trace.prefixes[e.prefix]).appendSequenceNumber (e.sequence);
+}
+
+std::vector<int> SAFReplay::getAllInFaces(shared_ptr<pit::Entry> pitEntry)
+{
+  std::vector<int> faces;
+  const nfd::pit::InRecordCollection records = pitEntry->getInRecords();
+
+  for(nfd::pit::InRecordCollection::const_iterator it = records.begin (); it!=records.end (); ++it)
+    faces.push_back((*it).getFace()->getId());
+
+  return faces;
+}
+
+std::vector<int> SAFReplay::getAllOutFaces(shared_ptr<pit::Entry> pitEntry)
+{
+  std::vector<int> faces;
+  const nfd::pit::OutRecordCollection records = pitEntry->getOutRecords();
+
+  for(nfd::pit::OutRecordCollection::const_iterator it = records.begin (); it!=records.end (); ++it)
+    faces.push_back((*it).getFace()->getId());
+
+  return faces;
+}
+
+long SAFReplay::getResidentMemory()
+{
+  FILE* f = fopen("/proc/self/statm", "r");
+  if(f == NULL)
+    return -1;
+
+  long size = 0, resident = 0;
+  int n = fscanf(f, "%ld %ld", &size, &resident);
+  fclose(f);
+
+  if(n != 2)
+    return -1;
+  return resident * sysconf(_SC_PAGESIZE);
+}
+
+void SAFReplay::printStatistics(FILE* out)
+{
+  fprintf(out, "events:               %lu\n", (unsigned long) stats.events);
+  fprintf(out, "interests:            %lu (%lu prefixes)\n", (unsigned long) stats.interests, (unsigned long) stats.prefixes);
+  fprintf(out, "satisfied:            %lu (%.2f%%)\n", (unsigned long) stats.satisfied,
+          stats.interests > 0 ? 100.0 * stats.satisfied / stats.interests : 0.0);
+  fprintf(out, "nacked/expired/rejected: %lu/%lu/%lu\n", (unsigned long) stats.nacked, (unsigned long) stats.expired, (unsigned long) stats.rejected);
+  fprintf(out, "decisions per second: %.0f\n", stats.decisionTime > 0 ? stats.decisions / stats.decisionTime : 0.0);
+  fprintf(out, "update latency:       %.3f ms per update interval (max %.3f ms)\n",
+          stats.updateIntervals > 0 ? 1000.0 * stats.maintenanceTime / stats.updateIntervals : 0.0, 1000.0 * stats.maxMaintenanceTime);
+  if(stats.memoryGrowth >= 0 && stats.prefixes > 0)
+    fprintf(out, "memory per prefix:    %.0f bytes\n", (double) stats.memoryGrowth / stats.prefixes);
+  fprintf(out, "wall time:            %.3f s\n", stats.wallTime);
+}
@@ -0,0 +1,186 @@
+/**
+ * Copyright (c) 2015 Daniel Posch (Alpen-Adria Universität Klagenfurt)
+ *
+ * This file is part of the ndnSIM extension for Stochastic Adaptive Forwarding (SAF).
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef SAFREPLAY_H
+#define SAFREPLAY_H
+
+#include "fw/forwarder.hpp"
+#include "fw/strategy.hpp"
+#include "face/face.hpp"
+#include "../fw/safengine.h"
+#include "../fw/mdelay.h"
+#include "../fw/platform/standaloneplatform.h"
+#include "safreplaytrace.h"
+
+#include <boost/shared_ptr.hpp>
+#include <cstdio>
+#include <map>
+#include <vector>
+
+namespace nfd
+{
+namespace fw
+{
+
+/**
+ * @brief The ReplayFace class is a face that drops everything sent on it, the replay only feeds the events of the trace.
+ */
+class ReplayFace : public Face
+{
+public:
+  ReplayFace(const std::string& remote);
+
+  virtual void sendInterest(const Interest& interest){}
+  virtual void sendData(const Data& data){}
+  virtual void close(){}
+};
+
+/**
+ * @brief The ReplayStrategy class only provides the measurements table of its namespace to the replayed engine.
+ */
+class ReplayStrategy : public Strategy
+{
+public:
+  ReplayStrategy(Forwarder& forwarder);
+
+  virtual void afterReceiveInterest(const Face& inFace, const Interest& interest,
+                                    shared_ptr<fib::Entry> fibEntry, shared_ptr<pit::Entry> pitEntry){}
+
+  MeasurementsAccessor& getMeasurementsAccessor(){return getMeasurements();}
+
+  static const Name STRATEGY_NAME;
+};
+
+/**
+ * @brief The SAFReplay class replays a trace into a SAFEngine without packet level simulation.
+ * Forwarding decisions, satisfactions, nacks and expiries are fed to the engine in the same order the SAF strategy
+ * would do, while the engine timers run on the virtual clock of a StandalonePlatform.
+ *
+ * Interests flagged as modeled response are answered by the model of the upstream face the engine picked, other
+ * answers are taken from the trace as recorded (open loop). NFD's own clock does not advance during a replay, so the
+ * send times MDelay measures against are stamped with the platform clock (SAFEngine::logForwardedInterest), the
+ * measurements lifetime however does not behave as in a simulation.
+ */
+class SAFReplay
+{
+public:
+
+  struct Statistics
+  {
+    uint64_t events;
+    uint64_t interests;
+    uint64_t decisions; /*calls of determineNextHop*/
+    uint64_t satisfied;
+    uint64_t nacked;
+    uint64_t expired;
+    uint64_t rejected; /*interests the engine dropped*/
+    uint64_t prefixes; /*distinct prefixes of the catalog requested*/
+    double decisionTime; /*wall clock seconds spent in forwarding decisions*/
+    double maintenanceTime; /*wall clock seconds spent in engine timers (table updates, token refills)*/
+    double maxMaintenanceTime; /*longest time the timers of a single point in time took*/
+    double updateIntervals; /*number of UPDATE_INTERVALLs replayed*/
+    double wallTime; /*wall clock seconds of the replay*/
+    long memoryGrowth; /*bytes of resident memory the replay allocated, -1 if unknown*/
+  };
+
+  /**
+   * @brief sets up a forwarder with the faces of the trace and a fib entry for / via all upstream faces.
+   * @param trace the trace
+   * @param platform the platform, has to be installed as SAFPlatform
+   */
+  SAFReplay(const SAFReplayTrace& trace, StandalonePlatform& platform);
+  ~SAFReplay();
+
+  /**
+   * @brief replays all events of the trace.
+   */
+  void run();
+
+  const Statistics& getStatistics(){return stats;}
+
+  /**
+   * @brief prints the statistics as a human readable summary.
+   */
+  void printStatistics(FILE* out);
+
+  /**
+   * @brief the resident memory of the process in bytes, -1 if unknown.
+   */
+  static long getResidentMemory();
+
+protected:
+
+  struct PendingInterest
+  {
+    shared_ptr<pit::Entry> entry;
+    bool modeled; /*answered by the model of the upstream faces*/
+    double arrival; /*platform time the interest arrived*/
+  };
+
+  struct Response
+  {
+    uint8_t type; /*SAFReplayTrace::EventType*/
+    shared_ptr<pit::Entry> entry;
+    int face; /*face ID*/
+  };
+
+  void onInterest(const SAFReplayTrace::Event& e);
+  void onResponse(const Response& response);
+  void satisfyInterest(shared_ptr<pit::Entry> pitEntry, int faceId);
+  void nackInterest(shared_ptr<pit::Entry> pitEntry, int faceId);
+  void expireInterest(shared_ptr<pit::Entry> pitEntry);
+  void forwardInterest(shared_ptr<pit::Entry> pitEntry, std::vector<int> alreadyTriedFaces);
+  void scheduleResponse(shared_ptr<pit::Entry> pitEntry, int faceId);
+
+  /**
+   * @brief delivers all answers and runs all engine timers due until the given time.
+   */
+  void advance(double time);
+  void runTimers(double time);
+  nfd::Name getName(const SAFReplayTrace::Event& e);
+
+  std::vector<int> getAllInFaces(shared_ptr<pit::Entry> pitEntry);
+  std::vector<int> getAllOutFaces(shared_ptr<pit::Entry> pitEntry);
+
+  const SAFReplayTrace& trace;
+  StandalonePlatform& platform;
+  boost::shared_ptr<SAFRandomStream> randomVariable;
+
+  Forwarder forwarder;
+  shared_ptr<ReplayStrategy> strategy;
+  shared_ptr<fib::Entry> fibEntry;
+  boost::shared_ptr<SAFEngine> engine;
+
+  std::vector<shared_ptr<Face> > faces; /*by index of the trace*/
+  std::map<int /*face ID*/, uint16_t /*index of the trace*/> faceIndex;
+  std::vector<bool> faceDown;
+
+  typedef std::map
+    < nfd::Name, /*name of the interest*/
+      PendingInterest
+    > PendingMap;
+
+  PendingMap pending; /*interests waiting for an answer*/
+  std::multimap<double /*time*/, Response> responses; /*modeled answers and expiries*/
+  std::vector<bool> requested; /*by prefix index*/
+
+  Statistics stats;
+};
+
+}
+}
+#endif // SAFREPLAY_H
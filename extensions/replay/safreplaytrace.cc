@@ -0,0 +1,199 @@
+#include "safreplaytrace.h"
+#include "../utils/checkpoint.h"
+#include <fstream>
+#include <cstdio>
+#include <cmath>
+#include <limits>
+
+using namespace nfd;
+using namespace nfd::fw;
+
+namespace
+{
+
+//the on-disk record, times are stored as deltas to keep the record small
+struct PackedEvent
+{
+  uint32_t delta; /*microseconds since the previous event*/
+  uint8_t type;
+  uint8_t flags;
+  uint16_t face;
+  uint32_t prefix;
+  uint32_t sequence;
+};
+
+const uint8_t GAP_RECORD = 0xFF; /*only advances the time, for gaps above the range of a delta (~71 minutes)*/
+const uint64_t MAX_DELTA = std::numeric_limits<uint32_t>::max ();
+
+}
+
+SAFReplayTrace::SAFReplayTrace()
+{
+  interestLifetime = 2.0;
+}
+
+bool SAFReplayTrace::read(std::string file)
+{
+  std::ifstream in(file.c_str (), std::ios::in | std::ios::binary);
+  if(!in.is_open ())
+  {
+    fprintf(stderr, "Could not read replay trace %s\n", file.c_str ());
+    return false;
+  }
+
+  uint32_t magic = 0, version = 0;
+  checkpoint::read(in, magic);
+  checkpoint::read(in, version);
+  if(magic != REPLAY_TRACE_MAGIC || version < 1 || version > REPLAY_TRACE_VERSION)
+  {
+    fprintf(stderr, "%s is no replay trace (version %d)\n", file.c_str (), REPLAY_TRACE_VERSION);
+    return false;
+  }
+
+  checkpoint::read(in, interestLifetime);
+
+  uint32_t size = 0;
+  checkpoint::read(in, size);
+  faces.resize (size);
+  for(uint32_t i = 0; i < size && in.good (); i++)
+  {
+    uint8_t upstream = 0;
+    checkpoint::read(in, faces[i].remote);
+    checkpoint::read(in, upstream);
+    checkpoint::read(in, faces[i].bitrate);
+    checkpoint::read(in, faces[i].satisfaction);
+    checkpoint::read(in, faces[i].delay);
+    faces[i].upstream = upstream > 0;
+  }
+
+  checkpoint::read(in, prefixes);
+
+  uint64_t count = 0;
+  checkpoint::read(in, count);
+  if(!in.good ())
+  {
+    fprintf(stderr, "Replay trace %s is corrupt\n", file.c_str ());
+    return false;
+  }
+
+  //the count is not trusted before it is checked against the size of the file
+  std::streampos records = in.tellg ();
+  in.seekg (0, std::ios::end);
+  uint64_t available = (uint64_t) (in.tellg () - records) / sizeof(PackedEvent);
+  in.seekg (records);
+  if(count > available)
+  {
+    fprintf(stderr, "Replay trace %s is truncated, %llu of %llu records\n", file.c_str (), (unsigned long long) available,
+            (unsigned long long) count);
+    return false;
+  }
+
+  events.clear ();
+  events.reserve (count);
+
+  uint64_t time = 0; // microseconds, summing up the deltas in doubles would drift
+  uint64_t read = 0;
+  std::vector<PackedEvent> buffer(4096);
+  while(read < count)
+  {
+    size_t n = std::min<uint64_t>(buffer.size (), count - read);
+    in.read ((char*) &buffer[0], n * sizeof(PackedEvent));
+    if((size_t) in.gcount () != n * sizeof(PackedEvent))
+    {
+      fprintf(stderr, "Replay trace %s is truncated after %lu events\n", file.c_str (), (unsigned long) events.size ());
+      return false;
+    }
+    read += n;
+
+    for(size_t i = 0; i < n; i++)
+    {
+      time += buffer[i].delta;
+      if(buffer[i].type == GAP_RECORD)
+        continue;
+
+      Event e;
+      e.time = time / 1000000.0;
+      e.type = buffer[i].type;
+      e.flags = buffer[i].flags;
+      e.face = buffer[i].face;
+      e.prefix = buffer[i].prefix;
+      e.sequence = buffer[i].sequence;
+
+      if(e.face >= faces.size () || (e.type <= Expire && e.prefix >= prefixes.size ()))
+      {
+        fprintf(stderr, "Replay trace %s references an unknown face or prefix\n", file.c_str ());
+        return false;
+      }
+      events.push_back (e);
+    }
+  }
+  return true;
+}
+
+bool SAFReplayTrace::write(std::string file)
+{
+  std::ofstream out(file.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+  if(!out.is_open ())
+  {
+    fprintf(stderr, "Could not write replay trace %s\n", file.c_str ());
+    return false;
+  }
+
+  checkpoint::write<uint32_t>(out, REPLAY_TRACE_MAGIC);
+  checkpoint::write<uint32_t>(out, REPLAY_TRACE_VERSION);
+  checkpoint::write(out, interestLifetime);
+
+  checkpoint::write<uint32_t>(out, faces.size ());
+  for(std::vector<Face>::iterator it = faces.begin (); it != faces.end (); ++it)
+  {
+    checkpoint::write(out, it->remote);
+    checkpoint::write<uint8_t>(out, it->upstream ? 1 : 0);
+    checkpoint::write(out, it->bitrate);
+    checkpoint::write(out, it->satisfaction);
+    checkpoint::write(out, it->delay);
+  }
+
+  checkpoint::write(out, prefixes);
+
+  //the number of records includes the gap records, so the times are checked first
+  uint64_t records = 0;
+  uint64_t last = 0;
+  for(std::vector<Event>::iterator it = events.begin (); it != events.end (); ++it)
+  {
+    uint64_t time = (uint64_t) llround(it->time * 1000000.0);
+    if(time < last)
+    {
+      fprintf(stderr, "Replay trace events are not ordered by time\n");
+      return false;
+    }
+    records += 1 + (time > last ? (time - last - 1) / MAX_DELTA : 0);
+    last = time;
+  }
+  checkpoint::write<uint64_t>(out, records);
+
+  last = 0;
+  for(std::vector<Event>::iterator it = events.begin (); it != events.end (); ++it)
+  {
+    uint64_t time = (uint64_t) llround(it->time * 1000000.0);
+    for(; time - last > MAX_DELTA; last += MAX_DELTA)
+    {
+      PackedEvent gap = PackedEvent();
+      gap.delta = (uint32_t) MAX_DELTA;
+      gap.type = GAP_RECORD;
+      out.write ((const char*) &gap, sizeof(PackedEvent));
+    }
+
+    PackedEvent e;
+    e.delta = (uint32_t) (time - last);
+    e.type = it->type;
+    e.flags = it->flags;
+    e.face = it->face;
+    e.prefix = it->prefix;
+    e.sequence = it->sequence;
+    out.write ((const char*) &e, sizeof(PackedEvent));
+
+    last = time;
+  }
+
+  return out.good ();
+}
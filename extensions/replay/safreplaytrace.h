@@ -0,0 +1,101 @@
+/**
+ * Copyright (c) 2015 Daniel Posch (Alpen-Adria Universität Klagenfurt)
+ *
+ * This file is part of the ndnSIM extension for Stochastic Adaptive Forwarding (SAF).
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef SAFREPLAYTRACE_H
+#define SAFREPLAYTRACE_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#define REPLAY_TRACE_MAGIC 0x54464153 // "SAFT"
+#define REPLAY_TRACE_VERSION 2 // version 2 added gap records, version 1 traces are still read
+
+namespace nfd
+{
+namespace fw
+{
+
+/**
+ * @brief The SAFReplayTrace class holds an event stream of a single node that can be replayed into a SAFEngine.
+ *
+ * The file starts with a header (faces of the node, catalog of content prefixes), followed by fixed size records
+ * of 16 byte: time delta in microseconds (uint32), type (uint8), flags (uint8), face index (uint16),
+ * prefix index (uint32) and sequence number (uint32). All values are stored in host byte order.
+ * Gaps between events that do not fit into a delta are bridged by gap records, which carry only a delta.
+ */
+class SAFReplayTrace
+{
+public:
+
+  enum EventType
+  {
+    Interest = 0, /*interest received on a downstream face*/
+    Data = 1, /*interest satisfied by an upstream face*/
+    Nack = 2, /*interest nacked by an upstream face*/
+    Expire = 3, /*interest expired*/
+    FaceDown = 4, /*failure injection, the face neither answers nor nacks any more*/
+    FaceUp = 5 /*the face recovered*/
+  };
+
+  enum EventFlags
+  {
+    ModeledResponse = 1 /*the answer of the interest is drawn from the model of the upstream face instead of the trace*/
+  };
+
+  struct Event
+  {
+    double time; /*seconds since the start of the trace*/
+    uint8_t type;
+    uint8_t flags;
+    uint16_t face; /*index into the faces of the trace*/
+    uint32_t prefix; /*index into the prefixes of the trace*/
+    uint32_t sequence;
+  };
+
+  struct Face
+  {
+    std::string remote; /*name of the node at the other side*/
+    bool upstream; /*upstream faces are next hops of the fib entry*/
+    uint64_t bitrate; /*bit/s*/
+    double satisfaction; /*probability a modeled response is data, else a nack*/
+    double delay; /*seconds until a modeled response arrives*/
+  };
+
+  SAFReplayTrace();
+
+  /**
+   * @brief reads a trace.
+   * @return false if the file could not be read or is no trace.
+   */
+  bool read(std::string file);
+
+  /**
+   * @brief writes the trace, the events have to be ordered by time.
+   * @return false if the file could not be written.
+   */
+  bool write(std::string file);
+
+  std::vector<Face> faces;
+  std::vector<std::string> prefixes;
+  std::vector<Event> events;
+  double interestLifetime; /*seconds until an unanswered interest expires*/
+};
+
+}
+}
+#endif // SAFREPLAYTRACE_H
@@ -0,0 +1,136 @@
+#include "saftracegenerator.h"
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_01.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
+#include <boost/random/exponential_distribution.hpp>
+#include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+using namespace nfd;
+using namespace nfd::fw;
+
+namespace
+{
+
+bool earlier(const SAFReplayTrace::Event& a, const SAFReplayTrace::Event& b)
+{
+  return a.time < b.time;
+}
+
+}
+
+SAFTraceGenerator::SAFTraceGenerator()
+{
+  catalogPrefix = "/catalog";
+  catalogSize = 1000;
+  zipfAlpha = 0.8;
+  interestRate = 1000.0;
+  duration = 60.0;
+  interestLifetime = 2.0;
+  seed = 1;
+}
+
+void SAFTraceGenerator::addDownstreamFace(std::string remote, uint64_t bitrate)
+{
+  SAFReplayTrace::Face face;
+  face.remote = remote;
+  face.upstream = false;
+  face.bitrate = bitrate;
+  face.satisfaction = 0.0;
+  face.delay = 0.0;
+  faces.push_back (face);
+}
+
+uint16_t SAFTraceGenerator::addUpstreamFace(std::string remote, uint64_t bitrate, double satisfaction, double delay)
+{
+  SAFReplayTrace::Face face;
+  face.remote = remote;
+  face.upstream = true;
+  face.bitrate = bitrate;
+  face.satisfaction = satisfaction;
+  face.delay = delay;
+  faces.push_back (face);
+  return faces.size () - 1;
+}
+
+void SAFTraceGenerator::addFailure(uint16_t face, double start, double end)
+{
+  Failure f;
+  f.face = face;
+  f.start = start;
+  f.end = end;
+  failures.push_back (f);
+}
+
+void SAFTraceGenerator::generate(SAFReplayTrace& trace)
+{
+  trace.faces = faces;
+  trace.interestLifetime = interestLifetime;
+  trace.prefixes.clear ();
+  trace.events.clear ();
+
+  std::vector<uint16_t> downstream;
+  for(uint16_t i = 0; i < faces.size (); i++)
+    if(!faces[i].upstream)
+      downstream.push_back (i);
+
+  if(downstream.empty () || catalogSize == 0)
+  {
+    fprintf(stderr, "A replay trace needs at least one downstream face and a catalog\n");
+    return;
+  }
+
+  //cumulative zipf popularity, ranks are drawn by binary search
+  std::vector<double> cdf(catalogSize);
+  double sum = 0.0;
+  for(uint32_t rank = 0; rank < catalogSize; rank++)
+  {
+    sum += 1.0 / pow(rank + 1, zipfAlpha);
+    cdf[rank] = sum;
+    trace.prefixes.push_back (catalogPrefix + "/" + boost::lexical_cast<std::string>(rank));
+  }
+
+  boost::random::mt19937 generator(seed);
+  boost::random::uniform_01<double> uniform;
+  boost::random::exponential_distribution<double> interArrival(interestRate);
+  boost::random::uniform_int_distribution<size_t> downstreamFace(0, downstream.size () - 1);
+
+  std::vector<uint32_t> sequences(catalogSize, 0);
+
+  trace.events.reserve ((size_t) (interestRate * duration) + 2 * failures.size ());
+  for(double time = interArrival(generator); time < duration; time += interArrival(generator))
+  {
+    uint32_t rank = std::lower_bound(cdf.begin (), cdf.end (), uniform(generator) * sum) - cdf.begin ();
+    rank = std::min(rank, catalogSize - 1);
+
+    SAFReplayTrace::Event e;
+    e.time = time;
+    e.type = SAFReplayTrace::Interest;
+    e.flags = SAFReplayTrace::ModeledResponse;
+    e.face = downstream[downstreamFace(generator)];
+    e.prefix = rank;
+    e.sequence = sequences[rank]++;
+    trace.events.push_back (e);
+  }
+
+  for(std::vector<Failure>::iterator it = failures.begin (); it != failures.end (); ++it)
+  {
+    SAFReplayTrace::Event e;
+    e.flags = 0;
+    e.face = it->face;
+    e.prefix = 0;
+    e.sequence = 0;
+
+    e.time = it->start;
+    e.type = SAFReplayTrace::FaceDown;
+    trace.events.push_back (e);
+
+    e.time = it->end;
+    e.type = SAFReplayTrace::FaceUp;
+    trace.events.push_back (e);
+  }
+
+  std::stable_sort(trace.events.begin (), trace.events.end (), earlier);
+}
@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) 2015 Daniel Posch (Alpen-Adria Universität Klagenfurt)
+ *
+ * This file is part of the ndnSIM extension for Stochastic Adaptive Forwarding (SAF).
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef SAFTRACEGENERATOR_H
+#define SAFTRACEGENERATOR_H
+
+#include "safreplaytrace.h"
+
+namespace nfd
+{
+namespace fw
+{
+
+/**
+ * @brief The SAFTraceGenerator class creates synthetic replay traces.
+ * Interests arrive as a poisson process on the downstream faces and request prefixes of a catalog with zipf
+ * distributed popularity. The answers are modeled by the upstream faces (satisfaction ratio and delay), failures
+ * take an upstream face down for a period of time.
+ */
+class SAFTraceGenerator
+{
+public:
+
+  struct Failure
+  {
+    uint16_t face; /*index of the upstream face*/
+    double start; /*seconds*/
+    double end; /*seconds*/
+  };
+
+  SAFTraceGenerator();
+
+  /**
+   * @brief adds a downstream face the interests arrive on.
+   */
+  void addDownstreamFace(std::string remote, uint64_t bitrate);
+
+  /**
+   * @brief adds an upstream face.
+   * @param satisfaction the probability an interest is answered by data, else by a nack
+   * @param delay the delay of the answer in seconds
+   * @return the index of the face
+   */
+  uint16_t addUpstreamFace(std::string remote, uint64_t bitrate, double satisfaction, double delay);
+
+  /**
+   * @brief takes an upstream face down between start and end.
+   */
+  void addFailure(uint16_t face, double start, double end);
+
+  /**
+   * @brief generates the trace.
+   * @param trace the generated trace
+   */
+  void generate(SAFReplayTrace& trace);
+
+  std::string catalogPrefix; /*the prefixes are catalogPrefix/0 ... catalogPrefix/(catalogSize-1)*/
+  uint32_t catalogSize;
+  double zipfAlpha;
+  double interestRate; /*interests per second, over all downstream faces*/
+  double duration; /*seconds*/
+  double interestLifetime; /*seconds*/
+  uint32_t seed;
+
+protected:
+  std::vector<SAFReplayTrace::Face> faces;
+  std::vector<Failure> failures;
+};
+
+}
+}
+#endif // SAFTRACEGENERATOR_H
@@ -0,0 +1,106 @@
+#include "checkpoint.h"
+#include "../fw/platform/safplatform.h"
+#include <boost/bind.hpp>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cstdio>
+
+CheckpointRegistry* CheckpointRegistry::instance = NULL;
+
+CheckpointRegistry::CheckpointRegistry()
+{
+}
+
+CheckpointRegistry* CheckpointRegistry::getInstance()
+{
+  if(instance == NULL)
+    instance = new CheckpointRegistry();
+
+  return instance;
+}
+
+void CheckpointRegistry::registerComponent(Checkpointable* component)
+{
+  components.push_back (component);
+
+  SectionMap::iterator it = sections.find (component->getCheckpointKey ());
+  if(it != sections.end ())
+  {
+    std::istringstream is(it->second);
+    component->loadCheckpoint (is);
+  }
+}
+
+void CheckpointRegistry::unregisterComponent(Checkpointable* component)
+{
+  components.remove (component);
+}
+
+void CheckpointRegistry::scheduleCheckpoint(double time, std::string file)
+{
+  nfd::fw::SAFPlatform* platform = nfd::fw::SAFPlatform::getInstance ();
+  platform->schedule(time - platform->now (), boost::bind(&CheckpointRegistry::save, this, file));
+}
+
+bool CheckpointRegistry::save(std::string file)
+{
+  std::ofstream out(file.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+  if(!out.is_open ())
+  {
+    fprintf(stderr, "Could not write checkpoint %s\n", file.c_str ());
+    return false;
+  }
+
+  checkpoint::write<uint32_t>(out, CHECKPOINT_MAGIC);
+  checkpoint::write<uint32_t>(out, components.size ());
+  for(std::list<Checkpointable*>::iterator it = components.begin (); it != components.end (); ++it)
+  {
+    std::ostringstream os;
+    (*it)->saveCheckpoint (os);
+    checkpoint::write(out, (*it)->getCheckpointKey ());
+    checkpoint::write(out, os.str ());
+  }
+
+  fprintf(stderr, "Checkpoint of %lu components written to %s at %.2fs\n",
+          (unsigned long) components.size (), file.c_str (), nfd::fw::SAFPlatform::getInstance ()->now ());
+  return out.good ();
+}
+
+bool CheckpointRegistry::load(std::string file)
+{
+  std::ifstream in(file.c_str (), std::ios::in | std::ios::binary);
+  if(!in.is_open ())
+  {
+    fprintf(stderr, "Could not read checkpoint %s\n", file.c_str ());
+    return false;
+  }
+
+  uint32_t magic = 0, size = 0;
+  checkpoint::read(in, magic);
+  checkpoint::read(in, size);
+  if(magic != CHECKPOINT_MAGIC)
+  {
+    fprintf(stderr, "Invalid checkpoint %s\n", file.c_str ());
+    return false;
+  }
+
+  sections.clear ();
+  for(uint32_t i = 0; i < size && in.good (); i++)
+  {
+    std::string key;
+    checkpoint::read(in, key);
+    checkpoint::read(in, sections[key]);
+  }
+
+  for(std::list<Checkpointable*>::iterator it = components.begin (); it != components.end (); ++it)
+  {
+    SectionMap::iterator s = sections.find ((*it)->getCheckpointKey ());
+    if(s == sections.end ())
+      continue;
+
+    std::istringstream is(s->second);
+    (*it)->loadCheckpoint (is);
+  }
+  return true;
+}
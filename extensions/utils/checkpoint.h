@@ -0,0 +1,228 @@
+/**
+ * Copyright (c) 2015 Daniel Posch (Alpen-Adria Universität Klagenfurt)
+ *
+ * This file is part of the ndnSIM extension for Stochastic Adaptive Forwarding (SAF).
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstddef>
+#include <iostream>
+#include <sstream>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#define CHECKPOINT_MAGIC 0x53414643 // "SAFC"
+
+/**
+ * @brief The Checkpointable interface is implemented by components whose learned state is part of a checkpoint.
+ */
+class Checkpointable
+{
+public:
+  virtual ~Checkpointable(){}
+
+  /**
+   * @brief a key that identifies the component in a checkpoint, unique per simulation (e.g. strategy and node name).
+   */
+  virtual std::string getCheckpointKey() = 0;
+
+  /**
+   * @brief writes the state of the component.
+   */
+  virtual void saveCheckpoint(std::ostream& os) = 0;
+
+  /**
+   * @brief restores the state of the component from the data written by saveCheckpoint.
+   */
+  virtual void loadCheckpoint(std::istream& is) = 0;
+};
+
+/**
+ * @brief The CheckpointRegistry class saves and restores the state of all registered components.
+ * A checkpoint taken at a given simulation time can be loaded into a new run, e.g. with different parameters,
+ * so the run starts with the learned state instead of repeating the warm-up.
+ * Only the state of the registered components is checkpointed, not the simulator itself
+ * (pending events, PIT entries, applications), the new run starts at time 0.
+ * The class uses a singleton pattern.
+ */
+class CheckpointRegistry
+{
+public:
+
+  /**
+   * @brief returns the singleton instance.
+   * @return
+   */
+  static CheckpointRegistry* getInstance();
+
+  /**
+   * @brief registers a component, a section of a loaded checkpoint with the key of the component is restored immediately.
+   */
+  void registerComponent(Checkpointable* component);
+  void unregisterComponent(Checkpointable* component);
+
+  /**
+   * @brief schedules a checkpoint.
+   * @param time the simulation time in seconds
+   * @param file the checkpoint file
+   */
+  void scheduleCheckpoint(double time, std::string file);
+
+  /**
+   * @brief writes the state of all registered components.
+   * @param file the checkpoint file
+   * @return false if the file could not be written.
+   */
+  bool save(std::string file);
+
+  /**
+   * @brief loads a checkpoint and restores all registered components, components registered later are restored on registration.
+   * @param file the checkpoint file
+   * @return false if the file could not be read.
+   */
+  bool load(std::string file);
+
+protected:
+  CheckpointRegistry();
+
+  static CheckpointRegistry* instance;
+
+  std::list<Checkpointable*> components;
+
+  std::map<
+  std::string /*key*/,
+  std::string /*state*/
+  > typedef SectionMap;
+
+  SectionMap sections; /*sections of the loaded checkpoint*/
+};
+
+/**
+ * @brief binary (host byte order) serialization helpers for checkpoints.
+ */
+namespace checkpoint
+{
+
+//containers may be nested, so all overloads are declared first
+template<typename K, typename V> void write(std::ostream& os, const std::map<K, V>& values);
+template<typename K, typename V> void read(std::istream& is, std::map<K, V>& values);
+template<typename T> void write(std::ostream& os, const std::vector<T>& values);
+template<typename T> void read(std::istream& is, std::vector<T>& values);
+template<typename T> void write(std::ostream& os, const std::list<T>& values);
+template<typename T> void read(std::istream& is, std::list<T>& values);
+
+template<typename T>
+void write(std::ostream& os, const T& value)
+{
+  os.write ((const char*) &value, sizeof(T));
+}
+
+template<typename T>
+void read(std::istream& is, T& value)
+{
+  is.read ((char*) &value, sizeof(T));
+}
+
+inline void write(std::ostream& os, const std::string& value)
+{
+  write<uint32_t>(os, value.size ());
+  os.write (value.data (), value.size ());
+}
+
+inline void read(std::istream& is, std::string& value)
+{
+  uint32_t size = 0;
+  read(is, size);
+  value.resize (size);
+  if(size > 0)
+    is.read (&value[0], size);
+}
+
+template<typename K, typename V>
+void write(std::ostream& os, const std::map<K, V>& values)
+{
+  write<uint32_t>(os, values.size ());
+  for(typename std::map<K, V>::const_iterator it = values.begin (); it != values.end (); ++it)
+  {
+    write(os, it->first);
+    write(os, it->second);
+  }
+}
+
+template<typename K, typename V>
+void read(std::istream& is, std::map<K, V>& values)
+{
+  uint32_t size = 0;
+  read(is, size);
+  values.clear ();
+  for(uint32_t i = 0; i < size && is.good (); i++)
+  {
+    K key;
+    read(is, key);
+    read(is, values[key]);
+  }
+}
+
+template<typename T>
+void write(std::ostream& os, const std::vector<T>& values)
+{
+  write<uint32_t>(os, values.size ());
+  for(typename std::vector<T>::const_iterator it = values.begin (); it != values.end (); ++it)
+    write(os, *it);
+}
+
+template<typename T>
+void read(std::istream& is, std::vector<T>& values)
+{
+  uint32_t size = 0;
+  read(is, size);
+  values.clear ();
+  for(uint32_t i = 0; i < size && is.good (); i++)
+  {
+    T value;
+    read(is, value);
+    values.push_back (value);
+  }
+}
+
+template<typename T>
+void write(std::ostream& os, const std::list<T>& values)
+{
+  write<uint32_t>(os, values.size ());
+  for(typename std::list<T>::const_iterator it = values.begin (); it != values.end (); ++it)
+    write(os, *it);
+}
+
+template<typename T>
+void read(std::istream& is, std::list<T>& values)
+{
+  uint32_t size = 0;
+  read(is, size);
+  values.clear ();
+  for(uint32_t i = 0; i < size && is.good (); i++)
+  {
+    T value;
+    read(is, value);
+    values.push_back (value);
+  }
+}
+
+}
+
+#endif // CHECKPOINT_H
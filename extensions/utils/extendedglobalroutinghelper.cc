@@ -1,7 +1,360 @@
 #include "extendedglobalroutinghelper.h"
 
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+NS_LOG_COMPONENT_DEFINE ("ndn.ExtendedGlobalRoutingHelper");
+
 using namespace ns3::ndn;
 
+namespace
+{
+
+const uint32_t UNREACHABLE = std::numeric_limits<uint32_t>::max ();
+
+/**
+ * @brief the routers and links of the topology in compressed sparse row form.
+ * The links leaving router i are [offsets[i], offsets[i+1]), the links entering router i are
+ * [reverseOffsets[i], reverseOffsets[i+1]) of the reverse arrays.
+ */
+struct RoutingGraph
+{
+  std::vector<ns3::Ptr<GlobalRouter> > routers;
+
+  std::vector<uint32_t> offsets;
+  std::vector<uint32_t> neighbors;
+  std::vector<uint32_t> metrics;
+  std::vector<shared_ptr<nfd::Face> > faces;
+
+  std::vector<uint32_t> reverseOffsets;
+  std::vector<uint32_t> reverseNeighbors;
+  std::vector<uint32_t> reverseMetrics;
+
+  std::vector<nfd::Name> prefixes;
+  std::vector<std::vector<uint32_t> > origins; /*routers announcing a prefix, by index of prefixes*/
+};
+
+struct Route
+{
+  uint32_t router;
+  uint32_t link;
+  uint32_t cost;
+
+  bool operator<(const Route& other) const
+  {
+    return router < other.router || (router == other.router && cost < other.cost);
+  }
+};
+
+void buildGraph(RoutingGraph& graph)
+{
+  std::map<GlobalRouter*, uint32_t> index;
+  for (ns3::NodeList::Iterator node = ns3::NodeList::Begin(); node != ns3::NodeList::End(); node++)
+  {
+    ns3::Ptr<GlobalRouter> gr = (*node)->GetObject<GlobalRouter>();
+    if (gr == 0)
+      continue;
+    index[ns3::PeekPointer (gr)] = graph.routers.size ();
+    graph.routers.push_back (gr);
+  }
+
+  uint32_t n = graph.routers.size ();
+  std::vector<uint32_t> inDegree(n, 0);
+  std::map<nfd::Name, uint32_t> prefixIndex;
+
+  graph.offsets.push_back (0);
+  for (uint32_t i = 0; i < n; i++)
+  {
+    GlobalRouter::IncidencyList& incidencies = graph.routers[i]->GetIncidencies ();
+    for (GlobalRouter::IncidencyList::iterator it = incidencies.begin (); it != incidencies.end (); ++it)
+    {
+      std::map<GlobalRouter*, uint32_t>::iterator remote = index.find (ns3::PeekPointer (std::get<2>(*it)));
+      if (remote == index.end ())
+        continue;
+
+      graph.neighbors.push_back (remote->second);
+      graph.metrics.push_back (std::max<uint32_t>(1, (uint32_t) std::get<1>(*it)->getMetric ()));
+      graph.faces.push_back (std::get<1>(*it));
+      inDegree[remote->second]++;
+    }
+    graph.offsets.push_back (graph.neighbors.size ());
+
+    const GlobalRouter::LocalPrefixList& local = graph.routers[i]->GetLocalPrefixes ();
+    for (GlobalRouter::LocalPrefixList::const_iterator it = local.begin (); it != local.end (); ++it)
+    {
+      std::map<nfd::Name, uint32_t>::iterator p = prefixIndex.find (**it);
+      if (p == prefixIndex.end ())
+      {
+        p = prefixIndex.insert (std::make_pair (**it, (uint32_t) graph.prefixes.size ())).first;
+        graph.prefixes.push_back (**it);
+        graph.origins.push_back (std::vector<uint32_t>());
+      }
+      graph.origins[p->second].push_back (i);
+    }
+  }
+
+  graph.reverseOffsets.assign (n + 1, 0);
+  for (uint32_t i = 0; i < n; i++)
+    graph.reverseOffsets[i + 1] = graph.reverseOffsets[i] + inDegree[i];
+
+  std::vector<uint32_t> fill(graph.reverseOffsets.begin (), graph.reverseOffsets.end () - 1);
+  graph.reverseNeighbors.resize (graph.neighbors.size ());
+  graph.reverseMetrics.resize (graph.neighbors.size ());
+  for (uint32_t i = 0; i < n; i++)
+    for (uint32_t l = graph.offsets[i]; l < graph.offsets[i + 1]; l++)
+    {
+      uint32_t slot = fill[graph.neighbors[l]]++;
+      graph.reverseNeighbors[slot] = i;
+      graph.reverseMetrics[slot] = graph.metrics[l];
+    }
+}
+
+/**
+ * @brief calculates the routes of the prefixes of a batch, every thread owns its distance arrays.
+ */
+class RouteWorker
+{
+public:
+  RouteWorker(const RoutingGraph& graph, ExtendedGlobalRoutingHelper::NextHopSelection selection, uint32_t maxNextHops)
+    : graph(graph), selection(selection), maxNextHops(maxNextHops), subtreeRoot(UNREACHABLE)
+  {
+    distance.resize (graph.routers.size ());
+    successor.resize (graph.routers.size ());
+    firstChild.resize (graph.routers.size ());
+    nextSibling.resize (graph.routers.size ());
+    enter.resize (graph.routers.size ());
+    leave.resize (graph.routers.size ());
+    alternative.resize (graph.routers.size (), UNREACHABLE);
+  }
+
+  void operator()(uint32_t first, uint32_t count, std::mutex* lock, uint32_t* next, std::vector<std::vector<Route> >* routes)
+  {
+    while(true)
+    {
+      uint32_t job;
+      {
+        std::lock_guard<std::mutex> guard(*lock);
+        if(*next >= count)
+          return;
+        job = (*next)++;
+      }
+      calculate (first + job, (*routes)[job]);
+    }
+  }
+
+  void calculate(uint32_t prefix, std::vector<Route>& routes)
+  {
+    typedef std::pair<uint32_t /*distance*/, uint32_t /*router*/> QueueEntry;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry> > queue;
+
+    std::fill(distance.begin (), distance.end (), UNREACHABLE);
+    const std::vector<uint32_t>& origins = graph.origins[prefix];
+    for(std::vector<uint32_t>::const_iterator it = origins.begin (); it != origins.end (); ++it)
+    {
+      distance[*it] = 0;
+      successor[*it] = *it;
+      queue.push (QueueEntry(0, *it));
+    }
+
+    //distances towards the origins, so the links are relaxed in reverse direction
+    while(!queue.empty ())
+    {
+      QueueEntry top = queue.top ();
+      queue.pop ();
+      if(top.first != distance[top.second])
+        continue;
+
+      for(uint32_t l = graph.reverseOffsets[top.second]; l < graph.reverseOffsets[top.second + 1]; l++)
+      {
+        uint32_t router = graph.reverseNeighbors[l];
+        uint32_t d = top.first + graph.reverseMetrics[l];
+        if(d < distance[router])
+        {
+          distance[router] = d;
+          successor[router] = top.second;
+          queue.push (QueueEntry(d, router));
+        }
+      }
+    }
+
+    if(selection == ExtendedGlobalRoutingHelper::AllNextHops)
+      buildTree ();
+
+    routes.clear ();
+    for(uint32_t router = 0; router < distance.size (); router++)
+    {
+      if(distance[router] == 0 || distance[router] == UNREACHABLE)
+        continue;
+
+      size_t begin = routes.size ();
+      for(uint32_t l = graph.offsets[router]; l < graph.offsets[router + 1]; l++)
+      {
+        uint32_t neighbor = graph.neighbors[l];
+        uint32_t d = distance[neighbor];
+        if(selection == ExtendedGlobalRoutingHelper::LoopFreeNextHops && d >= distance[router])
+          continue;
+        if(selection == ExtendedGlobalRoutingHelper::AllNextHops && d != UNREACHABLE && inSubtree (neighbor, router))
+          d = detour (neighbor, router);
+        if(d == UNREACHABLE)
+          continue;
+
+        Route r;
+        r.router = router;
+        r.link = l;
+        r.cost = graph.metrics[l] + d;
+        routes.push_back (r);
+      }
+
+      if(maxNextHops > 0 && routes.size () - begin > maxNextHops)
+      {
+        std::partial_sort(routes.begin () + begin, routes.begin () + begin + maxNextHops, routes.end ());
+        routes.resize (begin + maxNextHops);
+      }
+    }
+  }
+
+protected:
+
+  /**
+   * @brief numbers the shortest path tree (rooted at the origins) in depth first order, so the subtree of a router
+   * is the range [enter, leave) of the order.
+   */
+  void buildTree()
+  {
+    uint32_t n = distance.size ();
+    resetDetour ();
+    std::fill(firstChild.begin (), firstChild.end (), UNREACHABLE);
+    std::fill(enter.begin (), enter.end (), UNREACHABLE);
+    std::fill(leave.begin (), leave.end (), 0);
+    order.clear ();
+
+    for(uint32_t router = 0; router < n; router++)
+    {
+      if(distance[router] == 0 || distance[router] == UNREACHABLE)
+        continue;
+      nextSibling[router] = firstChild[successor[router]];
+      firstChild[successor[router]] = router;
+    }
+
+    std::vector<uint32_t> stack;
+    for(uint32_t root = 0; root < n; root++)
+    {
+      if(distance[root] != 0)
+        continue;
+
+      stack.push_back (root);
+      while(!stack.empty ())
+      {
+        uint32_t router = stack.back ();
+        if(enter[router] == UNREACHABLE) // first visit, descend
+        {
+          enter[router] = order.size ();
+          order.push_back (router);
+          for(uint32_t child = firstChild[router]; child != UNREACHABLE; child = nextSibling[child])
+            stack.push_back (child);
+        }
+        else
+        {
+          leave[router] = order.size ();
+          stack.pop_back ();
+        }
+      }
+    }
+  }
+
+  bool inSubtree(uint32_t router, uint32_t root) const
+  {
+    return enter[root] <= enter[router] && enter[router] < leave[root];
+  }
+
+  /**
+   * @brief the distance of a router to the origins if it must not pass the excluded router, i.e., a Dijkstra with the
+   * excluded router removed from the graph, as CalculateAllPossibleRoutes does by disabling the other faces.
+   * Only routers in the subtree of the excluded router lose their shortest path, so the Dijkstra is restricted to the
+   * subtree and starts from the links leaving it. The distances are kept until another router is excluded.
+   */
+  uint32_t detour(uint32_t router, uint32_t excluded)
+  {
+    if(subtreeRoot != excluded)
+    {
+      typedef std::pair<uint32_t /*distance*/, uint32_t /*router*/> QueueEntry;
+      std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry> > queue;
+
+      resetDetour ();
+      subtreeRoot = excluded;
+
+      for(uint32_t i = enter[excluded] + 1; i < leave[excluded]; i++)
+      {
+        uint32_t member = order[i];
+        for(uint32_t l = graph.offsets[member]; l < graph.offsets[member + 1]; l++)
+        {
+          uint32_t neighbor = graph.neighbors[l];
+          if(distance[neighbor] == UNREACHABLE || inSubtree (neighbor, excluded))
+            continue;
+          alternative[member] = std::min(alternative[member], graph.metrics[l] + distance[neighbor]);
+        }
+        if(alternative[member] != UNREACHABLE)
+          queue.push (QueueEntry(alternative[member], member));
+      }
+
+      while(!queue.empty ())
+      {
+        QueueEntry top = queue.top ();
+        queue.pop ();
+        if(top.first != alternative[top.second])
+          continue;
+
+        for(uint32_t l = graph.reverseOffsets[top.second]; l < graph.reverseOffsets[top.second + 1]; l++)
+        {
+          uint32_t member = graph.reverseNeighbors[l];
+          if(member == excluded || !inSubtree (member, excluded))
+            continue;
+          uint32_t d = top.first + graph.reverseMetrics[l];
+          if(d < alternative[member])
+          {
+            alternative[member] = d;
+            queue.push (QueueEntry(d, member));
+          }
+        }
+      }
+    }
+    return alternative[router];
+  }
+
+  void resetDetour()
+  {
+    if(subtreeRoot != UNREACHABLE)
+      for(uint32_t i = enter[subtreeRoot]; i < leave[subtreeRoot]; i++)
+        alternative[order[i]] = UNREACHABLE;
+    subtreeRoot = UNREACHABLE;
+  }
+
+  const RoutingGraph& graph;
+  ExtendedGlobalRoutingHelper::NextHopSelection selection;
+  uint32_t maxNextHops;
+
+  std::vector<uint32_t> distance;
+  std::vector<uint32_t> successor; /*next router on the shortest path towards the origins*/
+
+  //shortest path tree of the current prefix, see buildTree()
+  std::vector<uint32_t> firstChild;
+  std::vector<uint32_t> nextSibling;
+  std::vector<uint32_t> order;
+  std::vector<uint32_t> enter;
+  std::vector<uint32_t> leave;
+
+  std::vector<uint32_t> alternative; /*distances without subtreeRoot, valid in its subtree only*/
+  uint32_t subtreeRoot;
+};
+
+}
+
 ExtendedGlobalRoutingHelper::ExtendedGlobalRoutingHelper() : GlobalRoutingHelper()
 {
 }
@@ -17,3 +370,53 @@ void ExtendedGlobalRoutingHelper::AddOriginsForAllUsingNodeIds()
     }
   }
 }
+
+void ExtendedGlobalRoutingHelper::CalculateAllRoutes(NextHopSelection selection, uint32_t maxNextHops, uint32_t threads)
+{
+  RoutingGraph graph;
+  buildGraph (graph);
+
+  if(threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency ());
+  threads = std::min<uint32_t>(threads, std::max<size_t>(1, graph.prefixes.size ()));
+
+  std::vector<RouteWorker> workers(threads, RouteWorker(graph, selection, maxNextHops));
+  std::vector<nfd::Fib*> fibs;
+  for(uint32_t i = 0; i < graph.routers.size (); i++)
+    fibs.push_back (&graph.routers[i]->GetL3Protocol ()->getForwarder ()->getFib ());
+
+  //the batches bound the memory of calculated but not yet installed routes, the FIBs are filled by this thread only
+  uint32_t batchSize = threads * 8;
+  std::vector<std::vector<Route> > routes(batchSize);
+  uint64_t installed = 0;
+
+  for(uint32_t first = 0; first < graph.prefixes.size (); first += batchSize)
+  {
+    uint32_t count = std::min<uint32_t>(batchSize, graph.prefixes.size () - first);
+    std::mutex lock;
+    uint32_t next = 0;
+
+    if(threads == 1)
+      workers[0](first, count, &lock, &next, &routes);
+    else
+    {
+      std::vector<std::thread> group;
+      for(uint32_t t = 0; t < threads; t++)
+        group.push_back (std::thread(std::ref (workers[t]), first, count, &lock, &next, &routes));
+      for(uint32_t t = 0; t < threads; t++)
+        group[t].join ();
+    }
+
+    for(uint32_t job = 0; job < count; job++)
+    {
+      const nfd::Name& prefix = graph.prefixes[first + job];
+      std::vector<Route>& r = routes[job];
+      for(std::vector<Route>::iterator it = r.begin (); it != r.end (); ++it)
+        fibs[it->router]->insert (prefix).first->addNextHop (graph.faces[it->link], it->cost);
+      installed += r.size ();
+    }
+  }
+
+  NS_LOG_INFO ("Installed " << installed << " next hops for " << graph.prefixes.size () << " prefixes on "
+               << graph.routers.size () << " nodes using " << threads << " threads");
+}
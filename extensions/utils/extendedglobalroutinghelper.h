@@ -51,9 +51,34 @@ namespace ndn
 class ExtendedGlobalRoutingHelper : public ns3::ndn::GlobalRoutingHelper
 {
 public:
+
+  enum NextHopSelection
+  {
+    AllNextHops, /*every face with a path to the origins that avoids the node, costed as CalculateAllPossibleRoutes*/
+    LoopFreeNextHops /*only faces whose neighbor is closer to the origins than the node*/
+  };
+
   ExtendedGlobalRoutingHelper();
 
+  /**
+   * @brief announces a /Node_<id> prefix on every node. The oracle strategies no longer need these routes, they take
+   * the next hops towards a node from StaticOracaleContainer::getNextHopDevice.
+   */
   void AddOriginsForAllUsingNodeIds();
+
+  /**
+   * @brief calculates and installs the routes to all origins, a replacement of CalculateAllPossibleRoutes for large topologies.
+   * The topology is flattened into a compressed sparse row graph and a single multi-source Dijkstra per prefix (over the
+   * reversed links, starting at all origins of the prefix) yields the distance of every node to the prefix. The cost of a
+   * face is its metric plus the distance of its neighbor. If that distance depends on the node itself (the neighbor lies
+   * in the node's shortest path subtree), AllNextHops takes the neighbor's distance with the node removed, computed by a
+   * Dijkstra restricted to that subtree, so the costs equal those of CalculateAllPossibleRoutes. Prefixes are processed by parallel threads in batches, the next
+   * hops of a batch are written directly into the FIBs of the forwarders, bypassing the FIB management.
+   * @param selection which faces become next hops
+   * @param maxNextHops keeps only the cheapest next hops per node and prefix (first hop disjoint paths), 0 keeps all
+   * @param threads threads calculating the routes, 0 uses one per hardware thread
+   */
+  static void CalculateAllRoutes(NextHopSelection selection = AllNextHops, uint32_t maxNextHops = 0, uint32_t threads = 0);
 };
 
 }
@@ -0,0 +1,71 @@
+/**
+ * Copyright (c) 2015 Daniel Posch (Alpen-Adria Universität Klagenfurt)
+ *
+ * This file is part of the ndnSIM extension for Stochastic Adaptive Forwarding (SAF).
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NACKAGGREGATIONHELPER_H
+#define NACKAGGREGATIONHELPER_H
+
+#include "parameterconfiguration.h"
+
+#include "ns3/node-container.h"
+#include "ns3/node-list.h"
+#include "ns3/ndnSIM/model/ndn-l3-protocol.hpp"
+
+namespace nfd
+{
+namespace fw
+{
+
+/**
+ * @brief The NackAggregationHelper class enables NACK aggregation on the forwarders of nodes. Aggregation applies to all
+ * strategies of a forwarder, so it is configured per node by the scenario and not by a strategy.
+ */
+class NackAggregationHelper
+{
+public:
+
+  /**
+   * @param windowMs milliseconds NACKs per downstream and content prefix are aggregated, 0 disables aggregation
+   * @param prefixLength name components of the content prefix
+   */
+  static void Install(const ns3::NodeContainer& nodes, int windowMs, size_t prefixLength)
+  {
+    for(ns3::NodeContainer::Iterator it = nodes.Begin (); it != nodes.End (); ++it)
+    {
+      ns3::Ptr<ns3::ndn::L3Protocol> l3 = (*it)->GetObject<ns3::ndn::L3Protocol>();
+      if(l3 == 0)
+      {
+        fprintf(stderr, "NackAggregationHelper: the NDN stack has to be installed first!\n");
+        continue;
+      }
+      l3->getForwarder ()->setNackAggregation (time::milliseconds(windowMs), prefixLength);
+    }
+  }
+
+  /**
+   * @brief installs on all nodes, window and prefix length are taken from NACK_AGGREGATION_WINDOW and PREFIX_COMPONENT.
+   */
+  static void InstallAll()
+  {
+    Install(ns3::NodeContainer::GetGlobal (),
+            (int) ParameterConfiguration::getInstance ()->getParameter ("NACK_AGGREGATION_WINDOW"),
+            (int) ParameterConfiguration::getInstance ()->getParameter ("PREFIX_COMPONENT") + 1);
+  }
+};
+
+}
+}
+#endif // NACKAGGREGATIONHELPER_H
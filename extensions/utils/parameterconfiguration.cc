@@ -14,6 +14,24 @@ ParameterConfiguration::ParameterConfiguration()
   setParameter ("CONTENT_AWARE_ADAPTATION", P_CONTENT_AWARE_ADAPTATION);
   setParameter ("PREFIX_COMPONENT", P_PREFIX_COMPONENT);
   setParameter ("RTX_DETECTION", P_USE_RTX_DETECTION);
+  setParameter ("NACK_AGGREGATION_WINDOW", P_NACK_AGGREGATION_WINDOW);
+  setParameter ("BACK_PRESSURE_WEIGHT", P_BACK_PRESSURE_WEIGHT);
+  setParameter ("HIERARCHICAL_SAMPLE_THRESHOLD", P_HIERARCHICAL_SAMPLE_THRESHOLD);
+  setParameter ("ADAPTIVE_SPLIT_THRESHOLD", P_ADAPTIVE_SPLIT_THRESHOLD);
+  setParameter ("ADAPTIVE_MERGE_THRESHOLD", P_ADAPTIVE_MERGE_THRESHOLD);
+  setParameter ("ADAPTIVE_MIN_SAMPLES", P_ADAPTIVE_MIN_SAMPLES);
+  setParameter ("ADAPTIVE_ENTRY_BUDGET", P_ADAPTIVE_ENTRY_BUDGET);
+  setParameter ("FLOW_STICKY", P_FLOW_STICKY);
+  setParameter ("DROP_FILTER_LIFETIME", P_DROP_FILTER_LIFETIME);
+  setParameter ("DROP_FILTER_FP_RATE", P_DROP_FILTER_FP_RATE);
+  setParameter ("DROP_FILTER_CAPACITY", P_DROP_FILTER_CAPACITY);
+  setParameter ("MEASUREMENTS_LIFETIME", P_MEASUREMENTS_LIFETIME);
+  setParameter ("SNAPSHOT_INTERVAL", P_SNAPSHOT_INTERVAL);
+  setParameter ("CACHE_SUMMARY_SIZE", P_CACHE_SUMMARY_SIZE);
+  setParameter ("CACHE_SUMMARY_HASHES", P_CACHE_SUMMARY_HASHES);
+  setParameter ("CACHE_SUMMARY_REFRESH", P_CACHE_SUMMARY_REFRESH);
+  setParameter ("OMPIF_TIMER_RESOLUTION", P_OMPIF_TIMER_RESOLUTION);
+  setParameter ("REPLICA_DIRECTORY_PRUNE", P_REPLICA_DIRECTORY_PRUNE);
 }
 
 
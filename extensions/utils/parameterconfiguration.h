@@ -33,6 +33,24 @@
 #define P_CONTENT_AWARE_ADAPTATION -1 // < 0 disabled, > 0 enabled.
 #define P_PREFIX_COMPONENT 0 // component that seperates the prefix from the remaining name
 #define P_USE_RTX_DETECTION 0 // enables expiremental feature to distinguish rtx from interest aggregation
+#define P_ADAPTIVE_SPLIT_THRESHOLD 0 // reliability divergence of child prefixes that splits an entry, 0 disables adaptive prefix granularity
+#define P_ADAPTIVE_MERGE_THRESHOLD 0.05 // max. difference of the forwarding probabilities of child entries that are merged again
+#define P_ADAPTIVE_MIN_SAMPLES 20 // samples per child prefix and face required to consider a split
+#define P_ADAPTIVE_ENTRY_BUDGET 1000 // max. number of live forwarding entries per node with adaptive prefix granularity
+#define P_HIERARCHICAL_SAMPLE_THRESHOLD 0 // samples until an entry no longer uses the table of its parent prefix, 0 disables hierarchical entries
+#define P_FLOW_STICKY 0 // > 0 keeps all segments of a flow on the same face within a period
+#define P_DROP_FILTER_LIFETIME 0 // seconds a dropped name is nacked without table lookup, 0 disables the filter
+#define P_DROP_FILTER_FP_RATE 0.01 // false positive rate of the dropped name filter
+#define P_DROP_FILTER_CAPACITY 1000 // names per generation of the dropped name filter
+#define P_BACK_PRESSURE_WEIGHT 0 // weight of the drop probabilities reported by upstream nodes in [0,1], 0 disables back-pressure
+#define P_NACK_AGGREGATION_WINDOW 0 // ms nacks per prefix and downstream are aggregated (see NackAggregationHelper), 0 disables aggregation
+#define P_MEASUREMENTS_LIFETIME 300 // seconds per-prefix state is kept in the measurements table without traffic
+#define P_SNAPSHOT_INTERVAL 0 // seconds between snapshots of the learned state (see SAFSnapshot::setDirectory), 0 disables writing
+#define P_CACHE_SUMMARY_SIZE 16384 // counters of the cache summary of a node (SummaryOracle, rounded up to a power of two), the exchanged summary uses one bit per counter
+#define P_CACHE_SUMMARY_HASHES 4 // hash functions of the cache summary
+#define P_CACHE_SUMMARY_REFRESH 1.0 // seconds between two exchanges of the cache summaries
+#define P_OMPIF_TIMER_RESOLUTION 0.01 // seconds per tick of the interest time out wheel of OMP-IF
+#define P_REPLICA_DIRECTORY_PRUNE 10 // seconds between two checks of the iNRR replica directory against the content stores
 
 //some additional defines
 #define DROP_FACE_ID -1
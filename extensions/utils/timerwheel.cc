@@ -0,0 +1,176 @@
+#include "timerwheel.h"
+#include <algorithm>
+#include <cmath>
+
+TimerWheel::TimerWheel(double resolution, unsigned int slots, unsigned int levels)
+{
+  this->resolution = resolution > 0 ? resolution : 0.001;
+  this->slots = slots > 1 ? slots : 2;
+  this->levels = levels > 0 ? levels : 1;
+
+  heads = std::vector<int>(this->slots * this->levels, -1);
+  freeList = -1;
+  pending = 0;
+  currentTick = 0;
+}
+
+TimerWheel::TimerId TimerWheel::schedule(double now, double delay, const Callback& callback)
+{
+  if(pending == 0) // nothing to cascade, the wheel can jump to the current time
+    currentTick = std::max(currentTick, (uint64_t) floor(now / resolution));
+  else
+    advance(now);
+
+  int timer = freeList;
+  if(timer == -1)
+  {
+    Timer t;
+    t.generation = 0;
+    timers.push_back (t);
+    timer = timers.size () - 1;
+  }
+  else
+    freeList = timers[timer].next;
+
+  Timer& t = timers[timer];
+  t.expiry = std::max(currentTick + 1, (uint64_t) ceil((now + std::max(0.0, delay)) / resolution));
+  t.callback = callback;
+  insert(timer);
+  pending++;
+
+  return ((TimerId) t.generation << 32) | (TimerId) (timer + 1);
+}
+
+void TimerWheel::cancel(TimerId id)
+{
+  int timer = (int) (id & 0xFFFFFFFF) - 1;
+  if(timer < 0 || timer >= (int) timers.size ())
+    return;
+
+  Timer& t = timers[timer];
+  if(t.slot == -1 || t.generation != (uint32_t) (id >> 32))
+    return;
+
+  unlink(timer);
+  release(timer);
+}
+
+void TimerWheel::advance(double now)
+{
+  advanceTo((uint64_t) floor(now / resolution));
+}
+
+void TimerWheel::advanceTo(uint64_t target)
+{
+  while(currentTick < target)
+  {
+    if(pending == 0)
+    {
+      currentTick = target;
+      return;
+    }
+    tick();
+  }
+}
+
+void TimerWheel::tick()
+{
+  currentTick++;
+
+  //refill the lower levels when a level wraps around
+  uint64_t index = currentTick;
+  for(unsigned int level = 1; level < levels && index % slots == 0; level++)
+  {
+    index /= slots;
+    cascade(level);
+  }
+
+  int slot = currentTick % slots;
+  while(heads[slot] != -1)
+  {
+    int timer = heads[slot];
+    unlink(timer);
+
+    if(timers[timer].expiry > currentTick) // beyond the last level, wait for the next round
+    {
+      insert(timer);
+      continue;
+    }
+
+    Callback callback;
+    callback.swap (timers[timer].callback);
+    release(timer);
+    callback(); // may schedule or cancel timers
+  }
+}
+
+void TimerWheel::cascade(unsigned int level)
+{
+  uint64_t span = 1;
+  for(unsigned int i = 0; i < level; i++)
+    span *= slots;
+
+  int slot = level * slots + (currentTick / span) % slots;
+  int timer = heads[slot];
+  heads[slot] = -1;
+
+  while(timer != -1)
+  {
+    int next = timers[timer].next;
+    timers[timer].slot = -1;
+    insert(timer);
+    timer = next;
+  }
+}
+
+void TimerWheel::insert(int timer)
+{
+  Timer& t = timers[timer];
+  uint64_t expiry = std::max(t.expiry, currentTick);
+  uint64_t delta = expiry - currentTick;
+
+  //the level whose span covers the remaining ticks, the last level also takes everything beyond
+  unsigned int level = 0;
+  uint64_t span = 1;
+  while(level + 1 < levels && delta >= span * slots)
+  {
+    span *= slots;
+    level++;
+  }
+  if(level + 1 == levels && delta >= span * slots)
+    expiry = currentTick + span * (slots - 1);
+
+  int slot = level * slots + (expiry / span) % slots;
+
+  t.slot = slot;
+  t.prev = -1;
+  t.next = heads[slot];
+  if(t.next != -1)
+    timers[t.next].prev = timer;
+  heads[slot] = timer;
+}
+
+void TimerWheel::unlink(int timer)
+{
+  Timer& t = timers[timer];
+  if(t.prev != -1)
+    timers[t.prev].next = t.next;
+  else
+    heads[t.slot] = t.next;
+
+  if(t.next != -1)
+    timers[t.next].prev = t.prev;
+
+  t.slot = -1;
+}
+
+void TimerWheel::release(int timer)
+{
+  Timer& t = timers[timer];
+  t.callback.clear ();
+  t.generation++;
+  t.slot = -1;
+  t.next = freeList;
+  freeList = timer;
+  pending--;
+}
@@ -0,0 +1,115 @@
+/**
+ * Copyright (c) 2015 Daniel Posch (Alpen-Adria Universität Klagenfurt)
+ *
+ * This file is part of the ndnSIM extension for Stochastic Adaptive Forwarding (SAF).
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <boost/function.hpp>
+#include <stdint.h>
+#include <cmath>
+#include <vector>
+
+/**
+ * @brief The TimerWheel class is a hierarchical timer wheel for many short lived timers, e.g., interest timeouts.
+ * Scheduling and canceling are O(1), the owner drives the wheel by calling advanceTo(nextTick()) at the time of that
+ * tick, which only needs to happen once per tick while timers are pending.
+ *
+ * Timers fire at the first tick at or after their expiry, i.e., they are delayed by less than one resolution.
+ */
+class TimerWheel
+{
+public:
+
+  typedef boost::function<void()> Callback;
+  typedef uint64_t TimerId; /*0 is never used for a timer*/
+
+  /**
+   * @brief creates an empty wheel.
+   * @param resolution the duration of a tick in seconds
+   * @param slots slots per level, level l covers slots^(l+1) ticks
+   * @param levels the number of levels, timers beyond the last level are cascaded again
+   */
+  TimerWheel(double resolution, unsigned int slots = 256, unsigned int levels = 3);
+
+  /**
+   * @brief schedules a callback.
+   * @param now the current time in seconds
+   * @param delay the delay in seconds
+   * @return an id to cancel the timer
+   */
+  TimerId schedule(double now, double delay, const Callback& callback);
+
+  /**
+   * @brief cancels a timer, canceling an expired or unknown timer has no effect.
+   */
+  void cancel(TimerId id);
+
+  /**
+   * @brief fires all timers due until the given time.
+   */
+  void advance(double now);
+
+  /**
+   * @brief fires all timers due until the given tick, always makes progress if the tick lies ahead.
+   * Owners driving the wheel from a tick event should use this instead of advance(), as converting the tick time back
+   * to ticks in floating point may land just before the tick and fire nothing.
+   */
+  void advanceTo(uint64_t tick);
+
+  /**
+   * @brief the next tick, i.e., which tick advanceTo() has to be called with next if the wheel is not empty.
+   */
+  uint64_t nextTick() const {return currentTick + 1;}
+
+  /**
+   * @brief the time of a tick in nanoseconds.
+   */
+  int64_t tickTime(uint64_t tick) const {return (int64_t) llround(tick * resolution * 1e9);}
+
+  bool empty() const {return pending == 0;}
+  size_t size() const {return pending;}
+
+protected:
+
+  struct Timer
+  {
+    uint64_t expiry; /*tick*/
+    uint32_t generation; /*incremented on reuse, stale ids do not match*/
+    int prev; /*index in the timer pool, -1 if none*/
+    int next;
+    int slot; /*index of the slot list, -1 if the timer is free*/
+    Callback callback;
+  };
+
+  void insert(int timer);
+  void unlink(int timer);
+  void release(int timer);
+  void cascade(unsigned int level);
+  void tick();
+
+  std::vector<Timer> timers; /*pool, free timers are chained via next*/
+  std::vector<int> heads; /*first timer of each slot, level l starts at l*slots*/
+  int freeList;
+  size_t pending;
+
+  double resolution;
+  unsigned int slots;
+  unsigned int levels;
+  uint64_t currentTick;
+};
+
+#endif // TIMERWHEEL_H
@@ -0,0 +1,354 @@
+#include "topologygenerator.h"
+#include <boost/random/uniform_01.hpp>
+#include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+namespace
+{
+
+//union find over node indices
+uint32_t findRoot(std::vector<uint32_t>& parent, uint32_t i)
+{
+  while(parent[i] != i)
+  {
+    parent[i] = parent[parent[i]];
+    i = parent[i];
+  }
+  return i;
+}
+
+}
+
+TopologyGenerator::TopologyGenerator()
+{
+  type = Rocketfuel;
+  routers = 100;
+  consumers = 10;
+  providers = 2;
+  bandwidth = Range(3, 10);
+  delay = Range(1, 10);
+  queue = Range(50, 50);
+  accessBandwidth = Range(10, 10);
+  multihoming = 0.3;
+  radius = 0;
+  seed = 1;
+}
+
+bool TopologyGenerator::parseType(const std::string& name, Type& type)
+{
+  if(name == "rocketfuel")
+    type = Rocketfuel;
+  else if(name == "fattree")
+    type = FatTree;
+  else if(name == "geometric")
+    type = RandomGeometric;
+  else
+    return false;
+  return true;
+}
+
+bool TopologyGenerator::generate()
+{
+  nodes.clear ();
+  links.clear ();
+  generator.seed (seed);
+
+  if(routers < 2 || consumers == 0 || providers == 0)
+  {
+    fprintf(stderr, "A topology needs at least 2 routers, a consumer and a provider\n");
+    return false;
+  }
+
+  std::vector<uint32_t> edge; /*routers hosts can be attached to*/
+  switch(type)
+  {
+    case Rocketfuel:
+      generateRocketfuel(edge);
+      break;
+    case FatTree:
+      generateFatTree(edge);
+      break;
+    case RandomGeometric:
+      generateRandomGeometric(edge);
+      break;
+  }
+
+  attachHosts(edge);
+  return true;
+}
+
+void TopologyGenerator::generateRocketfuel(std::vector<uint32_t>& edge)
+{
+  uint32_t backbone = std::min(routers, std::max(3u, routers / 10));
+
+  //backbone by preferential attachment with two links per new router, a triangle to start with
+  std::vector<uint32_t> endpoints; /*every router once per link, drawing from it is proportional to the degree*/
+  for(uint32_t i = 0; i < backbone; i++)
+  {
+    double angle = 2 * M_PI * i / backbone;
+    uint32_t n = addNode("Router", i, 50 + 20 * cos(angle), 50 + 20 * sin(angle));
+
+    if(i < 3)
+    {
+      for(uint32_t k = 0; k < i; k++)
+      {
+        addLink(k, n);
+        endpoints.push_back (k);
+        endpoints.push_back (n);
+      }
+      continue;
+    }
+
+    uint32_t first = endpoints[(size_t) (uniform() * endpoints.size ())];
+    uint32_t second = first;
+    while(second == first)
+      second = endpoints[(size_t) (uniform() * endpoints.size ())];
+
+    addLink(first, n);
+    addLink(second, n);
+    endpoints.push_back (first);
+    endpoints.push_back (second);
+    endpoints.push_back (n);
+    endpoints.push_back (n);
+  }
+
+  //access routers, the bandwidth and delay of their uplinks are drawn like the backbone links
+  for(uint32_t i = backbone; i < routers; i++)
+  {
+    uint32_t first = endpoints[(size_t) (uniform() * endpoints.size ())];
+    double angle = 2 * M_PI * uniform();
+    double distance = 25 + 20 * uniform();
+    uint32_t n = addNode("Router", i, 50 + distance * cos(angle), 50 + distance * sin(angle));
+    addLink(first, n);
+
+    if(uniform() < multihoming)
+    {
+      uint32_t second = first;
+      while(second == first)
+        second = (uint32_t) (uniform() * backbone);
+      addLink(second, n);
+    }
+    edge.push_back (n);
+  }
+
+  //very small topologies only have a backbone
+  if(edge.empty ())
+    for(uint32_t i = 0; i < backbone; i++)
+      edge.push_back (i);
+}
+
+void TopologyGenerator::generateFatTree(std::vector<uint32_t>& edge)
+{
+  uint32_t k = 2;
+  while(5 * k * k / 4 < routers)
+    k += 2;
+
+  uint32_t half = k / 2;
+  uint32_t index = 0;
+
+  //core switches on top, pods below
+  std::vector<uint32_t> core;
+  for(uint32_t i = 0; i < half * half; i++)
+    core.push_back (addNode("Router", index++, 100.0 * (i + 0.5) / (half * half), 100));
+
+  for(uint32_t pod = 0; pod < k; pod++)
+  {
+    std::vector<uint32_t> aggregation, edges;
+    for(uint32_t i = 0; i < half; i++)
+      aggregation.push_back (addNode("Router", index++, 100.0 * (pod * half + i + 0.5) / (k * half), 60));
+    for(uint32_t i = 0; i < half; i++)
+      edges.push_back (addNode("Router", index++, 100.0 * (pod * half + i + 0.5) / (k * half), 20));
+
+    for(uint32_t a = 0; a < half; a++)
+    {
+      //aggregation switch a connects to the core switches of group a
+      for(uint32_t c = 0; c < half; c++)
+        addLink(core[a * half + c], aggregation[a]);
+
+      for(uint32_t e = 0; e < half; e++)
+        addLink(aggregation[a], edges[e]);
+    }
+
+    edge.insert (edge.end (), edges.begin (), edges.end ());
+  }
+}
+
+void TopologyGenerator::generateRandomGeometric(std::vector<uint32_t>& edge)
+{
+  double r = radius > 0 ? radius : sqrt(6.0 / (M_PI * routers));
+
+  std::vector<double> x(routers), y(routers);
+  for(uint32_t i = 0; i < routers; i++)
+  {
+    x[i] = uniform();
+    y[i] = uniform();
+    addNode("Router", i, 100 * x[i], 100 * y[i]);
+    edge.push_back (i);
+  }
+
+  //grid with cells of the radius, only neighbouring cells are compared
+  uint32_t cells = std::max(1u, (uint32_t) (1.0 / r));
+  std::map<uint64_t, std::vector<uint32_t> > grid;
+  for(uint32_t i = 0; i < routers; i++)
+    grid[(uint64_t) std::min(cells - 1, (uint32_t) (x[i] * cells)) * cells + std::min(cells - 1, (uint32_t) (y[i] * cells))].push_back (i);
+
+  std::vector<uint32_t> parent(routers);
+  for(uint32_t i = 0; i < routers; i++)
+    parent[i] = i;
+
+  double maxDistance = sqrt(2.0);
+  for(uint32_t i = 0; i < routers; i++)
+  {
+    int cx = std::min(cells - 1, (uint32_t) (x[i] * cells));
+    int cy = std::min(cells - 1, (uint32_t) (y[i] * cells));
+    for(int dx = -1; dx <= 1; dx++)
+    {
+      for(int dy = -1; dy <= 1; dy++)
+      {
+        if(cx + dx < 0 || cy + dy < 0 || cx + dx >= (int) cells || cy + dy >= (int) cells)
+          continue;
+
+        std::map<uint64_t, std::vector<uint32_t> >::iterator cell = grid.find ((uint64_t) (cx + dx) * cells + (cy + dy));
+        if(cell == grid.end ())
+          continue;
+
+        for(std::vector<uint32_t>::iterator j = cell->second.begin (); j != cell->second.end (); ++j)
+        {
+          double d = sqrt((x[i] - x[*j]) * (x[i] - x[*j]) + (y[i] - y[*j]) * (y[i] - y[*j]));
+          if(*j > i && d <= r)
+          {
+            addLink(i, *j, d / maxDistance);
+            parent[findRoot(parent, i)] = findRoot(parent, *j);
+          }
+        }
+      }
+    }
+  }
+
+  //join the components, each to its closest node outside of the component of router 0 grows
+  for(uint32_t i = 1; i < routers; i++)
+  {
+    if(findRoot(parent, i) == findRoot(parent, 0))
+      continue;
+
+    //closest pair between the component of i and the rest
+    uint32_t root = findRoot(parent, i);
+    uint32_t bestA = 0, bestB = 0;
+    double best = -1;
+    for(uint32_t a = 0; a < routers; a++)
+    {
+      if(findRoot(parent, a) != root)
+        continue;
+      for(uint32_t b = 0; b < routers; b++)
+      {
+        if(findRoot(parent, b) == root)
+          continue;
+        double d = sqrt((x[a] - x[b]) * (x[a] - x[b]) + (y[a] - y[b]) * (y[a] - y[b]));
+        if(best < 0 || d < best)
+        {
+          best = d;
+          bestA = a;
+          bestB = b;
+        }
+      }
+    }
+
+    addLink(bestA, bestB, best / maxDistance);
+    parent[root] = findRoot(parent, bestB);
+  }
+}
+
+void TopologyGenerator::attachHosts(const std::vector<uint32_t>& edge)
+{
+  //providers and consumers on distinct edge routers as long as there are enough
+  std::vector<uint32_t> candidates = edge;
+  for(size_t i = candidates.size (); i > 1; i--)
+    std::swap(candidates[i - 1], candidates[(size_t) (uniform() * i)]);
+
+  size_t next = 0;
+  for(uint32_t i = 0; i < providers; i++)
+  {
+    uint32_t router = candidates[next++ % candidates.size ()];
+    uint32_t n = addNode("ContentSrc", i, nodes[router].x, std::min(100.0, nodes[router].y + 2));
+    links.push_back (Link());
+    links.back ().a = router;
+    links.back ().b = n;
+    links.back ().bandwidth = draw(accessBandwidth);
+    links.back ().delay = delay.min;
+    links.back ().queue = (uint32_t) draw(queue);
+  }
+
+  for(uint32_t i = 0; i < consumers; i++)
+  {
+    uint32_t router = candidates[next++ % candidates.size ()];
+    uint32_t n = addNode("ContentDst", i, nodes[router].x, std::max(0.0, nodes[router].y - 2));
+    links.push_back (Link());
+    links.back ().a = router;
+    links.back ().b = n;
+    links.back ().bandwidth = draw(accessBandwidth);
+    links.back ().delay = delay.min;
+    links.back ().queue = (uint32_t) draw(queue);
+  }
+}
+
+uint32_t TopologyGenerator::addNode(const std::string& prefix, uint32_t index, double x, double y)
+{
+  Node n;
+  n.name = prefix + boost::lexical_cast<std::string>(index);
+  n.x = x;
+  n.y = y;
+  nodes.push_back (n);
+  return nodes.size () - 1;
+}
+
+void TopologyGenerator::addLink(uint32_t a, uint32_t b, double delayFactor)
+{
+  Link l;
+  l.a = a;
+  l.b = b;
+  l.bandwidth = draw(bandwidth);
+  l.delay = delayFactor < 0 ? draw(delay) : delay.min + (delay.max - delay.min) * delayFactor;
+  l.queue = (uint32_t) draw(queue);
+  links.push_back (l);
+}
+
+double TopologyGenerator::draw(const Range& r)
+{
+  return r.min + (r.max - r.min) * uniform();
+}
+
+double TopologyGenerator::uniform()
+{
+  boost::random::uniform_01<double> u;
+  double v = u(generator);
+  return v < 1.0 ? v : 0.0; // [0,1) so it can index
+}
+
+void TopologyGenerator::write(FILE* out)
+{
+  fprintf(out, "router\n\n");
+  fprintf(out, "# node    comment    yPos    xPos\n");
+  for(std::vector<Node>::iterator it = nodes.begin (); it != nodes.end (); ++it)
+    fprintf(out, "%-14s NA    %.2f    %.2f\n", it->name.c_str (), it->y, it->x);
+
+  fprintf(out, "\nlink\n");
+  fprintf(out, "# srcNode    dstNode    bandwidth   metric    delay  queue\n");
+  for(std::vector<Link>::iterator it = links.begin (); it != links.end (); ++it)
+    fprintf(out, "%-14s %-14s %gMbps    1    %gms    %u\n", nodes[it->a].name.c_str (), nodes[it->b].name.c_str (),
+            round(it->bandwidth * 100) / 100, round(it->delay * 100) / 100, it->queue);
+}
+
+bool TopologyGenerator::write(const std::string& file)
+{
+  FILE* out = fopen(file.c_str (), "w");
+  if(out == NULL)
+  {
+    fprintf(stderr, "Could not open %s\n", file.c_str ());
+    return false;
+  }
+  write(out);
+  fclose(out);
+  return true;
+}
@@ -0,0 +1,119 @@
+/**
+ * Copyright (c) 2015 Daniel Posch (Alpen-Adria Universität Klagenfurt)
+ *
+ * This file is part of the ndnSIM extension for Stochastic Adaptive Forwarding (SAF).
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef TOPOLOGYGENERATOR_H
+#define TOPOLOGYGENERATOR_H
+
+#include <boost/random/mersenne_twister.hpp>
+#include <stdint.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The TopologyGenerator class generates synthetic topologies for scaling studies and writes them in the format
+ * of ndnSIM's AnnotatedTopologyReader. Routers are named Router<i>, consumers ContentDst<i> and providers ContentSrc<i>,
+ * so the scenarios pick up the roles by name.
+ *
+ * Types:
+ *  - Rocketfuel: ISP-like, a preferential attachment backbone (about 10% of the routers) with access routers
+ *    attached to one or (multihoming) two backbone routers.
+ *  - FatTree: k-ary data center fat tree, k is the smallest even number with 5k^2/4 >= routers.
+ *  - RandomGeometric: routers placed uniformly in the unit square and linked within a radius, delays grow with the
+ *    distance, components are joined by their closest pair of nodes.
+ */
+class TopologyGenerator
+{
+public:
+
+  enum Type {Rocketfuel = 0, FatTree = 1, RandomGeometric = 2};
+
+  /**
+   * @brief a uniform distribution, min == max gives a constant.
+   */
+  struct Range
+  {
+    Range(double min = 0, double max = 0) : min(min), max(max) {}
+    double min;
+    double max;
+  };
+
+  struct Node
+  {
+    std::string name;
+    double x; /*0..100*/
+    double y; /*0..100*/
+  };
+
+  struct Link
+  {
+    uint32_t a; /*index in nodes*/
+    uint32_t b;
+    double bandwidth; /*Mbps*/
+    double delay; /*ms*/
+    uint32_t queue; /*packets*/
+  };
+
+  TopologyGenerator();
+
+  /**
+   * @brief generates the topology with the current parameters, replacing the previous one.
+   * @return false if the parameters do not describe a topology
+   */
+  bool generate();
+
+  /**
+   * @brief writes the generated topology in the AnnotatedTopologyReader format.
+   */
+  void write(FILE* out);
+  bool write(const std::string& file);
+
+  static bool parseType(const std::string& name, Type& type);
+
+  //parameters
+  Type type;
+  uint32_t routers;
+  uint32_t consumers;
+  uint32_t providers;
+  Range bandwidth; /*Mbps of router links*/
+  Range delay; /*ms of router links*/
+  Range queue; /*packets of router links*/
+  Range accessBandwidth; /*Mbps of consumer and provider links*/
+  double multihoming; /*share of access routers with a second uplink (Rocketfuel)*/
+  double radius; /*link radius in the unit square (RandomGeometric), 0 picks an expected degree of about 6*/
+  uint32_t seed;
+
+  //result
+  std::vector<Node> nodes;
+  std::vector<Link> links;
+
+protected:
+
+  void generateRocketfuel(std::vector<uint32_t>& edge);
+  void generateFatTree(std::vector<uint32_t>& edge);
+  void generateRandomGeometric(std::vector<uint32_t>& edge);
+  void attachHosts(const std::vector<uint32_t>& edge);
+
+  uint32_t addNode(const std::string& prefix, uint32_t index, double x, double y);
+  void addLink(uint32_t a, uint32_t b, double delayFactor = -1);
+  double draw(const Range& r);
+  double uniform();
+
+  boost::random::mt19937 generator;
+};
+
+#endif // TOPOLOGYGENERATOR_H
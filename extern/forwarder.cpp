@@ -30,6 +30,7 @@
 #include "available-strategies.hpp"
 
 #include "utils/ndn-ns3-packet-tag.hpp"
+#include "utils/ndn-fw-nack-tag.hpp"
 
 #include <boost/random/uniform_int_distribution.hpp>
 
@@ -40,6 +41,7 @@ NFD_LOG_INIT("Forwarder");
 using fw::Strategy;
 
 const Name Forwarder::LOCALHOST_NAME("ndn:/localhost");
+const size_t Forwarder::MAX_AGGREGATED_NACK_NAMES = 32;
 
 Forwarder::Forwarder()
   : m_faceTable(*this)
@@ -48,6 +50,8 @@ Forwarder::Forwarder()
   , m_measurements(m_nameTree)
   , m_strategyChoice(m_nameTree, fw::makeDefaultStrategy(*this))
   , m_csFace(make_shared<NullFace>(FaceUri("contentstore://")))
+  , m_nackAggregationWindow(0)
+  , m_nackAggregationPrefixLength(0)
 {
   fw::installStrategies(*this);
   getFaceTable().addReserved(m_csFace, FACEID_CONTENT_STORE);
@@ -55,7 +59,15 @@ Forwarder::Forwarder()
 
 Forwarder::~Forwarder()
 {
+  for (NackAggregateMap::iterator it = m_nackAggregates.begin(); it != m_nackAggregates.end(); ++it)
+    scheduler::cancel(it->second.flushTimer);
+}
 
+void
+Forwarder::setNackAggregation(const time::milliseconds& window, size_t prefixLength)
+{
+  m_nackAggregationWindow = window;
+  m_nackAggregationPrefixLength = prefixLength;
 }
 
 void
@@ -65,40 +77,9 @@ Forwarder::onIncomingInterest(Face& inFace, const Interest& interest)
   NFD_LOG_DEBUG("onIncomingInterest face=" << inFace.getId() <<
                 " interest=" << interest.getName());
 
-  //CATCH THE NACK
-  //shared_ptr<ndn::NackTag> tag = interest.getTag<ndn::NackTag >();
-  std::string prefix = interest.getName().get(0).toUri();
-  if(prefix.compare("NACK") == 0)
-  {
-    //fprintf(stderr, "Forwarder::received Nack: %s\n", interest.getName().toUri().c_str());
-
-    std::string nstring = interest.getName().toUri();
-    nstring = nstring.substr(5,std::string::npos);
-    shared_ptr<Name> name = make_shared<Name>(Name(nstring));
-    shared_ptr<Interest> without_nack_prefix = make_shared<Interest>(
-                              *(interest.shared_from_this()));
-    without_nack_prefix->setName(*name);
-
-    //fprintf(stderr, "without_nack_prefix : %s\n", without_nack_prefix->getName().toUri().c_str());
-    //fprintf(stderr, "dispatching : %s\n", interest.getName().toUri().c_str());
-
-    std::pair< shared_ptr< pit::Entry >, bool > entry = m_pit.insert(*without_nack_prefix);
-    shared_ptr<pit::Entry> pitEntry = entry.first;
-    bool newEntry = entry.second;
-
-    if(newEntry)
-    {
-       // means we got no pending interest for that nack
-      //fprintf(stderr, "No pending interest for NACK exists\n");
-      m_pit.erase(pitEntry);
-    }
-    else
-    {
-      //fprintf(stderr, "Pending interest for NACK exists\n");
-      shared_ptr<fib::Entry> fibEntry = m_fib.findLongestPrefixMatch(*pitEntry);
-      this->dispatchToStrategy(pitEntry, bind(&Strategy::afterReceiveInterest, _1,
-                                            cref(inFace), cref(interest), fibEntry, pitEntry));
-    }
+  // NACKs are Interests marked by a packet tag, they never enter the regular Interest pipeline
+  if (ns3::ndn::FwNackTag::IsNack(interest)) {
+    this->onIncomingNack(inFace, interest);
     return;
   }
 
@@ -185,6 +166,46 @@ Forwarder::onInterestLoop(Face& inFace, const Interest& interest,
   // (drop)
 }
 
+void
+Forwarder::onIncomingNack(Face& inFace, const Interest& nack)
+{
+  NFD_LOG_DEBUG("onIncomingNack face=" << inFace.getId() <<
+                " interest=" << nack.getName());
+
+  // an aggregated NACK lists further rejected names, each is processed as NACK of its own
+  std::vector<Name> aggregatedNames = ns3::ndn::FwNackTag::GetAggregatedNames(nack);
+  for (std::vector<Name>::iterator it = aggregatedNames.begin(); it != aggregatedNames.end(); ++it) {
+    shared_ptr<Interest> single = ns3::ndn::FwNackTag::SplitNack(nack, *it);
+    this->onIncomingNack(inFace, *single);
+  }
+
+  // PIT match, a NACK never creates a PIT entry
+  std::pair<shared_ptr<pit::Entry>, bool> entry = m_pit.insert(nack);
+  shared_ptr<pit::Entry> pitEntry = entry.first;
+  if (entry.second) {
+    NFD_LOG_DEBUG("onIncomingNack face=" << inFace.getId() <<
+                  " interest=" << nack.getName() << " no pending Interest");
+    m_pit.erase(pitEntry);
+    // (drop)
+    return;
+  }
+
+  // accept NACKs only from upstreams the Interest has been forwarded to
+  if (pitEntry->getOutRecord(inFace) == pitEntry->getOutRecords().end()) {
+    NFD_LOG_DEBUG("onIncomingNack face=" << inFace.getId() <<
+                  " interest=" << nack.getName() << " not an upstream");
+    // (drop)
+    return;
+  }
+
+  // FIB lookup
+  shared_ptr<fib::Entry> fibEntry = m_fib.findLongestPrefixMatch(*pitEntry);
+
+  // dispatch to strategy
+  this->dispatchToStrategy(pitEntry, bind(&Strategy::afterReceiveNack, _1,
+                                          cref(inFace), cref(nack), fibEntry, pitEntry));
+}
+
 /** \brief compare two InRecords for picking outgoing Interest
  *  \return true if b is preferred over a
  *
@@ -268,21 +289,17 @@ Forwarder::onOutgoingInterest(shared_ptr<pit::Entry> pitEntry, Face& outFace,
 }
 
 void
-Forwarder::onInterestReject(shared_ptr<pit::Entry> pitEntry)
+Forwarder::onInterestReject(shared_ptr<pit::Entry> pitEntry, const ns3::Tag* feedback)
 {
   NFD_LOG_DEBUG("onInterestReject interest=" << pitEntry->getName());
 
-  //1. create a nack message
-  std::string nstring = std::string("/NACK").append(pitEntry->getName().toUri());
-  shared_ptr<Name> name = make_shared<Name>(Name(nstring));
-  shared_ptr<Interest> nack = make_shared<Interest>(
-                              *(pitEntry->getInterest().shared_from_this()));
-  nack->setName(*name);
-  //shared_ptr<ndn::NackTag> tag = make_shared<ndn::NackTag>();
-  //tag->setValue(0);
-  //nack->setTag(tag);
-  //static boost::random::uniform_int_distribution<uint32_t> dist;
-  //nack->setNonce(pitEntry->getInterest().getNonce());
+  //1. create a nack message, it keeps the name of the rejected interest
+  shared_ptr<Interest> nack = ns3::ndn::FwNackTag::CreateNack(pitEntry->getInterest());
+  if (feedback != nullptr) {
+    ns3::Ptr<ns3::Packet> packet = nack->getTag<ns3::ndn::Ns3PacketTag>()->getPacket()->Copy();
+    packet->AddPacketTag(*feedback);
+    nack->setTag(make_shared<ns3::ndn::Ns3PacketTag>(packet));
+  }
 
   //2. find all pending downstream faces
   std::set<shared_ptr<Face> > pendingDownstreams;
@@ -305,8 +322,67 @@ Forwarder::onInterestReject(shared_ptr<pit::Entry> pitEntry)
   std::set<shared_ptr<Face> >::iterator it;
   for(it = pendingDownstreams.begin(); it!= pendingDownstreams.end(); ++it)
   {
-    (*it)->sendInterest(*nack);
+    this->sendNack(nack, *it);
+  }
+}
+
+void
+Forwarder::sendNack(shared_ptr<Interest> nack, shared_ptr<Face> downstream)
+{
+  if (m_nackAggregationWindow <= time::milliseconds::zero()) {
+    downstream->sendInterest(*nack);
+    return;
+  }
+
+  std::pair<FaceId, Name> key(downstream->getId(),
+                              nack->getName().getPrefix(m_nackAggregationPrefixLength));
+
+  NackAggregateMap::iterator it = m_nackAggregates.find(key);
+  if (it == m_nackAggregates.end()) {
+    // first NACK after an idle period goes out immediately, NACKs that follow within the window are aggregated
+    downstream->sendInterest(*nack);
+    NackAggregate& aggregate = m_nackAggregates[key];
+    aggregate.flushTimer = scheduler::schedule(m_nackAggregationWindow,
+      bind(&Forwarder::flushNackAggregation, this, key.first, key.second));
+    return;
+  }
+
+  if (it->second.nack == nullptr) {
+    it->second.nack = nack;
   }
+  else {
+    it->second.names.push_back(nack->getName());
+  }
+
+  // the aggregate carries the held back NACK plus the collected names
+  if (it->second.names.size() + 1 >= MAX_AGGREGATED_NACK_NAMES)
+    this->flushNackAggregation(key.first, key.second);
+}
+
+void
+Forwarder::flushNackAggregation(FaceId downstream, const Name& prefix)
+{
+  NackAggregateMap::iterator it = m_nackAggregates.find(std::make_pair(downstream, prefix));
+  if (it == m_nackAggregates.end())
+    return;
+
+  scheduler::cancel(it->second.flushTimer);
+  if (it->second.nack == nullptr) {
+    // nothing was held back within the window
+    m_nackAggregates.erase(it);
+    return;
+  }
+
+  shared_ptr<Interest> nack = ns3::ndn::FwNackTag::CreateNack(*it->second.nack,
+                                                              it->second.names);
+  m_nackAggregates.erase(it);
+
+  NFD_LOG_DEBUG("flushNackAggregation face=" << downstream << " prefix=" << prefix);
+
+  // the downstream face may have been removed in the meantime
+  shared_ptr<Face> face = m_faceTable.get(downstream);
+  if (face != nullptr)
+    face->sendInterest(*nack);
 }
 
 
@@ -374,6 +450,7 @@ Forwarder::onIncomingData(Face& inFace, const Data& data)
     m_cs.insert(*dataCopyWithoutPacket);
   else
     m_csFromNdnSim->Add(dataCopyWithoutPacket);
+  this->afterCsInsert(*dataCopyWithoutPacket);
 
   std::set<shared_ptr<Face> > pendingDownstreams;
   // foreach PitEntry
@@ -436,6 +513,7 @@ Forwarder::onDataUnsolicited(Face& inFace, const Data& data)
       m_cs.insert(data, true);
     else
       m_csFromNdnSim->Add(data.shared_from_this());
+    this->afterCsInsert(data);
   }
 
   NFD_LOG_DEBUG("onDataUnsolicited face=" << inFace.getId() <<
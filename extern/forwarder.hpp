@@ -38,6 +38,7 @@
 #include "table/dead-nonce-list.hpp"
 
 #include "ns3/ndnSIM/model/cs/ndn-content-store.hpp"
+#include "ns3/tag.h"
 
 namespace nfd {
 
@@ -114,6 +115,18 @@ public: // allow enabling ndnSIM content store (will be removed in the future)
   void
   setCsFromNdnSim(ns3::Ptr<ns3::ndn::ContentStore> cs);
 
+public: // NACK aggregation
+  /** \brief aggregate NACKs sent to the same downstream for the same prefix
+   *
+   *  The first NACK after an idle period is sent immediately, further NACKs within the window
+   *  are sent as one aggregate when the window ends.
+   *  Applies to all strategies of the forwarder, see NackAggregationHelper.
+   *  \param window time NACKs are held back to be aggregated, zero disables aggregation
+   *  \param prefixLength number of name components that identify the prefix
+   */
+  void
+  setNackAggregation(const time::milliseconds& window, size_t prefixLength);
+
 public:
   /** \brief trigger before PIT entry is satisfied
    *  \sa Strategy::beforeSatisfyInterest
@@ -127,6 +140,11 @@ public:
 
   signal::Signal<Forwarder, Face, Data> beforeDroppingUnsolicitedData;
 
+  /** \brief trigger after Data has been inserted into the content store,
+   *         either NFD's Cs or the ndnSIM content store
+   */
+  signal::Signal<Forwarder, Data> afterCsInsert;
+
 PUBLIC_WITH_TESTS_ELSE_PRIVATE: // pipelines
   /** \brief incoming Interest pipeline
    */
@@ -139,6 +157,11 @@ PUBLIC_WITH_TESTS_ELSE_PRIVATE: // pipelines
   onInterestLoop(Face& inFace, const Interest& interest,
                  shared_ptr<pit::Entry> pitEntry);
 
+  /** \brief incoming NACK pipeline
+   */
+  VIRTUAL_WITH_TESTS void
+  onIncomingNack(Face& inFace, const Interest& nack);
+
   /** \brief outgoing Interest pipeline
    */
   VIRTUAL_WITH_TESTS void
@@ -146,9 +169,10 @@ PUBLIC_WITH_TESTS_ELSE_PRIVATE: // pipelines
                      bool wantNewNonce = false);
 
   /** \brief Interest reject pipeline
+   *  \param feedback optional packet tag the strategy attaches to the NACK
    */
   VIRTUAL_WITH_TESTS void
-  onInterestReject(shared_ptr<pit::Entry> pitEntry);
+  onInterestReject(shared_ptr<pit::Entry> pitEntry, const ns3::Tag* feedback = nullptr);
 
   /** \brief Interest unsatisfied pipeline
    */
@@ -208,6 +232,17 @@ PROTECTED_WITH_TESTS_ELSE_PRIVATE:
   dispatchToStrategy(shared_ptr<pit::Entry> pitEntry, Function trigger);
 #endif
 
+private:
+  /** \brief send a NACK downstream, aggregated with further NACKs if enabled
+   */
+  void
+  sendNack(shared_ptr<Interest> nack, shared_ptr<Face> downstream);
+
+  /** \brief send the aggregated NACK for downstream and prefix
+   */
+  void
+  flushNackAggregation(FaceId downstream, const Name& prefix);
+
 private:
   ForwarderCounters m_counters;
 
@@ -225,7 +260,20 @@ private:
 
   ns3::Ptr<ns3::ndn::ContentStore> m_csFromNdnSim;
 
+  // NACKs held back per downstream face and prefix
+  struct NackAggregate
+  {
+    shared_ptr<Interest> nack; // first NACK held back, nullptr if none arrived after the immediate one
+    std::vector<Name> names;
+    scheduler::EventId flushTimer;
+  };
+  typedef std::map<std::pair<FaceId, Name>, NackAggregate> NackAggregateMap;
+  NackAggregateMap m_nackAggregates;
+  time::milliseconds m_nackAggregationWindow;
+  size_t m_nackAggregationPrefixLength;
+
   static const Name LOCALHOST_NAME;
+  static const size_t MAX_AGGREGATED_NACK_NAMES;
 
   // allow Strategy (base class) to enter pipelines
   friend class fw::Strategy;
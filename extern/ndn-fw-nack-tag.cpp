@@ -0,0 +1,185 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2015 Daniel Posch (Alpen-Adria Universität Klagenfurt)
+ *
+ * This file is part of the ndnSIM extension for Stochastic Adaptive Forwarding (SAF).
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "ndn-fw-nack-tag.hpp"
+#include "ndn-ns3-packet-tag.hpp"
+
+#include "ns3/packet.h"
+
+namespace ns3 {
+namespace ndn {
+
+NS_OBJECT_ENSURE_REGISTERED(FwNackTag);
+
+TypeId
+FwNackTag::GetTypeId()
+{
+  static TypeId tid = TypeId("ns3::ndn::FwNackTag")
+                        .SetGroupName("Ndn")
+                        .SetParent<Tag>()
+                        .AddConstructor<FwNackTag>();
+  return tid;
+}
+
+FwNackTag::FwNackTag(uint16_t names)
+  : m_names(names)
+{
+}
+
+TypeId
+FwNackTag::GetInstanceTypeId() const
+{
+  return FwNackTag::GetTypeId();
+}
+
+bool
+FwNackTag::IsNack(const ::ndn::Interest& interest)
+{
+  std::shared_ptr<Ns3PacketTag> ns3PacketTag = interest.getTag<Ns3PacketTag>();
+  if (ns3PacketTag == nullptr)
+    return false;
+
+  FwNackTag nackTag;
+  return ns3PacketTag->getPacket()->PeekPacketTag(nackTag);
+}
+
+std::shared_ptr<::ndn::Interest>
+FwNackTag::CreateNack(const ::ndn::Interest& interest)
+{
+  std::shared_ptr<::ndn::Interest> nack = std::make_shared<::ndn::Interest>(interest);
+
+  // start from an empty packet, tags of the rejected Interest must not travel back downstream
+  Ptr<Packet> packet = Create<Packet>();
+  packet->AddPacketTag(FwNackTag());
+  nack->setTag(std::make_shared<Ns3PacketTag>(packet));
+
+  return nack;
+}
+
+std::shared_ptr<::ndn::Interest>
+FwNackTag::CreateNack(const ::ndn::Interest& interest, const std::vector<::ndn::Name>& names)
+{
+  if (names.empty())
+    return CreateNack(interest);
+
+  std::vector<uint8_t> payload;
+  for (std::vector<::ndn::Name>::const_iterator it = names.begin(); it != names.end(); ++it) {
+    const ::ndn::Block& block = it->wireEncode();
+    payload.insert(payload.end(), block.wire(), block.wire() + block.size());
+  }
+
+  std::shared_ptr<::ndn::Interest> nack = std::make_shared<::ndn::Interest>(interest);
+
+  Ptr<Packet> packet = Create<Packet>();
+  std::shared_ptr<Ns3PacketTag> ns3PacketTag = interest.getTag<Ns3PacketTag>();
+  if (ns3PacketTag != nullptr)
+    packet = ns3PacketTag->getPacket()->Copy();
+
+  FwNackTag nackTag;
+  packet->RemovePacketTag(nackTag);
+  packet->AddAtEnd(Create<Packet>(&payload[0], payload.size()));
+  packet->AddPacketTag(FwNackTag(names.size()));
+  nack->setTag(std::make_shared<Ns3PacketTag>(packet));
+
+  return nack;
+}
+
+std::shared_ptr<::ndn::Interest>
+FwNackTag::SplitNack(const ::ndn::Interest& nack, const ::ndn::Name& name)
+{
+  std::shared_ptr<::ndn::Interest> single = CreateNack(nack);
+  single->setName(name);
+
+  std::shared_ptr<Ns3PacketTag> ns3PacketTag = nack.getTag<Ns3PacketTag>();
+  if (ns3PacketTag == nullptr)
+    return single;
+
+  // keep the packet tags of the aggregate, drop the payload listing the names
+  Ptr<Packet> packet = ns3PacketTag->getPacket()->Copy();
+  packet->RemoveAtEnd(packet->GetSize());
+
+  FwNackTag nackTag;
+  packet->RemovePacketTag(nackTag);
+  packet->AddPacketTag(FwNackTag());
+  single->setTag(std::make_shared<Ns3PacketTag>(packet));
+
+  return single;
+}
+
+std::vector<::ndn::Name>
+FwNackTag::GetAggregatedNames(const ::ndn::Interest& nack)
+{
+  std::vector<::ndn::Name> names;
+
+  std::shared_ptr<Ns3PacketTag> ns3PacketTag = nack.getTag<Ns3PacketTag>();
+  if (ns3PacketTag == nullptr)
+    return names;
+
+  Ptr<const Packet> packet = ns3PacketTag->getPacket();
+  FwNackTag nackTag;
+  if (!packet->PeekPacketTag(nackTag) || nackTag.GetNames() == 0)
+    return names;
+
+  std::vector<uint8_t> payload(packet->GetSize());
+  if (payload.empty())
+    return names;
+  packet->CopyData(&payload[0], payload.size());
+
+  // a malformed list must not take the forwarder down, the carrier is then handled as a single NACK
+  try {
+    size_t offset = 0;
+    while (offset < payload.size() && names.size() < nackTag.GetNames()) {
+      ::ndn::Block block(&payload[offset], payload.size() - offset);
+      if (block.type() != ::ndn::tlv::Name)
+        throw ::ndn::tlv::Error("aggregated NACK lists a TLV that is not a Name");
+      names.push_back(::ndn::Name(block));
+      offset += block.size();
+    }
+  }
+  catch (const ::ndn::tlv::Error&) {
+    names.clear();
+  }
+  return names;
+}
+
+uint32_t
+FwNackTag::GetSerializedSize() const
+{
+  return sizeof(uint16_t);
+}
+
+void
+FwNackTag::Serialize(TagBuffer i) const
+{
+  i.WriteU16(m_names);
+}
+
+void
+FwNackTag::Deserialize(TagBuffer i)
+{
+  m_names = i.ReadU16();
+}
+
+void
+FwNackTag::Print(std::ostream& os) const
+{
+  os << "NACK names=" << m_names;
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,130 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2015 Daniel Posch (Alpen-Adria Universität Klagenfurt)
+ *
+ * This file is part of the ndnSIM extension for Stochastic Adaptive Forwarding (SAF).
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NDN_FW_NACK_TAG_H
+#define NDN_FW_NACK_TAG_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/tag.h"
+
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-fw
+ * @brief Packet tag that marks an Interest as NACK
+ *
+ * The tag travels with the ns-3 packet of the rejected Interest, so the NACK keeps the name
+ * of the Interest and neither side of the link has to rewrite or re-parse the name.
+ *
+ * An aggregated NACK additionally lists the names of further rejected Interests in the
+ * payload of the packet (concatenated Name TLVs), the tag stores how many names follow.
+ */
+class FwNackTag : public Tag {
+public:
+  static TypeId
+  GetTypeId(void);
+
+  /**
+   * @brief Default constructor
+   */
+  FwNackTag(uint16_t names = 0);
+
+  /**
+   * @brief Destructor
+   */
+  ~FwNackTag()
+  {
+  }
+
+  /**
+   * @brief Check whether an Interest has been received as NACK
+   */
+  static bool
+  IsNack(const ::ndn::Interest& interest);
+
+  /**
+   * @brief Create a NACK for the given Interest
+   */
+  static std::shared_ptr<::ndn::Interest>
+  CreateNack(const ::ndn::Interest& interest);
+
+  /**
+   * @brief Create a NACK from the given NACK that also lists further rejected names
+   *
+   * Other packet tags of the given NACK, e.g. feedback of the strategy, are kept.
+   */
+  static std::shared_ptr<::ndn::Interest>
+  CreateNack(const ::ndn::Interest& interest, const std::vector<::ndn::Name>& names);
+
+  /**
+   * @brief Create the NACK of one name listed by an aggregated NACK
+   *
+   * Other packet tags of the aggregated NACK, e.g. feedback of the strategy, are kept,
+   * the list of names is not.
+   */
+  static std::shared_ptr<::ndn::Interest>
+  SplitNack(const ::ndn::Interest& nack, const ::ndn::Name& name);
+
+  /**
+   * @brief Get the further rejected names listed by an aggregated NACK, none if the list is malformed
+   */
+  static std::vector<::ndn::Name>
+  GetAggregatedNames(const ::ndn::Interest& nack);
+
+  /**
+   * @brief Get the number of names listed in the payload
+   */
+  uint16_t
+  GetNames() const
+  {
+    return m_names;
+  }
+
+  ////////////////////////////////////////////////////////
+  // from ObjectBase
+  ////////////////////////////////////////////////////////
+  virtual TypeId
+  GetInstanceTypeId() const;
+
+  ////////////////////////////////////////////////////////
+  // from Tag
+  ////////////////////////////////////////////////////////
+
+  virtual uint32_t
+  GetSerializedSize() const;
+
+  virtual void
+  Serialize(TagBuffer i) const;
+
+  virtual void
+  Deserialize(TagBuffer i);
+
+  virtual void
+  Print(std::ostream& os) const;
+
+private:
+  uint16_t m_names;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_FW_NACK_TAG_H
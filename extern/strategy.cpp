@@ -60,6 +60,14 @@ Strategy::beforeExpirePendingInterest(shared_ptr<pit::Entry> pitEntry)
   NFD_LOG_DEBUG("beforeExpirePendingInterest pitEntry=" << pitEntry->getName());
 }
 
+void
+Strategy::afterReceiveNack(const Face& inFace, const Interest& nack,
+                           shared_ptr<fib::Entry> fibEntry, shared_ptr<pit::Entry> pitEntry)
+{
+  NFD_LOG_DEBUG("afterReceiveNack pitEntry=" << pitEntry->getName() <<
+    " inFace=" << inFace.getId());
+}
+
 void
 Strategy::onUnsolicitedData(const Face& inFace, const Data& data)
 {
@@ -109,6 +109,27 @@ public: // triggers
   virtual void
   beforeExpirePendingInterest(shared_ptr<pit::Entry> pitEntry);
 
+  /** \brief trigger after a NACK is received
+   *
+   *  The NACK carries the name of a pending Interest that has been rejected by the upstream inFace.
+   *  The PIT entry is still pending.
+   *
+   *  The strategy should decide whether to try another upstream or to give up.
+   *  - If the strategy tries another upstream, invoke this->sendInterest
+   *  - If the strategy gives up, invoke this->rejectPendingInterest to pass the NACK
+   *    on to the downstreams, or do nothing and let the PIT entry expire
+   *
+   *  In this base class this method does nothing.
+   *
+   *  \note The strategy is permitted to store a shared reference to pitEntry.
+   *        pitEntry is passed by value to reflect this fact.
+   */
+  virtual void
+  afterReceiveNack(const Face& inFace,
+                   const Interest& nack,
+                   shared_ptr<fib::Entry> fibEntry,
+                   shared_ptr<pit::Entry> pitEntry);
+
   virtual void
   onUnsolicitedData(const Face& inFace, const Data& data);
 
@@ -123,9 +144,11 @@ protected: // actions
    *
    *  This shall not be called if the pending Interest has been
    *  forwarded earlier, and does not need to be resent now.
+   *
+   *  \param feedback optional packet tag attached to the NACK sent to the downstreams
    */
   VIRTUAL_WITH_TESTS void
-  rejectPendingInterest(shared_ptr<pit::Entry> pitEntry);
+  rejectPendingInterest(shared_ptr<pit::Entry> pitEntry, const ns3::Tag* feedback = nullptr);
 
 protected: // accessors
   MeasurementsAccessor&
@@ -168,9 +191,9 @@ Strategy::sendInterest(shared_ptr<pit::Entry> pitEntry,
 }
 
 inline void
-Strategy::rejectPendingInterest(shared_ptr<pit::Entry> pitEntry)
+Strategy::rejectPendingInterest(shared_ptr<pit::Entry> pitEntry, const ns3::Tag* feedback)
 {
-  m_forwarder.onInterestReject(pitEntry);
+  m_forwarder.onInterestReject(pitEntry, feedback);
 }
 
 inline MeasurementsAccessor&
@@ -0,0 +1,300 @@
+/**
+ * Copyright (c) 2015 Daniel Posch (Alpen-Adria Universität Klagenfurt)
+ *
+ * This file is part of the ndnSIM extension for Stochastic Adaptive Forwarding (SAF).
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// Runs one strategy on a topology and reports the same metrics for every strategy, e.g.
+//   for s in saf rfa inrr ompif; do ./waf --run "compare-strategies --strategy=$s --output=results.csv"; done
+// Nodes are taken from the topology by name: ContentDst* run consumers, ContentSrc* providers, everything else routes.
+// Provider i serves /provider<i>, consumer j requests the prefix of provider j % providers.
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/ndn-all.hpp"
+
+#include "../extensions/fw/saf.h"
+#include "../extensions/fw/competitors/rfa/OMCCRF.h"
+#include "../extensions/fw/competitors/omp-if/ompif-client.h"
+#include "../extensions/fw/competitors/omp-if/ompif-router.h"
+#include "../extensions/fw/competitors/inrr/oracle.h"
+#include "../extensions/fw/competitors/inrr/summaryoracle.h"
+#include "../extensions/fw/competitors/inrr/oraclehelper.h"
+#include "../extensions/utils/extendedglobalroutinghelper.h"
+#include "../extensions/utils/parameterconfiguration.h"
+#include "../extensions/utils/nackaggregationhelper.h"
+
+#include <boost/chrono.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <set>
+
+using namespace ns3;
+
+//interests requested and satisfied at the consumers, counted per interest
+//a transmission of a name the same consumer still waits for is a retransmission and not a new request
+std::set<std::pair<ndn::App*, std::string> > outstanding;
+uint64_t requested = 0;
+uint64_t delivered = 0;
+uint64_t retransmissions = 0;
+std::vector<double> delays; /*seconds from the first interest to the data*/
+uint64_t linkInterests = 0; /*interests sent on links, i.e., including forwarding overhead*/
+uint64_t l3Events = 0; /*interests and data sent or received by a forwarder (L3 traces, not simulator events)*/
+
+void TransmittedInterest(shared_ptr<const ndn::Interest> interest, Ptr<ndn::App> app, shared_ptr<ndn::Face> face)
+{
+  if(outstanding.insert (std::make_pair(PeekPointer(app), interest->getName ().toUri ())).second)
+    requested++;
+  else
+    retransmissions++;
+}
+
+void ReceivedData(shared_ptr<const ndn::Data> data, Ptr<ndn::App> app, shared_ptr<ndn::Face> face)
+{
+  outstanding.erase (std::make_pair(PeekPointer(app), data->getName ().toUri ()));
+}
+
+void FirstInterestDataDelay(Ptr<ndn::App> app, uint32_t seqno, Time delay, uint32_t retxCount, int32_t hopCount)
+{
+  delivered++; // fired once per satisfied interest, retransmissions included
+  delays.push_back (delay.GetSeconds ());
+}
+
+void OutInterest(const ndn::Interest& interest, const ndn::Face& face)
+{
+  l3Events++;
+  if(dynamic_cast<const ndn::NetDeviceFace*>(&face) != NULL)
+    linkInterests++;
+}
+
+void PacketEvent(const ndn::Interest& interest, const ndn::Face& face)
+{
+  l3Events++;
+}
+
+void DataEvent(const ndn::Data& data, const ndn::Face& face)
+{
+  l3Events++;
+}
+
+double percentile(std::vector<double>& values, double p)
+{
+  if(values.empty ())
+    return 0.0;
+
+  size_t index = std::min(values.size () - 1, (size_t) (p * values.size ()));
+  std::nth_element(values.begin (), values.begin () + index, values.end ());
+  return values[index];
+}
+
+int main(int argc, char* argv[])
+{
+  std::string strategy = "saf";
+  std::string topology = "topologies/example.top";
+  std::string workload = "cbr";
+  std::string frequency = "250";
+  std::string lifetime = "2s";
+  uint32_t contents = 10000;
+  double zipf = 0.8;
+  int cacheSize = 1;
+  double duration = 600.0;
+  uint32_t run = 1;
+  std::string output = "";
+  std::string routing = "all";
+  uint32_t nextHops = 0;
+  int nackAggregation = 0;
+
+  CommandLine cmd;
+  cmd.AddValue ("strategy", "saf, rfa, ompif, inrr, inrr-summary or bestroute", strategy);
+  cmd.AddValue ("topology", "annotated topology file", topology);
+  cmd.AddValue ("workload", "cbr (sequential names) or zipf (popularity over a catalog)", workload);
+  cmd.AddValue ("frequency", "interests per second per consumer", frequency);
+  cmd.AddValue ("lifetime", "interest lifetime", lifetime);
+  cmd.AddValue ("contents", "catalog size of the zipf workload", contents);
+  cmd.AddValue ("zipf", "exponent of the zipf workload", zipf);
+  cmd.AddValue ("cacheSize", "content store size of consumers and routers, 1 disables caching", cacheSize);
+  cmd.AddValue ("duration", "simulated seconds", duration);
+  cmd.AddValue ("run", "run number of the random streams", run);
+  cmd.AddValue ("output", "csv file the result line is appended to", output);
+  cmd.AddValue ("routing", "all (every usable face), loopfree or ndnsim (GlobalRoutingHelper::CalculateAllPossibleRoutes)", routing);
+  cmd.AddValue ("nextHops", "maximum next hops per node and prefix, 0 keeps all", nextHops);
+  cmd.AddValue ("nackAggregation", "ms nacks per downstream and content prefix are aggregated on the routers, 0 disables aggregation", nackAggregation);
+  cmd.Parse (argc, argv);
+
+  RngSeedManager::SetRun (run);
+
+  //parse the topology
+  AnnotatedTopologyReader topologyReader ("", 5);
+  topologyReader.SetFileName (topology);
+  NodeContainer nodes = topologyReader.Read();
+
+  //grep the nodes by role
+  NodeContainer consumers, providers, routers;
+  for(NodeContainer::Iterator it = nodes.Begin (); it != nodes.End (); ++it)
+  {
+    std::string name = Names::FindName (*it);
+    if(name.find ("ContentDst") == 0)
+      consumers.Add (*it);
+    else if(name.find ("ContentSrc") == 0)
+      providers.Add (*it);
+    else
+      routers.Add (*it);
+  }
+
+  if(consumers.size () == 0 || providers.size () == 0)
+  {
+    fprintf(stderr, "The topology needs ContentDst* and ContentSrc* nodes\n");
+    return 1;
+  }
+
+  // Install NDN stack on all nodes
+  ns3::ndn::StackHelper ndnHelper;
+  ndnHelper.setCsSize(1); // providers do not cache
+  ndnHelper.Install (providers);
+
+  ndnHelper.setCsSize(cacheSize);
+  ndnHelper.Install (consumers);
+  ndnHelper.Install (routers);
+
+  //set prefix components for forwarding
+  ParameterConfiguration::getInstance()->setParameter("PREFIX_COMPONENT", 0);
+
+  //aggregation applies to the forwarders, i.e., to every strategy
+  nfd::fw::NackAggregationHelper::Install (routers, nackAggregation, 1);
+
+  //install the strategy
+  if(strategy == "saf")
+    ns3::ndn::StrategyChoiceHelper::Install<nfd::fw::SAF>(routers,"/");
+  else if(strategy == "rfa")
+    ns3::ndn::StrategyChoiceHelper::Install<nfd::fw::OMCCRF>(routers,"/");
+  else if(strategy == "ompif")
+  {
+    ns3::ndn::StrategyChoiceHelper::Install<nfd::fw::OMPIFRouter>(routers,"/");
+    ns3::ndn::StrategyChoiceHelper::Install<nfd::fw::OMPIFClient>(consumers,"/");
+  }
+  else if(strategy == "inrr" || strategy == "inrr-summary")
+  {
+    NodeContainer inrr_nodes(consumers, routers);
+    if(strategy == "inrr")
+      nfd::fw::OracleHelper::Install<nfd::fw::Oracle>(inrr_nodes, "/");
+    else
+      nfd::fw::OracleHelper::Install<nfd::fw::SummaryOracle>(inrr_nodes, "/");
+  }
+  else if(strategy != "bestroute")
+  {
+    fprintf(stderr, "Unknown strategy %s\n", strategy.c_str ());
+    return 1;
+  }
+
+  //install consumer applications
+  ns3::ndn::AppHelper consumerHelper (workload == "zipf" ? "ns3::ndn::ConsumerZipfMandelbrot" : "ns3::ndn::ConsumerCbr");
+  consumerHelper.SetAttribute ("Frequency", StringValue (frequency));
+  consumerHelper.SetAttribute ("Randomize", StringValue ("uniform"));
+  consumerHelper.SetAttribute ("LifeTime", StringValue (lifetime));
+  if(workload == "zipf")
+  {
+    consumerHelper.SetAttribute ("NumberOfContents", StringValue (boost::lexical_cast<std::string>(contents)));
+    consumerHelper.SetAttribute ("s", StringValue (boost::lexical_cast<std::string>(zipf)));
+  }
+
+  for(uint32_t i = 0; i < consumers.size (); i++)
+  {
+    consumerHelper.SetPrefix ("/provider" + boost::lexical_cast<std::string>(i % providers.size ()));
+    consumerHelper.Install (consumers.Get (i));
+  }
+
+  //install producer applications
+  ns3::ndn::AppHelper producerHelper ("ns3::ndn::Producer");
+  producerHelper.SetAttribute ("PayloadSize", StringValue("1024"));
+
+  // Installing "extended" global routing interface on all nodes
+  ns3::ndn::ExtendedGlobalRoutingHelper ndnGlobalRoutingHelper;
+  ndnGlobalRoutingHelper.InstallAll ();
+
+  for(uint32_t i = 0; i < providers.size (); i++)
+  {
+    std::string prefix = "/provider" + boost::lexical_cast<std::string>(i);
+    producerHelper.SetPrefix (prefix);
+    producerHelper.Install (providers.Get (i));
+    ndnGlobalRoutingHelper.AddOrigins (prefix, providers.Get (i));
+  }
+
+  // Calculate and install FIBs
+  if(routing == "ndnsim")
+    ns3::ndn::GlobalRoutingHelper::CalculateAllPossibleRoutes ();
+  else if(routing == "loopfree")
+    ns3::ndn::ExtendedGlobalRoutingHelper::CalculateAllRoutes (ns3::ndn::ExtendedGlobalRoutingHelper::LoopFreeNextHops, nextHops);
+  else
+    ns3::ndn::ExtendedGlobalRoutingHelper::CalculateAllRoutes (ns3::ndn::ExtendedGlobalRoutingHelper::AllNextHops, nextHops);
+
+  //trace the consumers and forwarders
+  Config::ConnectWithoutContext ("/NodeList/*/ApplicationList/*/$ns3::ndn::Consumer/TransmittedInterests", MakeCallback (&TransmittedInterest));
+  Config::ConnectWithoutContext ("/NodeList/*/ApplicationList/*/$ns3::ndn::Consumer/ReceivedDatas", MakeCallback (&ReceivedData));
+  Config::ConnectWithoutContext ("/NodeList/*/ApplicationList/*/$ns3::ndn::Consumer/FirstInterestDataDelay", MakeCallback (&FirstInterestDataDelay));
+  Config::ConnectWithoutContext ("/NodeList/*/$ns3::ndn::L3Protocol/OutInterests", MakeCallback (&OutInterest));
+  Config::ConnectWithoutContext ("/NodeList/*/$ns3::ndn::L3Protocol/InInterests", MakeCallback (&PacketEvent));
+  Config::ConnectWithoutContext ("/NodeList/*/$ns3::ndn::L3Protocol/OutData", MakeCallback (&DataEvent));
+  Config::ConnectWithoutContext ("/NodeList/*/$ns3::ndn::L3Protocol/InData", MakeCallback (&DataEvent));
+
+  boost::chrono::steady_clock::time_point start = boost::chrono::steady_clock::now ();
+
+  Simulator::Stop (Seconds(duration));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  double wallTime = boost::chrono::duration<double>(boost::chrono::steady_clock::now () - start).count ();
+
+  //report
+  double satisfaction = requested > 0 ? (double) delivered / (double) requested : 0.0;
+  double overhead = delivered > 0 ? (double) linkInterests / (double) delivered : 0.0;
+  double p50 = percentile(delays, 0.5);
+  double p90 = percentile(delays, 0.9);
+  double p99 = percentile(delays, 0.99);
+  double l3EventRate = wallTime > 0 ? l3Events / wallTime : 0.0;
+
+  fprintf(stdout, "strategy=%s topology=%s workload=%s cache=%d duration=%.0fs run=%u\n", strategy.c_str (), topology.c_str (),
+          workload.c_str (), cacheSize, duration, run);
+  fprintf(stdout, "  requested=%llu delivered=%llu retransmissions=%llu satisfaction_ratio=%.4f\n", (unsigned long long) requested,
+          (unsigned long long) delivered, (unsigned long long) retransmissions, satisfaction);
+  fprintf(stdout, "  delay_ms p50=%.2f p90=%.2f p99=%.2f\n", p50 * 1000, p90 * 1000, p99 * 1000);
+  fprintf(stdout, "  link_interests=%llu interests_per_data=%.3f\n", (unsigned long long) linkInterests, overhead);
+  fprintf(stdout, "  wall_time=%.2fs l3_events=%llu l3_events_per_wall_s=%.0f\n", wallTime, (unsigned long long) l3Events, l3EventRate);
+
+  if(strategy == "inrr-summary")
+    nfd::fw::StaticOracaleContainer::getInstance()->printSummaryStatistics(stdout);
+
+  if(!output.empty ())
+  {
+    FILE* csv = fopen(output.c_str (), "a");
+    if(csv == NULL)
+    {
+      fprintf(stderr, "Could not open %s\n", output.c_str ());
+      return 1;
+    }
+
+    //header for a new file
+    fseek(csv, 0, SEEK_END);
+    if(ftell(csv) == 0)
+      fprintf(csv, "strategy,topology,workload,cache,duration,run,requested,delivered,satisfaction_ratio,"
+                   "delay_p50_ms,delay_p90_ms,delay_p99_ms,interests_per_data,wall_time_s,l3_events_per_wall_s\n");
+
+    fprintf(csv, "%s,%s,%s,%d,%.0f,%u,%llu,%llu,%.4f,%.2f,%.2f,%.2f,%.3f,%.2f,%.0f\n", strategy.c_str (), topology.c_str (),
+            workload.c_str (), cacheSize, duration, run, (unsigned long long) requested, (unsigned long long) delivered,
+            satisfaction, p50 * 1000, p90 * 1000, p99 * 1000, overhead, wallTime, l3EventRate);
+    fclose(csv);
+  }
+
+  NS_LOG_UNCOND("Simulation completed!");
+  return 0;
+}
@@ -0,0 +1,178 @@
+/**
+ * Copyright (c) 2015 Daniel Posch (Alpen-Adria Universität Klagenfurt)
+ *
+ * This file is part of the ndnSIM extension for Stochastic Adaptive Forwarding (SAF).
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/ndn-all.hpp"
+
+#include "../extensions/fw/saf.h"
+#include "../extensions/fw/saflayerclassifier.h"
+#include "../extensions/fw/safsnapshot.h"
+#include "../extensions/utils/parameterconfiguration.h"
+#include "../extensions/utils/checkpoint.h"
+
+#include <set>
+
+using namespace ns3;
+
+#define LAYERS 3
+
+//names requested and received per layer, retransmissions are counted once
+std::set<std::string> requested[LAYERS];
+std::set<std::string> delivered[LAYERS];
+
+void TransmittedInterest(shared_ptr<const ndn::Interest> interest, Ptr<ndn::App> app, shared_ptr<ndn::Face> face)
+{
+  int layer = nfd::fw::SAFLayerClassifier::getInstance ()->classify (interest->getName ());
+  requested[layer].insert (interest->getName ().toUri ());
+}
+
+void ReceivedData(shared_ptr<const ndn::Data> data, Ptr<ndn::App> app, shared_ptr<ndn::Face> face)
+{
+  int layer = nfd::fw::SAFLayerClassifier::getInstance ()->classify (data->getName ());
+  delivered[layer].insert (data->getName ().toUri ());
+}
+
+int main(int argc, char* argv[])
+{
+  int adaptation = 1;
+  std::string frequency = "150";
+  std::string snapshots = "";
+  std::string checkpoint = "";
+  double checkpointTime = 100.0;
+  std::string restore = "";
+  double duration = 600.0;
+
+  CommandLine cmd;
+  cmd.AddValue ("adaptation", "enable (1) or disable (0) cross layer adaptation", adaptation);
+  cmd.AddValue ("frequency", "interests per second per layer and streamer", frequency);
+  cmd.AddValue ("snapshots", "directory the routers warm-start from and write their learned state to", snapshots);
+  cmd.AddValue ("checkpoint", "file the strategy state is written to at checkpointTime", checkpoint);
+  cmd.AddValue ("checkpointTime", "simulation time in seconds of the checkpoint", checkpointTime);
+  cmd.AddValue ("restore", "checkpoint the routers start from instead of warming up", restore);
+  cmd.AddValue ("duration", "simulated seconds", duration);
+  cmd.Parse (argc, argv);
+
+  //parse the topology
+  AnnotatedTopologyReader topologyReader ("", 5);
+  topologyReader.SetFileName ("topologies/example.top");
+  topologyReader.Read();
+
+  //grep the nodes
+  Ptr<Node> streamer0 = Names::Find<Node>("ContentDst0");
+  Ptr<Node> streamer1 = Names::Find<Node>("ContentDst1");
+
+  Ptr<Node> provider0 = Names::Find<Node>("ContentSrc0");
+  Ptr<Node> provider1 = Names::Find<Node>("ContentSrc1");
+
+  NodeContainer routers;
+  routers.Add(Names::Find<Node>("Router0"));
+  routers.Add(Names::Find<Node>("Router1"));
+  routers.Add(Names::Find<Node>("Router2"));
+  routers.Add(Names::Find<Node>("Router3"));
+  routers.Add(Names::Find<Node>("Router4"));
+  routers.Add(Names::Find<Node>("Router5"));
+
+  // Install NDN stack on all nodes
+  ns3::ndn::StackHelper ndnHelper;
+  ndnHelper.setCsSize(1); // disable caches
+
+  ndnHelper.Install (streamer0);
+  ndnHelper.Install (streamer1);
+
+  ndnHelper.Install (provider0);
+  ndnHelper.Install (provider1);
+
+  ndnHelper.Install (routers);
+
+  //set prefix components for forwarding, all layers of a video share one entry
+  ParameterConfiguration::getInstance()->setParameter("PREFIX_COMPONENT", 0);
+  ParameterConfiguration::getInstance()->setParameter("MAX_LAYERS", LAYERS);
+  ParameterConfiguration::getInstance()->setParameter("CONTENT_AWARE_ADAPTATION", adaptation > 0 ? 1 : -1);
+
+  //a later run with the same directory starts with the tables of the last snapshot
+  if(!snapshots.empty ())
+  {
+    nfd::fw::SAFSnapshot::setDirectory (snapshots);
+    ParameterConfiguration::getInstance()->setParameter("SNAPSHOT_INTERVAL", 10);
+  }
+
+  //names look like /video/streamX/layerY/seq
+  std::string prefix = "/video";
+  nfd::fw::SAFLayerClassifier::getInstance ()->registerComponentRule (prefix, 2, "layer");
+
+  //install SAF on routers
+  ns3::ndn::StrategyChoiceHelper::Install<nfd::fw::SAF>(routers,"/");
+
+  //branch from the state of an earlier run, e.g. to sweep parameters after the warm-up
+  if(!restore.empty ())
+    CheckpointRegistry::getInstance ()->load (restore);
+  if(!checkpoint.empty ())
+    CheckpointRegistry::getInstance ()->scheduleCheckpoint (checkpointTime, checkpoint);
+
+  //install one consumer per layer on the streamers
+  ns3::ndn::AppHelper consumerHelper ("ns3::ndn::ConsumerCbr");
+  consumerHelper.SetAttribute ("Frequency", StringValue (frequency));
+  consumerHelper.SetAttribute ("Randomize", StringValue ("uniform"));
+
+  for(int layer = 0; layer < LAYERS; layer++)
+  {
+    consumerHelper.SetPrefix (prefix + "/stream0/layer" + boost::lexical_cast<std::string>(layer));
+    consumerHelper.Install (streamer0);
+
+    consumerHelper.SetPrefix (prefix + "/stream1/layer" + boost::lexical_cast<std::string>(layer));
+    consumerHelper.Install (streamer1);
+  }
+
+  //install producer application on the providers
+  ns3::ndn::AppHelper producerHelper ("ns3::ndn::Producer");
+  producerHelper.SetAttribute ("PayloadSize", StringValue("1024"));
+  producerHelper.SetPrefix (prefix);
+  producerHelper.Install (provider0);
+  producerHelper.Install (provider1);
+
+   // Installing global routing interface on all nodes
+  ns3::ndn::GlobalRoutingHelper ndnGlobalRoutingHelper;
+  ndnGlobalRoutingHelper.InstallAll ();
+
+  //add routing prefixes to the providers
+  ndnGlobalRoutingHelper.AddOrigins(prefix, provider0);
+  ndnGlobalRoutingHelper.AddOrigins(prefix, provider1);
+
+  // Calculate and install FIBs
+  ns3::ndn::GlobalRoutingHelper::CalculateAllPossibleRoutes ();
+
+  //trace the consumers
+  Config::ConnectWithoutContext ("/NodeList/*/ApplicationList/*/$ns3::ndn::Consumer/TransmittedInterests", MakeCallback (&TransmittedInterest));
+  Config::ConnectWithoutContext ("/NodeList/*/ApplicationList/*/$ns3::ndn::Consumer/ReceivedDatas", MakeCallback (&ReceivedData));
+
+  //clean up the simulation
+  Simulator::Stop (Seconds(duration)); //runs for 10 min. by default
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  //report the delivery ratio per layer, the base layer should be protected under overload
+  for(int layer = 0; layer < LAYERS; layer++)
+  {
+    double ratio = requested[layer].size () > 0 ? (double) delivered[layer].size () / (double) requested[layer].size () : 0.0;
+    NS_LOG_UNCOND("Layer " << layer << ": requested=" << requested[layer].size () << " delivered=" << delivered[layer].size ()
+                  << " delivery_ratio=" << ratio);
+  }
+
+  NS_LOG_UNCOND("Simulation completed!");
+  return 0;
+}
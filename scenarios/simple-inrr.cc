@@ -22,15 +22,28 @@
 #include "../extensions/fw/saf.h"
 #include "../extensions/utils/extendedglobalroutinghelper.h"
 #include "../extensions/fw/competitors/inrr/oracle.h"
+#include "../extensions/fw/competitors/inrr/summaryoracle.h"
+#include "../extensions/fw/competitors/inrr/oraclehelper.h"
 
 using namespace ns3;
 
 int main(int argc, char* argv[])
 {
 
+  //use cache summaries instead of the exact oracle, e.g. --summaries=1 --summarySize=4096 --summaryRefresh=5
+  bool summaries = false;
+  double summarySize = P_CACHE_SUMMARY_SIZE;
+  double summaryRefresh = P_CACHE_SUMMARY_REFRESH;
+
   CommandLine cmd;
+  cmd.AddValue ("summaries", "route on exchanged Bloom filter summaries of the caches", summaries);
+  cmd.AddValue ("summarySize", "counters per cache summary", summarySize);
+  cmd.AddValue ("summaryRefresh", "seconds between two exchanges of the summaries", summaryRefresh);
   cmd.Parse (argc, argv);
 
+  ParameterConfiguration::getInstance ()->setParameter ("CACHE_SUMMARY_SIZE", summarySize);
+  ParameterConfiguration::getInstance ()->setParameter ("CACHE_SUMMARY_REFRESH", summaryRefresh);
+
   //parse the topology
   AnnotatedTopologyReader topologyReader ("", 5);
   topologyReader.SetFileName ("topologies/inrr.top");
@@ -69,17 +82,10 @@ int main(int argc, char* argv[])
   ndnHelper.Install (inrr_nodes);
 
   //install iNRR on routers and clients
-  for(unsigned int i = 0; i < inrr_nodes.size(); i++)
-	{
-		//we use NS3 names to globally make the nodes available as well as their forwards.
-		//its a hack, but its the only way ns3/ndnSIM allows to implement an oracle.
-		std::string oldname = Names::FindName (inrr_nodes.Get (i));
-    std::string newname = "StrategyNode" + boost::lexical_cast<std::string>(i);
-		Names::Rename (oldname, newname);
-		nfd::fw::StaticOracaleContainer::getInstance()->insertNode(newname, inrr_nodes.Get (i));
-    ns3::ndn::StrategyChoiceHelper::Install<nfd::fw::Oracle>(inrr_nodes.Get (i),"/");
-		Names::Rename (newname, oldname);
-	}
+  if(summaries)
+    nfd::fw::OracleHelper::Install<nfd::fw::SummaryOracle>(inrr_nodes, "/");
+  else
+    nfd::fw::OracleHelper::Install<nfd::fw::Oracle>(inrr_nodes, "/");
 
   // Install NDN applications
   std::string prefix0 = "/provider0";
@@ -126,9 +132,6 @@ int main(int argc, char* argv[])
   ndnGlobalRoutingHelper.AddOrigins(prefix0, provider0);
   ndnGlobalRoutingHelper.AddOrigins(prefix1, provider1);
 
-	//install default routes to all nodes. This is needed for iNRRR Strategy!
-	ndnGlobalRoutingHelper.AddOriginsForAllUsingNodeIds ();
-
   // Calculate and install FIBs
   ns3::ndn::GlobalRoutingHelper::CalculateAllPossibleRoutes ();
 
@@ -137,6 +140,9 @@ int main(int argc, char* argv[])
   Simulator::Run ();
   Simulator::Destroy ();
 
+  if(summaries)
+    nfd::fw::StaticOracaleContainer::getInstance()->printSummaryStatistics(stdout);
+
   NS_LOG_UNCOND("Simulation completed!");
   return 0;
 }
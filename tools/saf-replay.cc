@@ -0,0 +1,162 @@
+/**
+ * Copyright (c) 2015 Daniel Posch (Alpen-Adria Universität Klagenfurt)
+ *
+ * This file is part of the ndnSIM extension for Stochastic Adaptive Forwarding (SAF).
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// Replays a trace into the SAF engine of a single node without packet level simulation, e.g.
+//   ./build/tools/saf-replay --catalog=10000 --alpha=0.8 --rate=5000 --duration=120 --failure=0:30:60
+//   ./build/tools/saf-replay --generate=zipf.saft --catalog=10000
+//   ./build/tools/saf-replay --trace=zipf.saft --param=UPDATE_INTERVALL=0.5
+
+#include "../extensions/replay/safreplay.h"
+#include "../extensions/replay/saftracegenerator.h"
+#include "../extensions/utils/parameterconfiguration.h"
+
+#include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+using namespace nfd::fw;
+
+void usage()
+{
+  fprintf(stderr, "usage: saf-replay [--trace=FILE | --generate=FILE] [options]\n"
+                  "  --trace=FILE            replay a recorded or generated trace\n"
+                  "  --generate=FILE         only write the generated trace\n"
+                  "  --catalog=N             prefixes of the zipf catalog (1000)\n"
+                  "  --alpha=A               zipf exponent (0.8)\n"
+                  "  --rate=R                interests per second (1000)\n"
+                  "  --duration=D            seconds (60)\n"
+                  "  --downstreams=N         downstream faces (2)\n"
+                  "  --upstreams=N           upstream faces, later ones are less reliable and slower (3)\n"
+                  "  --failure=FACE:START:END  takes upstream face FACE (0..upstreams-1) down\n"
+                  "  --seed=S                seed of trace and engine (1)\n"
+                  "  --param=NAME=VALUE      sets a SAF parameter, PREFIX_COMPONENT defaults to 1\n");
+}
+
+bool option(const char* arg, const char* name, std::string& value)
+{
+  size_t n = strlen(name);
+  if(strncmp(arg, name, n) != 0 || arg[n] != '=')
+    return false;
+  value = arg + n + 1;
+  return true;
+}
+
+int main(int argc, char* argv[])
+{
+  std::string traceFile = "";
+  std::string generateFile = "";
+  int downstreams = 2;
+  int upstreams = 3;
+  std::vector<std::string> failures;
+
+  SAFTraceGenerator generator;
+
+  //every catalog item is its own content prefix
+  ParameterConfiguration::getInstance ()->setParameter ("PREFIX_COMPONENT", 1);
+
+  try
+  {
+    for(int i = 1; i < argc; i++)
+    {
+      std::string value;
+      if(option(argv[i], "--trace", value))
+        traceFile = value;
+      else if(option(argv[i], "--generate", value))
+        generateFile = value;
+      else if(option(argv[i], "--catalog", value))
+        generator.catalogSize = boost::lexical_cast<uint32_t>(value);
+      else if(option(argv[i], "--alpha", value))
+        generator.zipfAlpha = boost::lexical_cast<double>(value);
+      else if(option(argv[i], "--rate", value))
+        generator.interestRate = boost::lexical_cast<double>(value);
+      else if(option(argv[i], "--duration", value))
+        generator.duration = boost::lexical_cast<double>(value);
+      else if(option(argv[i], "--downstreams", value))
+        downstreams = boost::lexical_cast<int>(value);
+      else if(option(argv[i], "--upstreams", value))
+        upstreams = boost::lexical_cast<int>(value);
+      else if(option(argv[i], "--failure", value))
+        failures.push_back (value);
+      else if(option(argv[i], "--seed", value))
+        generator.seed = boost::lexical_cast<uint32_t>(value);
+      else if(option(argv[i], "--param", value) && value.find ('=') != std::string::npos)
+        ParameterConfiguration::getInstance ()->setParameter (value.substr (0, value.find ('=')),
+                                                              boost::lexical_cast<double>(value.substr (value.find ('=') + 1)));
+      else
+      {
+        usage();
+        return 1;
+      }
+    }
+  }
+  catch(boost::bad_lexical_cast&)
+  {
+    usage();
+    return 1;
+  }
+
+  SAFReplayTrace trace;
+  if(!traceFile.empty ())
+  {
+    if(!trace.read (traceFile))
+      return 1;
+  }
+  else
+  {
+    for(int i = 0; i < downstreams; i++)
+      generator.addDownstreamFace ("Client" + boost::lexical_cast<std::string>(i), 10000000);
+
+    std::vector<uint16_t> upstreamFaces;
+    for(int i = 0; i < upstreams; i++)
+      upstreamFaces.push_back (generator.addUpstreamFace ("Upstream" + boost::lexical_cast<std::string>(i), 10000000,
+                                                          std::max(0.1, 0.95 - 0.15 * i), 0.02 * (i + 1)));
+
+    for(std::vector<std::string>::iterator it = failures.begin (); it != failures.end (); ++it)
+    {
+      int face = 0;
+      double start = 0, end = 0;
+      if(sscanf(it->c_str (), "%d:%lf:%lf", &face, &start, &end) != 3 || face < 0 || face >= upstreams)
+      {
+        usage();
+        return 1;
+      }
+      generator.addFailure (upstreamFaces[face], start, end);
+    }
+
+    generator.generate (trace);
+
+    if(!generateFile.empty ())
+    {
+      if(!trace.write (generateFile))
+        return 1;
+      fprintf(stderr, "Wrote %lu events to %s\n", (unsigned long) trace.events.size (), generateFile.c_str ());
+      return 0;
+    }
+  }
+
+  StandalonePlatform platform(generator.seed);
+  platform.setNodeName ("replay");
+  SAFPlatform::setInstance (&platform);
+
+  SAFReplay replay(trace, platform);
+  replay.run ();
+  replay.printStatistics (stdout);
+
+  return 0;
+}
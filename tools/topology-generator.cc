@@ -0,0 +1,122 @@
+/**
+ * Copyright (c) 2015 Daniel Posch (Alpen-Adria Universität Klagenfurt)
+ *
+ * This file is part of the ndnSIM extension for Stochastic Adaptive Forwarding (SAF).
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// Generates synthetic topologies for the scenarios, e.g.
+//   ./build/tools/topology-generator --type=rocketfuel --routers=1000 --consumers=50 --providers=5 --output=topologies/isp-1000.top
+//   ./build/tools/topology-generator --type=fattree --routers=80 --bandwidth=100:100 --delay=0.1:0.1
+//   ./build/tools/topology-generator --type=geometric --routers=2000 --delay=1:20 --queue=20:100
+
+#include "../extensions/utils/topologygenerator.h"
+
+#include <boost/lexical_cast.hpp>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+void usage()
+{
+  fprintf(stderr, "usage: topology-generator [options]\n"
+                  "  --type=TYPE             rocketfuel, fattree or geometric (rocketfuel)\n"
+                  "  --routers=N             number of routers, fattree rounds up to a full tree (100)\n"
+                  "  --consumers=N           ContentDst nodes (10)\n"
+                  "  --providers=N           ContentSrc nodes (2)\n"
+                  "  --bandwidth=MIN:MAX     Mbps of router links (3:10)\n"
+                  "  --delay=MIN:MAX         ms of router links, geometric scales with the distance (1:10)\n"
+                  "  --queue=MIN:MAX         packets (50:50)\n"
+                  "  --access=MIN:MAX        Mbps of consumer and provider links (10:10)\n"
+                  "  --multihoming=P         share of rocketfuel access routers with two uplinks (0.3)\n"
+                  "  --radius=R              link radius of geometric in the unit square, 0 for degree ~6 (0)\n"
+                  "  --seed=S                (1)\n"
+                  "  --output=FILE           instead of stdout\n");
+}
+
+bool option(const char* arg, const char* name, std::string& value)
+{
+  size_t n = strlen(name);
+  if(strncmp(arg, name, n) != 0 || arg[n] != '=')
+    return false;
+  value = arg + n + 1;
+  return true;
+}
+
+bool range(const std::string& value, TopologyGenerator::Range& r)
+{
+  return sscanf(value.c_str (), "%lf:%lf", &r.min, &r.max) == 2 && r.min <= r.max && r.min >= 0;
+}
+
+int main(int argc, char* argv[])
+{
+  TopologyGenerator generator;
+  std::string output = "";
+
+  try
+  {
+    for(int i = 1; i < argc; i++)
+    {
+      std::string value;
+      bool valid = true;
+      if(option(argv[i], "--type", value))
+        valid = TopologyGenerator::parseType (value, generator.type);
+      else if(option(argv[i], "--routers", value))
+        generator.routers = boost::lexical_cast<uint32_t>(value);
+      else if(option(argv[i], "--consumers", value))
+        generator.consumers = boost::lexical_cast<uint32_t>(value);
+      else if(option(argv[i], "--providers", value))
+        generator.providers = boost::lexical_cast<uint32_t>(value);
+      else if(option(argv[i], "--bandwidth", value))
+        valid = range(value, generator.bandwidth);
+      else if(option(argv[i], "--delay", value))
+        valid = range(value, generator.delay);
+      else if(option(argv[i], "--queue", value))
+        valid = range(value, generator.queue);
+      else if(option(argv[i], "--access", value))
+        valid = range(value, generator.accessBandwidth);
+      else if(option(argv[i], "--multihoming", value))
+        generator.multihoming = boost::lexical_cast<double>(value);
+      else if(option(argv[i], "--radius", value))
+        generator.radius = boost::lexical_cast<double>(value);
+      else if(option(argv[i], "--seed", value))
+        generator.seed = boost::lexical_cast<uint32_t>(value);
+      else if(option(argv[i], "--output", value))
+        output = value;
+      else
+        valid = false;
+
+      if(!valid)
+      {
+        usage();
+        return 1;
+      }
+    }
+  }
+  catch(boost::bad_lexical_cast&)
+  {
+    usage();
+    return 1;
+  }
+
+  if(!generator.generate ())
+    return 1;
+
+  if(output.empty ())
+    generator.write (stdout);
+  else if(!generator.write (output))
+    return 1;
+
+  fprintf(stderr, "Generated %lu nodes and %lu links\n", (unsigned long) generator.nodes.size (), (unsigned long) generator.links.size ());
+  return 0;
+}